@@ -15,12 +15,23 @@
 #include "Symbol.h"
 #include "Token.h"
 #include "Graph.h"
-
+#include "Operand.h"
+#include "CFG.h"
+#include "Liveness.h"
+#include "Bitset.h"
+#include "LinearScan.h"
+#include "Instruction.h"
+#include "Peephole.h"
+#include "Writer.h"
 
 #include <unordered_map>
 #include <map>
+#include <list>
 #include <sstream>
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <climits>
 
 // Forward declare Tac
 class Tac;
@@ -30,94 +41,273 @@ class ASM
 private:
     static Tac *ILOC_code; // Intermediate code to generate ASM file for
 
-    static std::map<std::string *, Symbol *> functions; // ILOC Label to Funcion symbol map
-    static Symbol *current_function;                    // Current function begin converted to ASM
-    static int function_index;                          // Total written functions
+    static std::vector<Symbol *> functions; // Function symbol for each ILOC label number (NULL if not a function)
+    static Symbol *current_function;        // Current function begin converted to ASM
+    static int function_index;              // Total written functions
+
+    static std::vector<std::string> registers; // Machine register given to each temporary, by register id
+
+    static bool output_stats; // Whether register allocation statistics are written to stderr
+    static bool linear_scan;  // Whether registers are allocated by linear scan instead of graph coloring
+
+    static int spill_start; // First register created to hold a spilled value in the current function
+    static int spill_slots; // Stack slots given to spilled registers in the current function
+    static int locals_size; // Bytes taken by the current function's local variables (Slots go after them)
+    static int frame_size;  // Bytes the current function reserves in the stack, 0 if it does not
+
+    static bool force_frame_pointer; // Whether every function sets up %rbp, even those that would not need it
+    static int cmov_threshold;       // Most instructions both sides of a conditional may take to be selected with a cmov
+    static bool frame_omitted;       // Whether the current function keeps its variables below %rsp, without a frame
 
-    static std::map<std::string *, std::string> registers; // Temporary to register allocation map
+    static std::unordered_map<std::string, int> save_slots;                 // Stack slot each machine register is saved to, if it needs one
+    static std::vector<std::string> callee_saved;                           // Callee-saved registers the current function writes
+    static std::unordered_map<Tac *, std::vector<std::string>> caller_saved; // Caller-saved registers live across each call, by the call's jump
+    static std::vector<Operand *> call_arguments;                           // What each argument of the call being translated is passed from
+    static int outgoing_size;                                               // Bytes at the bottom of the frame for arguments passed in the stack
+
+    static std::list<Instruction> function_code; // Machine code of the current function, written when it ends
+    static bool output_peephole_stats;           // Whether the peephole optimizer's rewrites are written to stderr
+    static bool output_tac_comments;             // Whether each instruction is preceded by the TAC it came from
 
 public:
+    /**
+     * @brief Sets whether the size of each function's interference graph, the time
+     * spent building and coloring it, the registers used and the movs eliminated
+     * are written to stderr
+     */
+    static void setOutputStats(bool output_stats_);
+
+    /**
+     * @brief Sets whether registers are allocated by linear scan (Faster for very
+     * large functions) instead of graph coloring
+     */
+    static void setLinearScan(bool linear_scan_);
+
+    /**
+     * @brief Sets whether the times each peephole rule was applied in each function
+     * are written to stderr
+     */
+    static void setOutputPeepholeStats(bool output_peephole_stats_);
+
+    /**
+     * @brief Sets whether the TAC each group of instructions was translated from is
+     * written before it, as a comment
+     */
+    static void setOutputTacComments(bool output_tac_comments_);
+
+    /**
+     * @brief Sets whether every function sets up a frame pointer, so that profilers
+     * and debuggers can walk the stack, instead of leaf functions going without one
+     */
+    static void setForceFramePointer(bool force_frame_pointer_);
+
+    /**
+     * @brief Sets how many instructions both sides of a conditional may take in all
+     * for both to run and the result to be selected by a cmov instead of a branch
+     * @param cmov_threshold_ Most instructions in both sides (0 never selects)
+     */
+    static void setCmovThreshold(int cmov_threshold_);
+
     // BROAD FUNCTIONS FOR GENERATING SEGMENTS
 
     /**
      * @brief Generates the ASM code for the program
      * @param first First instruction of the ILOC code
-     * @returns String containing the x86_64-compliant ASM 'file'
+     * @param out   Where to write the x86_64-compliant ASM 'file'
      */
-    static std::string generateASM(Tac *first);
+    static void generateASM(Tac *first, Writer &out);
 
     /**
      * @brief Generates the data segment of the ASM program
-     * @returns String containing the data segment
+     * @param out Where to write it
      */
-    static std::string generateDataSegment();
+    static void generateDataSegment(Writer &out);
 
     /**
      * @brief Generates the code segment of the ASM program
-     * @returns String conatining the code segment 
+     * @param out Where to write it
      */
-    static std::string generateCodeSegment();
+    static void generateCodeSegment(Writer &out);
 
     /**
      * @brief Generates the ending segment of the ASM program 
-     * @returns String containing the end segment
+     * @param out Where to write it
      */
-    static std::string generateEndSegment();
+    static void generateEndSegment(Writer &out);
 
     // SPECIFIC FUNCTIONS
 
     /**
      * @brief Generates code for starting a function
      * @param current First TAC of this function
-     * @returns String containing the start code block
+     * @param out     Where to write the start code block
      */
-    static std::string generateFunctionStart(Tac *current);
+    static void generateFunctionStart(Tac *current, Writer &out);
 
     /**
-     * @brief Generates code for ending a function
+     * @brief Generates code for ending a function, after the function's machine code
+     * (Cleaned up by the peephole optimizer), and frees the function's TAC code
      * @param current First TAC of the next function
-     * @returns String containing the end code block 
+     * @param out     Where to write the end code block
+     */
+    static void generateFunctionEnd(Tac *current, Writer &out);
+
+    /**
+     * @brief Leaves the result of each compare that only the branch right after it
+     * reads in the condition codes (cc), so that no register is allocated for it and
+     * the two are translated together, as a cmp and a jcc
+     */
+    static void fuseComparisons();
+
+    /**
+     * @brief Replaces the branches around two short sides of a conditional that set
+     * the same register by both sides one after the other, and a cmov that keeps the
+     * one the compare picks. Sides that only set it to 1 or 0 become the compare's
+     * value instead (A setcc)
+     */
+    static void selectConditionalMoves();
+
+    /**
+     * @brief If an instruction can run even where the code would have skipped it:
+     * it writes only its register, cannot fault and is about as fast as a cmov
+     * @param instruction The instruction
+     */
+    static bool isSpeculable(Tac *instruction);
+
+    /**
+     * @brief If a function makes no calls, so that nothing is pushed below the stack
+     * pointer while it runs and its variables can stay in the red zone
+     * @param code The function's code
+     */
+    static bool isLeaf(TacList code);
+
+    /**
+     * @brief Finds the registers the current function must save: the callee-saved
+     * ones it writes, at its start, and the caller-saved ones live across each of
+     * its calls, around the call. Each is given a stack slot after the spilled
+     * registers', and the bytes needed by arguments passed in the stack are counted
+     */
+    static void findSavedRegisters();
+
+    /**
+     * @brief If an instruction stacks an argument passed in a register for the call
+     * right after it (Only read from its register at the call, see call_arguments)
+     * @param instruction The TAC code
      */
-    static std::string generateFunctionEnd(Tac *current);
+    static bool passesArgument(Tac *instruction);
+
+    /**
+     * @brief Adds the movs that copy each source to its destination as if all of them
+     * were done at once, using %rax to break cycles (Such as arguments passed in %r8
+     * and %r9 that come from each other)
+     * @param moves Pairs of source and destination
+     */
+    static void moveInParallel(std::vector<std::pair<std::string, std::string>> moves);
+
+    /**
+     * @brief Returns the memory operand of a stack slot of the current function
+     * @param offset Its offset below the frame (ILOC's rfp)
+     */
+    static std::string getSlot(int offset);
 
     /**
      * @brief Runs through the code performing variable 
      * liveness tests, and generates a temp - register map
      * to be used when translating this instruction's code 
-     * @param first First TAC of the function
+     * @param cfg Control flow graph of the function
+     */
+    static void allocateRegisters(CFG *cfg);
+
+    /**
+     * @brief Estimates the cost of keeping each register in memory: one load or
+     * store per reference, SPILL_LOOP_WEIGHT times more for each loop it is in.
+     * Registers that cannot be spilled cost infinity
+     * @param cfg            Control flow graph of the function
+     * @param register_count Number of registers in the function
+     * @returns The cost of each register, by register id
+     */
+    static std::vector<double> getSpillCosts(CFG *cfg, int register_count);
+
+    /**
+     * @brief If an instruction is translated together with the one before it, so
+     * that nothing can be placed between them
+     * @param instruction The TAC code
      */
-    static void allocateRegisters(Tac *first);
+    static bool isGlued(Tac *instruction);
+
+    /**
+     * @brief If a load or store goes through an address not calculated right before it
+     * (Such as the one a shift writes back to), which may be any variable's
+     * @param instruction The TAC code
+     */
+    static bool isIndirect(Tac *instruction);
+
+    /**
+     * @brief Keeps registers in stack slots instead: each instruction that uses one
+     * gets a new register, loaded from the slot before and stored to it after the
+     * instruction
+     * @param spilled The registers
+     */
+    static void spillRegisters(std::vector<Operand *> spilled);
 
     /**
      * @brief Generates the register interference graph 
      * for a variable liveness-anotated TAC sequence
-     * @param first First instruction in the TAC sequence
-     * @param temps List of temporary variables that appear in the TAC sequence
+     * @param cfg      Control flow graph of the function
+     * @param liveness Variables live at the start and end of each block
+     * @param temps    List of temporary variables that appear in the TAC sequence
+     * @param costs    Cost of keeping each register in memory, by register id
      * @returns Register interference graph for that sequence
      */
-    static Graph *createRegisterInterferenceGraph(Tac *first, std::vector<std::string *> temps);
+    static Graph *createRegisterInterferenceGraph(CFG *cfg, Liveness *liveness, std::vector<Operand *> temps, std::vector<double> &costs);
+
+    /**
+     * @brief Returns the pairs of registers of an instruction that need a mov between
+     * them unless they are given the same machine register (The copy of an i2i, or the
+     * source and destination of an add or sub, which x86_64 does in place)
+     * @param instruction The TAC code
+     */
+    static std::vector<std::pair<Operand *, Operand *>> getCopies(Tac *instruction);
+
+    /**
+     * @brief Generates the live interval of each temporary variable, numbering the
+     * instructions in the order they appear in the code
+     * @param cfg      Control flow graph of the function
+     * @param liveness Variables live at the start and end of each block
+     * @param temps    List of temporary variables that appear in the TAC sequence
+     * @param costs    Cost of keeping each register in memory, by register id
+     * @returns Linear scan allocator with those intervals
+     */
+    static LinearScan *createLiveIntervals(CFG *cfg, Liveness *liveness, std::vector<Operand *> temps, std::vector<double> &costs);
 
     /**
      * @brief Translates the argument to the ASM syntax
      * @param arg Argument 
      */
-    static std::string translateArgument(std::string *arg);
+    static std::string translateArgument(Operand *arg);
 
     /**
-     * @brief Translates the TAC instruction to an ASM instruction 
-     * @param instruction The TAC code
-     * @returns String containing the ASM instruction
+     * @brief Finds the multiplier and shift that divide a 32 bit number by a constant
+     * that is not a power of two: n / d = (n * magic) >> shift, rounded down
+     * @param divisor The constant's absolute value (At least 3)
+     * @param magic   Where the multiplier goes (The reciprocal, rounded up)
+     * @param shift   Where the shift goes
      */
-    static std::string translateTac(Tac *current);
+    static void getDivisionMagic(int divisor, long long &magic, int &shift);
 
-    // CHECKERS
+    /**
+     * @brief Translates the TAC instruction to ASM instructions, added to the end
+     * of the current function's code
+     * @param instruction The TAC code
+     */
+    static void translateTac(Tac *current);
 
     /**
-     * @brief Checks if given insstruction starts a new function
-     * @param instruction The checked TAC
-     * @returns True if starts a new function, false otherwise 
+     * @brief Returns the function that starts at the given label
+     * @param label The label
+     * @returns The function's symbol, or NULL if the label does not start a function
      */
-    static bool startsNewFunction(Tac *instruction);
+    static Symbol *getFunction(Operand *label);
 };
 
 #endif
@@ -0,0 +1,104 @@
+/**
+ * This file contains the BasicBlock class, a maximal sequence of instructions in a
+ * function's code that is only entered through its first instruction and only left
+ * through its last one. Blocks are identified by their index in the function's
+ * control flow graph (See CFG), and refer to each other through those indexes.
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef BASICBLOCK_H
+#define BASICBLOCK_H
+
+#include <string>
+#include <vector>
+
+// Forward declare Tac
+class Tac;
+
+class BasicBlock
+{
+private:
+    int id; // Index of the block in its control flow graph
+
+    Tac *first; // First instruction in the block
+    Tac *last;  // Last instruction in the block
+    int size;   // Amount of instructions in the block
+
+    std::vector<int> successors;   // Blocks control can go to after this one
+    std::vector<int> predecessors; // Blocks control can come from before this one
+
+public:
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Creates a block containing a single instruction
+     * @param id_    Index of the block in its control flow graph
+     * @param first_ First instruction in the block
+     */
+    BasicBlock(int id_, Tac *first_);
+
+    /**
+     * @brief Class destructor
+     */
+    ~BasicBlock();
+
+    // GETTERS
+
+    /**
+     * @brief Returns the index of the block in its control flow graph
+     */
+    int getId();
+
+    /**
+     * @brief Returns the first instruction in the block
+     */
+    Tac *getFirst();
+
+    /**
+     * @brief Returns the last instruction in the block
+     */
+    Tac *getLast();
+
+    /**
+     * @brief Returns the amount of instructions in the block
+     */
+    int getSize();
+
+    /**
+     * @brief Returns the blocks control can go to after this one
+     */
+    std::vector<int> &getSuccessors();
+
+    /**
+     * @brief Returns the blocks control can come from before this one
+     */
+    std::vector<int> &getPredecessors();
+
+    // SETTERS
+
+    /**
+     * @brief Adds the instruction following the block's last one to it
+     */
+    void extend();
+
+    /**
+     * @brief Adds a block control can go to after this one
+     * @param block_id Index of the successor block
+     */
+    void addSuccessor(int block_id);
+
+    /**
+     * @brief Adds a block control can come from before this one
+     * @param block_id Index of the predecessor block
+     */
+    void addPredecessor(int block_id);
+
+    // EXPORT
+
+    /**
+     * @brief Returns the ILOC code for the block's instructions, one per line
+     */
+    std::string getCodeString();
+};
+
+#endif // BASICBLOCK_H
@@ -0,0 +1,104 @@
+/**
+ * This file contains the Bitset class, a fixed size set of small integers (Such as
+ * register ids) stored as one bit per element in 64 bit words, so that unions and
+ * differences between sets handle 64 elements at a time.
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <vector>
+#include <cstdint>
+
+class Bitset
+{
+private:
+    std::vector<uint64_t> words; // Elements, 64 per word
+    int size;                    // Maximum amount of elements
+
+public:
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Creates an empty set
+     * @param size_ Elements go from 0 up to (but not including) this number
+     */
+    Bitset(int size_ = 0);
+
+    /**
+     * @brief Class destructor
+     */
+    ~Bitset();
+
+    // GETTERS
+
+    /**
+     * @brief Returns the maximum amount of elements in the set
+     */
+    int getSize();
+
+    /**
+     * @brief Returns the amount of elements in the set
+     */
+    int count();
+
+    /**
+     * @brief Returns the first element in the set that is not smaller than the given one
+     * @param element Where to start looking from
+     * @returns The element found, or the set's size if there are none
+     */
+    int next(int element);
+
+    // CHECKERS
+
+    /**
+     * @brief If the element is in the set
+     */
+    bool test(int element);
+
+    /**
+     * @brief If there are no elements in the set
+     */
+    bool isEmpty();
+
+    /**
+     * @brief If both sets have the same elements
+     */
+    bool operator==(const Bitset &set) const;
+
+    /**
+     * @brief If the sets have different elements
+     */
+    bool operator!=(const Bitset &set) const;
+
+    // SETTERS
+
+    /**
+     * @brief Adds an element to the set
+     */
+    void set(int element);
+
+    /**
+     * @brief Removes an element from the set
+     */
+    void reset(int element);
+
+    /**
+     * @brief Removes every element from the set
+     */
+    void clear();
+
+    /**
+     * @brief Adds every element of another set (Of the same size) to this one
+     * @returns True if the set changed, false otherwise
+     */
+    bool unite(const Bitset &set);
+
+    /**
+     * @brief Removes every element of another set (Of the same size) from this one
+     */
+    void subtract(const Bitset &set);
+};
+
+#endif // BITSET_H
@@ -0,0 +1,160 @@
+/**
+ * This file contains the CFG class, the control flow graph for a function's code.
+ * The code is split into basic blocks at labels and after branches (cbr, jumpI,
+ * jump), and each block is linked to the blocks control can go to after it:
+ *
+ *  cbr   r => l1, l2 | The blocks starting at l1 and l2
+ *  jumpI    => l1    | The block starting at l1, or the next block if l1 is a function,
+ *                    | this one included (A call, which returns to the following instruction)
+ *  jump     => r     | None, returns from the function
+ *  other             | The next block
+ *
+ * The first block is the function's entry. The graph also keeps a reverse post-order
+ * of the blocks reachable from the entry, the immediate dominator of each of them,
+ * and how many loops each block is in. A loop is made by the edges going back to a
+ * block that dominates their origin (Its header), and contains every block that can
+ * reach them without going through the header. The blocks of each loop are kept by
+ * its header.
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef CFG_H
+#define CFG_H
+
+#include "BasicBlock.h"
+#include "TacList.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// Forward declare Tac
+class Tac;
+
+class CFG
+{
+private:
+    std::vector<BasicBlock> blocks; // Basic blocks, the entry one first
+
+    std::vector<int> order;      // Blocks reachable from the entry, in reverse post-order
+    std::vector<int> rpo_index;  // Position of each block in the reverse post-order, -1 if unreachable
+    std::vector<int> idom;       // Immediate dominator of each block, -1 if unreachable
+    std::vector<int> loop_depth; // Number of loops each block is in
+    std::vector<bool> calls;     // If each block ends calling a function
+
+    std::vector<std::vector<int>> loops; // Blocks in the loop each block is the header of, itself first
+
+    /**
+     * @brief Splits the code into basic blocks
+     * @param code The function's instructions
+     * @returns Block starting at each of the labels in the code, by label number
+     */
+    std::unordered_map<int, int> split(TacList code);
+
+    /**
+     * @brief Links each block to the blocks control can go to after it
+     * @param labels Block starting at each of the labels in the code, by label number
+     */
+    void link(std::unordered_map<int, int> &labels);
+
+    /**
+     * @brief Computes the reverse post-order of the blocks reachable from the entry
+     */
+    void computeOrder();
+
+    /**
+     * @brief Computes the immediate dominator of every reachable block
+     */
+    void computeDominators();
+
+    /**
+     * @brief Finds the loops in the graph, and how deep each block is nested in them
+     */
+    void computeLoops();
+
+    /**
+     * @brief Finds the closest common dominator of two reachable blocks
+     */
+    int intersect(int block_1, int block_2);
+
+public:
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Builds the control flow graph for a function
+     * @param code The function's instructions, from its first to its last
+     */
+    CFG(TacList code);
+
+    /**
+     * @brief Class destructor
+     */
+    ~CFG();
+
+    // GETTERS
+
+    /**
+     * @brief Returns the number of basic blocks
+     */
+    int getBlockCount();
+
+    /**
+     * @brief Returns the indexed basic block
+     * @param block_id Index of the block, 0 being the entry
+     */
+    BasicBlock *getBlock(int block_id);
+
+    /**
+     * @brief Returns the blocks reachable from the entry, in reverse post-order
+     */
+    std::vector<int> &getReversePostOrder();
+
+    /**
+     * @brief Returns the immediate dominator of a block (The entry is its own)
+     * @param block_id Index of the block
+     * @returns Index of the dominator, -1 if the block is unreachable
+     */
+    int getImmediateDominator(int block_id);
+
+    /**
+     * @brief Returns the number of loops a block is in (0 outside of loops)
+     * @param block_id Index of the block
+     */
+    int getLoopDepth(int block_id);
+
+    /**
+     * @brief Returns the blocks in the loop a block is the header of
+     * @param block_id Index of the header
+     * @returns The header followed by the other blocks, empty if the block is not a header
+     */
+    std::vector<int> &getLoop(int block_id);
+
+    // CHECKERS
+
+    /**
+     * @brief If the block can be reached from the entry
+     */
+    bool isReachable(int block_id);
+
+    /**
+     * @brief If a block ends calling a function (Instead of jumping within this one)
+     */
+    bool isCall(int block_id);
+
+    /**
+     * @brief If every path from the entry to a block goes through another
+     * @param dominator Index of the block that should dominate
+     * @param block_id  Index of the dominated block
+     */
+    bool dominates(int dominator, int block_id);
+
+    // EXPORT
+
+    /**
+     * @brief Returns a description of every block, with its edges, immediate
+     * dominator and ILOC code
+     */
+    std::string toString();
+};
+
+#endif // CFG_H
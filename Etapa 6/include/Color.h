@@ -37,7 +37,7 @@ public:
     /**
      * @brief Returns this color's list of users 
      */
-    std::vector<unsigned int> getUsers();
+    std::vector<unsigned int> &getUsers();
 
     /**
      * @brief Returns the amount of vertexes that
@@ -0,0 +1,166 @@
+/**
+ * This file contains the CopyPropagation class, which makes the instructions of a
+ * function read the original value instead of a copy of it, so that the copies
+ * (And the loads and stores a variable goes through) are left dead for DeadCode:
+ *
+ *  i2i   r1 => r2    | r2 is a copy of r1
+ *  loadI c1 => r2    | r2 is a copy of the constant c1
+ *  store r1 => addr  | The local variable at addr (rfp plus an offset) holds a copy
+ *                    | of r1, and a load from it is one as well (Becomes i2i r1)
+ *
+ * A copy holds until either side is written again, or for local variables, until a
+ * function is called, rfp changes or something is stored through an address that
+ * is not known. The copies that hold at the start of each block
+ * are the ones that hold at the end of every block before it, found by iterating
+ * over the blocks until nothing changes (Global over the CFG). Only the copies in
+ * registers that some block reads before writing them leave a block, which keeps
+ * the sets small (Without the liveness of every register in every block, which
+ * takes far more memory in long functions).
+ *
+ * Reading through a chain of copies (r3 is a copy of r2, which is a copy of r1)
+ * goes to its start, so they collapse. Constants go into instructions that have a
+ * form with an immediate (add r1, r2 => addI r1, c2), and arithmetic on constants
+ * only becomes a constant (Wrapping around, as folding in the AST does). Registers
+ * go anywhere except the address of a load or store, which the ASM generator folds
+ * into the instruction before it. Loads that start a return sequence are kept for
+ * the same reason.
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef COPYPROPAGATION_H
+#define COPYPROPAGATION_H
+
+#include "CFG.h"
+#include "Bitset.h"
+#include "DeadCode.h"
+#include "TacList.h"
+#include "Operand.h"
+#include "Type.h"
+
+#include <unordered_map>
+#include <vector>
+
+// Forward declare Tac
+class Tac;
+
+class CopyPropagation
+{
+private:
+    TacList *code;   // Function's code
+    int propagated;  // Instructions that read an original value instead of a copy
+    int forwarded;   // Loads turned into copies
+
+    std::unordered_map<Operand *, Operand *> copies;            // What each register holds a copy of
+    std::unordered_map<int, Operand *> slots;                   // What each local variable holds a copy of, by its offset
+    std::unordered_map<Operand *, std::vector<Operand *>> from; // Registers copied from each one (Some may not be anymore)
+    std::unordered_map<Operand *, std::vector<int>> stored;     // Local variables each register was stored to (Same)
+
+    std::vector<std::unordered_map<Operand *, Operand *>> copies_out; // Copies in registers at the end of each block
+    std::vector<std::unordered_map<int, Operand *>> slots_out;        // Copies in local variables at the end of each block
+    std::vector<bool> visited;                                        // If each block was walked already
+
+    /**
+     * @brief If two operands hold the same value (The same register, or equal constants)
+     */
+    static bool isSame(Operand *operand_1, Operand *operand_2);
+
+    /**
+     * @brief Returns the form of an operation that takes an immediate as its second
+     * operand (add => addI), or the operation itself if there is none
+     */
+    static ILOCop getImmediateForm(ILOCop opcode);
+
+    /**
+     * @brief Computes an arithmetic operation on constants (Any form, add or addI)
+     * @param opcode  The operation
+     * @param value_1 Its first operand
+     * @param value_2 Its second operand
+     * @param result  Where the result goes
+     * @returns False if it cannot be computed (Not arithmetic, a division by 0 or a
+     * shift by 32 or more)
+     */
+    static bool fold(ILOCop opcode, int value_1, int value_2, int &result);
+
+    /**
+     * @brief Returns the value a register holds a copy of, following chains of copies
+     * @param operand        The register
+     * @param registers_only Stop at the last register, instead of going into a constant
+     * @returns The original register or constant, the operand itself if not a copy
+     */
+    Operand *resolve(Operand *operand, bool registers_only);
+
+    /**
+     * @brief Returns the result of an arithmetic instruction that reads constants only
+     * @returns The result, as an immediate, or NULL if it is not known
+     */
+    Operand *evaluate(Tac *instruction);
+
+    /**
+     * @brief If a local variable still holds a copy of a register
+     */
+    bool isStored(Operand *source);
+
+    /**
+     * @brief Records that a register holds a copy of another register or constant
+     */
+    void setCopy(Operand *target, Operand *source);
+
+    /**
+     * @brief Records that a local variable holds a copy of a register
+     */
+    void setSlot(int slot, Operand *source);
+
+    /**
+     * @brief Forgets the copies a register being written breaks (Into it, and out of it)
+     */
+    void kill(Operand *target);
+
+    /**
+     * @brief Forgets every copy in a local variable
+     */
+    void killSlots();
+
+    /**
+     * @brief Starts a block with the copies that hold at the end of every block before it
+     * @param block The block
+     */
+    void enter(BasicBlock *block);
+
+    /**
+     * @brief Makes an instruction read the original values instead of copies
+     * @returns True if it was rewritten
+     */
+    bool propagate(Tac *instruction);
+
+    /**
+     * @brief Updates the copies that hold after an instruction
+     * @param instruction The instruction
+     * @param rewrite     Whether it should also be rewritten to read the original values
+     */
+    void transfer(Tac *instruction, bool rewrite);
+
+public:
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Propagates the copies in a function
+     * @param code_           The function's code
+     * @param register_count_ Number of registers in the function
+     */
+    CopyPropagation(TacList &code_, int register_count_);
+
+    /**
+     * @brief Class destructor
+     */
+    ~CopyPropagation();
+
+    // GETTERS
+
+    /**
+     * @brief Returns the amount of instructions rewritten (Reading the original
+     * values, or loads turned into copies)
+     */
+    int getRewrittenCount();
+};
+
+#endif // COPYPROPAGATION_H
@@ -0,0 +1,138 @@
+/**
+ * This file contains the DeadCode class, which removes the instructions of a
+ * function that can never run or whose results are never used:
+ *
+ *  - Blocks that cannot be reached from the entry (Code after a return, the
+ *    default return of a function that always returns, branches never taken)
+ *  - Nops, their label going to the instruction after them
+ *  - Stores to local variables that are never loaded before being written again
+ *    or the function returning. Local variables live in the frame (rfp plus an
+ *    offset) and are only loaded from there, so a backward analysis over the
+ *    blocks finds the ones that may still be loaded after each store. Only the
+ *    variables some block loads before storing to them can be live where a
+ *    block starts, so only those are followed across blocks, and only the
+ *    blocks after one whose variables changed are visited again. Stores to the
+ *    rest of the frame (Such as the return value, read by the caller) are kept,
+ *    and loads through an address that is not known may read any of them
+ *  - Instructions that only write a register (Arithmetic, comparisons, copies
+ *    and loads) which no other instruction reads, or which is written again in
+ *    the same block before being read. The times each register is read are
+ *    counted, so removing an instruction lowers the counts of the registers it
+ *    reads, and the ones that write those are checked again. The liveness of
+ *    every register in every block (See Liveness) is not needed for this, and
+ *    would take far more memory in long functions
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef DEADCODE_H
+#define DEADCODE_H
+
+#include "CFG.h"
+#include "TacList.h"
+#include "Operand.h"
+#include "Bitset.h"
+#include "Type.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Forward declare Tac
+class Tac;
+
+class DeadCode
+{
+private:
+    TacList *code;      // Function's code
+    int register_count; // Number of registers in the function
+    int locals_start;   // Offset from rfp where the local variables start
+
+    int unreachable; // Instructions removed for being unreachable
+    int nops;        // Nops removed
+    int dead_stores; // Stores to local variables removed
+    int dead;        // Instructions removed for writing dead registers
+
+    std::unordered_map<int, int> slots; // Index of each local variable, by its offset from rfp
+
+    /**
+     * @brief Updates a set of local variables that may be loaded after an instruction
+     * into the set of ones that may be loaded before it
+     */
+    void transferSlots(Tac *instruction, Bitset &live);
+
+    /**
+     * @brief If an instruction does nothing but write a register
+     */
+    bool isPure(Tac *instruction);
+
+    /**
+     * @brief Takes an instruction out of the code, its label (If any) going to the
+     * instruction after it
+     * @returns False if it could not be removed (Both are labeled, or it is the last one)
+     */
+    bool remove(Tac *instruction);
+
+    /**
+     * @brief Removes the blocks that cannot be reached from the entry
+     */
+    void removeUnreachable();
+
+    /**
+     * @brief Removes nops that do not end the code
+     */
+    void removeNops();
+
+    /**
+     * @brief Removes the stores to local variables that are never loaded
+     */
+    void removeDeadStores();
+
+    /**
+     * @brief Lowers the count of the registers a removed instruction reads, and
+     * queues them to check the instructions that write them again
+     */
+    void removeUses(Tac *instruction, std::vector<int> &uses, std::vector<int> &worklist);
+
+    /**
+     * @brief Removes the instructions that write dead registers, until there are none
+     */
+    void removeDeadInstructions();
+
+public:
+    /**
+     * @brief Returns the offset from rfp an instruction stores to or loads from, or
+     * -1 if it does not (Or the address is not known)
+     */
+    static int getSlot(Tac *instruction);
+
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Removes unreachable and dead code from a function
+     * @param code_           The function's code
+     * @param register_count_ Number of registers in the function
+     * @param locals_start_   Offset from rfp where the local variables start (After the
+     *                        return address, old rsp and rfp, parameters and return value)
+     */
+    DeadCode(TacList &code_, int register_count_, int locals_start_);
+
+    /**
+     * @brief Class destructor
+     */
+    ~DeadCode();
+
+    // GETTERS
+
+    /**
+     * @brief Returns the amount of instructions removed
+     */
+    int getRemovedCount();
+
+    /**
+     * @brief Returns how many instructions were removed for each reason, such as
+     * "unreachable 3, nops 2, dead stores 1, dead 7"
+     */
+    std::string getStats();
+};
+
+#endif // DEADCODE_H
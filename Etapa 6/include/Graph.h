@@ -2,6 +2,21 @@
  * Graph class which models efficient data structures for consulting node 
  * adjacency and colors.
  * 
+ * Adjacency is kept twice: a triangular bit-matrix with one bit per pair of
+ * vertexes answers if two vertexes are adjacent in constant time, and each
+ * vertex lists its (distinct) neighbours for iterating them. Graphs with more
+ * than GRAPH_MATRIX_MAX_VERTEXES vertexes keep the adjacent pairs in a hash set
+ * instead of the matrix, which would be too big.
+ * 
+ * Coloring follows Chaitin-Briggs: vertexes joined by a copy are first merged
+ * (coalesced) when that cannot make the graph harder to color (Briggs' and George's tests),
+ * then vertexes with less than k neighbours are removed one at a time (simplify),
+ * picking the one with the lowest spill cost per neighbour when there are none left,
+ * and finally they are given colors in the opposite order (select), which may still
+ * succeed for the vertexes picked that way (optimistic coloring). The ones that get
+ * no color are spilled: their registers must be kept in memory. Every choice is
+ * made in vertex order, so the same graph is always colored the same way.
+ * 
  * Author: Fábio de Azevedo Gomes 
  */
 #ifndef GRAPH_H
@@ -11,13 +26,16 @@
 #include <fstream>
 #include <sstream>
 #include <vector>
-#include <map>
+#include <unordered_set>
+#include <queue>
 #include <string>
+#include <cstdint>
 
 #include "Color.h"
 #include "Vertex.h"
-#include "Edge.h"
 #include "Type.h"
+#include "Operand.h"
+#include "Bitset.h"
 
 class Graph
 {
@@ -27,25 +45,88 @@ private:
     unsigned int edge_count;
     unsigned int used_colors_counter;
 
-    // Map vertex name to ID
-    std::map<std::string *, int> vertex_ids;
+    // Vertex ID for each register id
+    std::vector<int> vertex_ids;
 
     // Vertex set V
     std::vector<Vertex> V;
 
-    // Edge set E
-    std::vector<Edge> E;
-
     // Color set C
     std::vector<Color> C;
 
+    // Edge set E
+    Bitset matrix;                      // Bit for each pair of vertexes, if they are adjacent
+    std::unordered_set<uint64_t> pairs; // Adjacent pairs, when the graph is too big for the matrix
+    bool use_matrix;                    // Whether the matrix is being used
+
+    // Pairs of vertexes that would rather have the same color (Copies between them)
+    std::vector<std::pair<unsigned int, unsigned int>> moves;
+
+    // Vertex each vertex was merged into (Itself if it was not)
+    std::vector<unsigned int> alias;
+
+    // Vertexes that could not be colored
+    std::vector<unsigned int> spilled;
+
+    /**
+     * @brief Returns the position of a pair of vertexes in the matrix (Or its key in the pair set) 
+     */
+    uint64_t getPairIndex(unsigned int vertex_1, unsigned int vertex_2);
+
+    /**
+     * @brief Adds the edge between two (Not yet adjacent) vertexes 
+     */
+    void connect(unsigned int vertex_1, unsigned int vertex_2);
+
+    /**
+     * @brief Removes the edge between two vertexes 
+     */
+    void removeEdge(unsigned int vertex_1, unsigned int vertex_2);
+
+    /**
+     * @brief Returns the vertex that a vertex was merged into 
+     */
+    unsigned int getAlias(unsigned int vertex_id);
+
+    /**
+     * @brief Checks if merging two vertexes leaves less than k neighbours
+     * with k or more neighbours (Briggs' test), so the merged vertex can
+     * still be simplified, or if the neighbours of one of them are already
+     * the other's or have less than k neighbours (George's test)
+     */
+    bool canCoalesce(unsigned int vertex_1, unsigned int vertex_2, unsigned int k);
+
+    /**
+     * @brief Merges the second vertex into the first one 
+     */
+    void coalesce(unsigned int vertex_1, unsigned int vertex_2);
+
+    /**
+     * @brief Merges the vertexes of every move that passes the tests (See canCoalesce)
+     */
+    void coalesceMoves(unsigned int k);
+
+    /**
+     * @brief Removes every (Not merged) vertex from the graph, low degree ones first,
+     * then the ones cheapest to spill
+     * @returns The vertexes in the order they were removed
+     */
+    std::vector<unsigned int> simplify(unsigned int k);
+
+    /**
+     * @brief Colors the vertexes in the opposite order they were removed, each
+     * with the first of the k colors none of its neighbours has, if there is one
+     */
+    void select(std::vector<unsigned int> &removed, unsigned int k);
+
 public:
     // CONSTRUCTOR AND DESTRUCTOR
 
     /**
      * @brief Constructs an empty graph 
+     * @param max_vertexes Maximum amount of vertexes that will be added
      */
-    Graph();
+    Graph(unsigned int max_vertexes = 0);
 
     /**
      * @brief Copy constructor 
@@ -60,14 +141,23 @@ public:
     // BUILDERS
 
     /**
-     * @brief Adds a new vertex to the graph 
+     * @brief Adds a new vertex to the graph, standing for a temporary register
+     * @param reg  The register
+     * @param cost Estimated cost of keeping the register in memory
      */
-    void addVertex(std::string *name);
+    void addVertex(Operand *reg, double cost = 1);
 
     /**
-     * @brief Adds a new edge to the graph, connecting two vertexes 
+     * @brief Adds a new edge to the graph, connecting the vertexes of two registers
+     * (Nothing is done if they are already adjacent) 
      */
-    void addEdge(std::string *end_1, std::string *end_2);
+    void addEdge(Operand *end_1, Operand *end_2);
+
+    /**
+     * @brief Records a copy between the vertexes of two registers, which will be
+     * given the same color if possible
+     */
+    void addMove(Operand *end_1, Operand *end_2);
 
     // GETTERS
 
@@ -90,23 +180,18 @@ public:
     /**
      * @brief Returns the list of vertexes for this graph 
      */
-    std::vector<Vertex> getVertexes();
+    std::vector<Vertex> &getVertexes();
 
     /**
      * @brief Returns the list of colors for this graph 
      */
-    std::vector<Color> getColors();
+    std::vector<Color> &getColors();
 
     /**
      * @brief Returns the list of colors that are used for this graph 
      */
     std::vector<Color> getUsedColors();
 
-    /**
-     * @brief Returns this list of edges for this graph 
-     */
-    std::vector<Edge> getEdges();
-
     /**
      * @brief Returns a pointer to indexed vertex
      * @param vertex_id Identifier for the wanted vertex
@@ -138,6 +223,11 @@ public:
 
     // INFORMATION
 
+    /**
+     * @brief Checks if two vertexes are adjacent 
+     */
+    bool isAdjacent(unsigned int vertex_1, unsigned int vertex_2);
+
     /**
      * @brief Checks if vertex can use the color 
      */
@@ -153,16 +243,22 @@ public:
     /**
      * @brief Attempts to minimize the amount of "colors" (AKA
      * registers) necessary for the graph, by using a K-coloring
-     * heuristic 
+     * heuristic (See the top of this file)
      * @param k Maximum number of registers
      * @returns True if was able to minimize register usage within given amount, false otherwise
      */
     bool minimizeRegisterUsage(int k);
 
     /**
-     * @brief Returns the color that was given to each vertex 
+     * @brief Returns the registers that got no color, after minimizing
+     */
+    std::vector<Operand *> getSpilled();
+
+    /**
+     * @brief Returns the machine register name given to each temporary register,
+     * indexed by register id (Empty for registers without a vertex)
      */
-    std::map<std::string *, std::string> getColorMapping();
+    std::vector<std::string> getColorMapping();
 };
 
 #endif
@@ -0,0 +1,128 @@
+/**
+ * This file contains the Inliner class, which replaces the calls of a function to
+ * small functions with a copy of their code, saving the calling sequence (Storing
+ * the return address, the old rsp and rfp and the arguments in the new frame,
+ * setting up the frame, loading the arguments back from it and restoring
+ * everything on return), and letting the other passes optimize the copy together
+ * with the code around it.
+ *
+ * Functions are optimized as they are declared, and can only call the ones declared
+ * before them (Or themselves), so the code of every function that may be inlined is
+ * already optimized and its own calls were already inlined. A call is inlined if:
+ *
+ *  - It calls another function (Recursive functions are never inlined, copying
+ *    their code would still leave the call to themselves)
+ *  - The called function's code, without the calling sequence, is at most as long
+ *    as the threshold (See setThreshold)
+ *  - It does not start a return, as the ASM generator reads the returned value
+ *    from the first instruction of a return
+ *
+ * The copy gets its own registers and labels. Its local variables go after the
+ * ones of the function (Growing its frame by enough for the largest function
+ * inlined, calls run one after the other so they can share it), the arguments are
+ * copied to registers instead of stored in the frame and each return copies its
+ * value to the register the call's result went to, jumping to the instruction
+ * after the call:
+ *
+ *  storeAI r1 => rsp, 12 | i2i     r1 => r9      (Argument)
+ *  jumpI      => L2      | ... copy of the code, with loadAI rfp, 12 => r10
+ *                        |                        now i2i r9 => r10 ...
+ *                        | i2i     r11 => r5     (Each return)
+ *                        | jumpI       => L7
+ *  loadAI rsp, 16 => r5  | L7: nop
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef INLINER_H
+#define INLINER_H
+
+#include "TacList.h"
+#include "Symbol.h"
+#include "Operand.h"
+#include "Type.h"
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Forward declare Tac
+class Tac;
+
+class Inliner
+{
+private:
+    static int threshold;                                // Largest code of a function that is inlined, in instructions
+    static std::unordered_map<int, Symbol *> functions; // Functions already optimized, by their label
+
+    Symbol *function; // Function being inlined into
+    TacList *code;    // Its code
+    int inlined;      // Calls replaced with the called function's code
+
+    int frame_size; // Size of the function's frame before inlining
+    int extra_size; // Size added to it for the local variables of inlined functions
+
+    std::unordered_set<int> labels; // Labels in the function, jumps to any other one are calls
+    std::vector<std::string> log;   // What was done with each call
+
+    /**
+     * @brief Replaces a call with the called function's code, if it is worth it
+     * @param start First instruction of the calling sequence (addI rpc)
+     */
+    void inlineCall(Tac *start);
+
+    /**
+     * @brief Returns the size of a function's code without its calling sequence
+     * @returns -1 if it can not be inlined (It calls itself, or uses its frame in a
+     * way other than the calling sequence and its local variables)
+     */
+    int getInlinedSize(Symbol *callee);
+
+    /**
+     * @brief Takes an instruction of the calling sequence out of the code (Leaving a
+     * nop in its place, if it has a label)
+     */
+    void discard(Tac *instruction);
+
+public:
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Inlines the calls of a function that are worth it
+     * @param function_ The function
+     * @param code_     Its code
+     */
+    Inliner(Symbol *function_, TacList &code_);
+
+    /**
+     * @brief Class destructor
+     */
+    ~Inliner();
+
+    // GETTERS
+
+    /**
+     * @brief Returns the amount of calls inlined
+     */
+    int getInlinedCount();
+
+    /**
+     * @brief Returns what was done with each call, one line each (Inlined, or why not)
+     */
+    std::vector<std::string> getLog();
+
+    // SETTERS
+
+    /**
+     * @brief Sets the largest code of a function that is inlined, in instructions
+     * (0 disables inlining)
+     */
+    static void setThreshold(int threshold_);
+
+    /**
+     * @brief Makes an optimized function's code available for inlining
+     */
+    static void addFunction(Symbol *function);
+};
+
+#endif // INLINER_H
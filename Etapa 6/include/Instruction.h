@@ -0,0 +1,156 @@
+/**
+ * This file contains the Instruction class, a line of the generated x86_64 code:
+ * a machine instruction, a label or a comment. Each function's code is kept as a
+ * list of these until it is written out, so that it can still be rewritten (See
+ * Peephole). Operands are kept as written in AT&T syntax (Source first):
+ *
+ *  Register  | '%r8', '%r8d', '%rax'
+ *  Immediate | '$16'
+ *  Memory    | '-16(%rbp)', '__x(%rip)'
+ *  Label     | 'L3', or a function name
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef INSTRUCTION_H
+#define INSTRUCTION_H
+
+#include "Type.h"
+#include "Writer.h"
+
+#include <string>
+#include <vector>
+#include <cctype>
+
+class Instruction
+{
+private:
+    InstructionKind kind;              // What this line is
+    std::string text;                  // Opcode, label name or comment
+    std::vector<std::string> operands; // Operands, for machine instructions
+
+public:
+    /**
+     * @brief Returns the name of the lower 32 bits of a 64 bit register
+     * ('%r8' is '%r8d', '%rax' is '%eax'), or the name itself if it already is one
+     */
+    static std::string getLowRegister(std::string reg);
+
+    /**
+     * @brief Returns the name of the lowest byte of a 64 bit register
+     * ('%r8' is '%r8b', '%rax' is '%al', '%rdi' is '%dil')
+     */
+    static std::string getByteRegister(std::string reg);
+
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Creates a machine instruction
+     * @param opcode_   Instruction mnemonic, such as 'movq'
+     * @param operands_ Instruction operands, in AT&T order
+     */
+    Instruction(std::string opcode_, std::vector<std::string> operands_ = {});
+
+    /**
+     * @brief Creates a label or a comment
+     * @param kind_ INSTRUCTION_LABEL or INSTRUCTION_COMMENT
+     * @param text_ Label name or comment text (Which may span many lines)
+     */
+    Instruction(InstructionKind kind_, std::string text_);
+
+    /**
+     * @brief Class destructor
+     */
+    ~Instruction();
+
+    // GETTERS
+
+    /**
+     * @brief Returns what this line is
+     */
+    InstructionKind getKind();
+
+    /**
+     * @brief If this line is a machine instruction with the given opcode (Any, by default)
+     */
+    bool isOperation(std::string opcode_ = "");
+
+    /**
+     * @brief If this line is a label definition
+     */
+    bool isLabel();
+
+    /**
+     * @brief If this line is a comment
+     */
+    bool isComment();
+
+    /**
+     * @brief Returns the instruction's opcode, the label's name or the comment's text
+     */
+    std::string getText();
+
+    /**
+     * @brief Returns the number of operands
+     */
+    int getOperandCount();
+
+    /**
+     * @brief Returns the indexed operand
+     */
+    std::string getOperand(int index);
+
+    /**
+     * @brief If the indexed operand is a register
+     */
+    bool isRegister(int index);
+
+    /**
+     * @brief If the indexed operand is an immediate
+     */
+    bool isImmediate(int index);
+
+    /**
+     * @brief If the indexed operand is in memory
+     */
+    bool isMemory(int index);
+
+    /**
+     * @brief If this is a jump to a label (Conditional or not)
+     */
+    bool isJump();
+
+    /**
+     * @brief If this instruction's result depends on the condition flags
+     */
+    bool readsFlags();
+
+    /**
+     * @brief If this instruction overwrites the condition flags
+     */
+    bool writesFlags();
+
+    /**
+     * @brief Returns the line as written in the ASM file
+     */
+    std::string toString();
+
+    /**
+     * @brief Outputs the line as written in the ASM file
+     * @param out Where to
+     */
+    void write(Writer &out);
+
+    // SETTERS
+
+    /**
+     * @brief Replaces the instruction's opcode, or the label's name
+     */
+    void setText(std::string text_);
+
+    /**
+     * @brief Replaces the indexed operand
+     */
+    void setOperand(int index, std::string operand);
+};
+
+#endif // INSTRUCTION_H
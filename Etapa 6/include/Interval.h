@@ -0,0 +1,79 @@
+/**
+ * This file contains the Interval class, the range of instructions in which a
+ * temporary register may hold a live value. Instructions are numbered in the order
+ * they appear in the function's code, so an interval is just its first and last
+ * positions (It may cover positions where the register is not live, which only
+ * makes allocation more conservative). See LinearScan.
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef INTERVAL_H
+#define INTERVAL_H
+
+#include "Operand.h"
+
+class Interval
+{
+private:
+    Operand *reg; // Temporary register the interval stands for
+    int start;    // First position, -1 while empty
+    int end;      // Last position, -1 while empty
+    double cost;  // Estimated cost of keeping the register in memory instead
+    int color;    // Machine register given to the interval, -1 if none
+
+public:
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Creates an empty interval
+     * @param reg_  The temporary register
+     * @param cost_ Estimated cost of keeping the register in memory
+     */
+    Interval(Operand *reg_, double cost_ = 1);
+
+    /**
+     * @brief Class destructor
+     */
+    ~Interval();
+
+    // GETTERS
+
+    /**
+     * @brief Returns the temporary register the interval stands for
+     */
+    Operand *getRegister();
+
+    /**
+     * @brief Returns the first position in the interval
+     */
+    int getStart();
+
+    /**
+     * @brief Returns the last position in the interval
+     */
+    int getEnd();
+
+    /**
+     * @brief Returns the cost of keeping the register in memory
+     */
+    double getCost();
+
+    /**
+     * @brief Returns the machine register given to the interval, -1 if none
+     */
+    int getColor();
+
+    // SETTERS
+
+    /**
+     * @brief Grows the interval so that it contains the position
+     */
+    void extend(int position);
+
+    /**
+     * @brief Gives a machine register to the interval
+     */
+    void setColor(int color_);
+};
+
+#endif // INTERVAL_H
@@ -0,0 +1,110 @@
+/**
+ * This file contains the LinearScan class, a register allocator that trades some
+ * code quality for speed, meant for very large functions (See --linear-scan).
+ * Instead of an interference graph, each temporary register is given the interval
+ * of positions where it may be live, and the intervals are visited once, in the
+ * order they start (Poletto and Sarkar):
+ *
+ *  - Intervals that ended before the current one starts give their register back
+ *  - The current interval takes the register of the copy that defines it, if that
+ *    copy's source ends right there, or else the first free register
+ *  - If none is free, the active interval that ends last is spilled instead of
+ *    the current one, if it ends after it (Its register is taken over)
+ *
+ * Spilled registers are rewritten like the graph allocator's (See ASM): a load
+ * before and a store after each reference, which splits their interval into tiny
+ * ones around each use, and the scan runs again.
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef LINEARSCAN_H
+#define LINEARSCAN_H
+
+#include <vector>
+#include <set>
+#include <string>
+#include <sstream>
+#include <cmath>
+
+#include "Interval.h"
+#include "Operand.h"
+#include "Type.h"
+
+class LinearScan
+{
+private:
+    std::vector<Interval> intervals;   // Interval of each temporary register
+    std::vector<int> interval_ids;     // Index of the interval of each register id, -1 if none
+    std::vector<int> hints;            // Interval each interval is copied from, -1 if none
+    std::vector<unsigned int> spilled; // Intervals that got no register
+
+    unsigned int used_colors_counter; // Number of machine registers given
+
+public:
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Creates an allocator without intervals
+     * @param register_count Number of registers in the function
+     */
+    LinearScan(int register_count);
+
+    /**
+     * @brief Class destructor
+     */
+    ~LinearScan();
+
+    // BUILDERS
+
+    /**
+     * @brief Adds an empty interval for a temporary register
+     * @param reg  The register
+     * @param cost Estimated cost of keeping the register in memory
+     */
+    void addInterval(Operand *reg, double cost = 1);
+
+    /**
+     * @brief Grows a register's interval so that it contains the position
+     */
+    void extend(Operand *reg, int position);
+
+    /**
+     * @brief Records a copy between two registers, so that the destination may take
+     * the source's machine register
+     */
+    void addMove(Operand *source, Operand *destination);
+
+    // GETTERS
+
+    /**
+     * @brief Returns the number of intervals
+     */
+    unsigned int getIntervalCount();
+
+    /**
+     * @brief Returns the number of machine registers given
+     */
+    unsigned int getUsedColorCount();
+
+    /**
+     * @brief Returns the registers that got no machine register, after allocating
+     */
+    std::vector<Operand *> getSpilled();
+
+    /**
+     * @brief Returns the machine register name given to each temporary register,
+     * indexed by register id (Empty for registers without an interval)
+     */
+    std::vector<std::string> getColorMapping();
+
+    // COMPILER LOGIC
+
+    /**
+     * @brief Gives each interval one of k machine registers (See the top of this file)
+     * @param k Maximum number of registers
+     * @returns True if every interval got a register, false if some were spilled
+     */
+    bool allocateRegisters(int k);
+};
+
+#endif // LINEARSCAN_H
@@ -0,0 +1,83 @@
+/**
+ * This file contains the Liveness class, which finds the temporary registers that
+ * are live (Hold a value that may still be read) at the start and end of each basic
+ * block of a function. It is the usual backward dataflow analysis:
+ *
+ *  LiveOut(b) = Union of LiveIn(s), for every successor s of b
+ *  LiveIn(b)  = UsedBeforeDefined(b) + (LiveOut(b) - Defined(b))
+ *
+ * iterated until nothing changes. Registers are identified by their id in the
+ * function (See Operand), and every set is a Bitset.
+ *
+ * The sets for single instructions are not kept, they can be found on demand by
+ * walking a block backwards from its LiveOut set (See transfer).
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef LIVENESS_H
+#define LIVENESS_H
+
+#include "CFG.h"
+#include "Bitset.h"
+
+#include <vector>
+
+// Forward declare Tac
+class Tac;
+
+class Liveness
+{
+private:
+    CFG *cfg; // Control flow graph of the function
+
+    std::vector<Bitset> used;     // Registers read in each block before being written
+    std::vector<Bitset> defined;  // Registers written in each block
+    std::vector<Bitset> live_in;  // Registers live at the start of each block
+    std::vector<Bitset> live_out; // Registers live at the end of each block
+
+public:
+    /**
+     * @brief Updates a set of registers that are live after an instruction into
+     * the set of registers that are live before it
+     * @param instruction The instruction
+     * @param live        Registers live after the instruction
+     */
+    static void transfer(Tac *instruction, Bitset &live);
+
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Computes the registers live at the start and end of every block
+     * @param cfg_           Control flow graph of the function
+     * @param register_count Number of registers in the function
+     */
+    Liveness(CFG *cfg_, int register_count);
+
+    /**
+     * @brief Class destructor
+     */
+    ~Liveness();
+
+    // GETTERS
+
+    /**
+     * @brief Returns the registers live at the start of a block
+     * @param block_id Index of the block
+     */
+    Bitset &getLiveIn(int block_id);
+
+    /**
+     * @brief Returns the registers live at the end of a block
+     * @param block_id Index of the block
+     */
+    Bitset &getLiveOut(int block_id);
+
+    /**
+     * @brief Returns the registers live after each instruction in a block
+     * @param block_id Index of the block
+     * @returns One set per instruction, in the block's order
+     */
+    std::vector<Bitset> getInstructionLiveOut(int block_id);
+};
+
+#endif // LIVENESS_H
@@ -0,0 +1,124 @@
+/**
+ * This file contains the LoopInvariant class, which moves the computations of a
+ * function's loops that give the same result on every iteration out of them, into
+ * a preheader: instructions that go right before the loop's header, so that they
+ * run once whenever control enters the loop from outside of it (Branches from
+ * outside go to a new label on it, the ones inside still go to the header).
+ *
+ * An instruction is invariant if it does nothing but compute its register, can
+ * not fault (No division by a register, or by 0 or -1, which can overflow) and
+ * reads only registers that are not written in the loop, or that are written by
+ * other invariant instructions. The register it writes must not be written by
+ * anything else in the function, so it holds the same value wherever it is read,
+ * before the loop or after it. Such as:
+ *
+ *  addI  rbss, c1 => r1 | The start of a vector, which indexing adds to
+ *  multI r2, c2   => r3 | Where r2 is only written before the loop
+ *
+ * Loads of a variable go with the address calculation before them (See
+ * ASM::isGlued), as long as nothing in the loop stores to the variable, calls a
+ * function or stores through an address that is not known. Stores to vector
+ * elements (At an offset from the start of the vector, in a register) do not
+ * write variables, those always have their own address. Constants are only
+ * hoisted along with an instruction that reads them, loading one again is as
+ * cheap as keeping it in a register through the loop. Inner loops go first, so
+ * what leaves them can leave the loops around them as well.
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef LOOPINVARIANT_H
+#define LOOPINVARIANT_H
+
+#include "CFG.h"
+#include "TacList.h"
+#include "Operand.h"
+#include "Type.h"
+
+#include <set>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+// Forward declare Tac
+class Tac;
+
+class LoopInvariant
+{
+private:
+    TacList *code; // Function's code
+    int hoisted;   // Instructions moved out of loops
+
+    std::vector<int> definitions; // Times each register is written in the function
+    std::vector<Tac *> writers;   // Last instruction that writes each register
+    std::vector<bool> addresses;  // If each register is the address of a load or store
+
+    // About the loop being hoisted from
+    std::vector<bool> varying;                  // If each register is written in the loop, other than by hoisted instructions
+    std::unordered_set<Tac *> chosen;           // Instructions being hoisted
+    std::set<std::pair<Operand *, int>> stored; // Variables stored to, by base (rfp or rbss) and offset
+    bool calls;                                 // If it calls a function
+    bool unknown;                               // If it stores through an address that is not known
+
+    /**
+     * @brief Moves the invariant instructions of a loop to its preheader
+     * @param label Label of the loop's header
+     */
+    void hoistLoop(Operand *label);
+
+    /**
+     * @brief Records what the instructions of a loop write
+     * @param cfg    Control flow graph of the function
+     * @param blocks The loop's blocks
+     */
+    void scanLoop(CFG &cfg, std::vector<int> &blocks);
+
+    /**
+     * @brief If an instruction in the loop gives the same result on every iteration
+     */
+    bool isInvariant(Tac *instruction);
+
+    /**
+     * @brief Returns the instruction that calculates an address a store goes through
+     * @returns NULL if it is not a single addition, which variables and vector
+     * elements always are
+     */
+    Tac *getWriter(Operand *address);
+
+    /**
+     * @brief If a variable's address calculation and the load after it give the
+     * same result on every iteration of the loop
+     * @param address The address calculation (addI rfp : rbss, c)
+     */
+    bool isInvariantLoad(Tac *address);
+
+    /**
+     * @brief If moving an instruction (With the others being hoisted) would leave the
+     * address calculation before it right before a load or store, which the ASM
+     * generator would then take for its own
+     */
+    bool isSeparating(Tac *instruction);
+
+public:
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Hoists the invariant instructions of every loop in a function
+     * @param code_          The function's code
+     * @param register_count Number of registers in the function
+     */
+    LoopInvariant(TacList &code_, int register_count);
+
+    /**
+     * @brief Class destructor
+     */
+    ~LoopInvariant();
+
+    // GETTERS
+
+    /**
+     * @brief Returns the amount of instructions moved out of loops
+     */
+    int getHoistedCount();
+};
+
+#endif // LOOPINVARIANT_H
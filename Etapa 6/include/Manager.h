@@ -23,17 +23,29 @@ class ASM;
 #include "errors.h"
 #include "Tac.h"
 #include "ASM.h"
+#include "Optimizer.h"
 
 #include <stack>
 #include <list>
 #include <iostream>
 #include <cstring>
+#include <cmath>
+#include <climits>
 
 // PROVIDED EXTERN FUNCTIONS FOR MAIN.C
 extern void libera(void *arvore);
 extern void exporta(void *arvore);
 extern void export_code(void *arvore);
+extern void export_cfg(void *arvore);
 extern void generate_ASM(void *arvore);
+extern void enable_regalloc_stats();
+extern void enable_linear_scan();
+extern void enable_peephole_stats();
+extern void disable_tac_comments();
+extern void force_frame_pointer();
+extern void enable_optimizer_stats();
+extern void set_inline_threshold(int threshold);
+extern void set_cmov_threshold(int threshold);
 
 class Manager
 {
@@ -369,6 +381,72 @@ private:
      * @param node The node creating the string
      */
     int getStringSize(Node *node);
+
+    // AST SIMPLIFICATION
+
+    /**
+     * @brief Folds a unary operation on a constant, or drops one that does nothing (+x)
+     * @param operation Type checked unary operation node, without code
+     * @returns The node that takes the operation's place, or the operation itself
+     */
+    Node *simplifyUnop(Node *operation);
+
+    /**
+     * @brief Folds a binary operation on constants, applies identities (x + 0, x * 1,
+     * true && x) and annihilators (x * 0, false && x), and picks the branch of a
+     * ternary operation with a constant condition. Operands with function calls are
+     * never thrown away
+     * @param operation Type checked binary or ternary operation node, without code
+     * @returns The node that takes the operation's place, or the operation itself
+     */
+    Node *simplifyBinop(Node *operation);
+
+    /**
+     * @brief Replaces an operation node by one of its children, deleting the rest
+     * @param operation Operation node being replaced
+     * @param index     Index of the child that takes its place
+     * @returns Pointer to the child, with the operation's type
+     */
+    Node *replaceByChild(Node *operation, int index);
+
+    /**
+     * @brief Replaces a logic operation node by one of its operands, if that keeps
+     * its value: constants become boolean ones, logic and comparison operations are
+     * kept as they are, and any other operand (Which may be neither 0 nor 1) keeps
+     * the operation in place
+     * @param operation Logic operation node being replaced
+     * @param index     Index of the operand that decides its value
+     * @returns The node that takes the operation's place, or the operation itself
+     */
+    Node *replaceByLogicChild(Node *operation, int index);
+
+    /**
+     * @brief Checks if an expression is a logic or comparison operation, whose value
+     * is always 0 or 1
+     */
+    bool isLogicExpression(Node *node);
+
+    /**
+     * @brief Creates a node for a literal computed at compile time. Unlike the ones
+     * created by createLiteral, it is never declared in the symbol table
+     * @param value Literal value
+     * @param field Field used in the value union (As in Token)
+     * @param type  Node type
+     * @param line  Line where the folded expression occurs
+     * @returns Pointer to the node
+     */
+    Node *createConstant(Value value, int field, Type type, int line);
+
+    /**
+     * @brief Returns the value of a constant node (See Node::isConstant)
+     */
+    double getConstantValue(Node *node);
+
+    /**
+     * @brief Checks if evaluating an expression may do more than compute its value
+     * (Which is the case if it calls a function)
+     */
+    bool hasSideEffects(Node *node);
 };
 
 #endif
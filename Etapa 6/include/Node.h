@@ -13,6 +13,8 @@
 
 #include "Token.h"
 #include "Tac.h"
+#include "TacList.h"
+#include "Operand.h"
 #include "Type.h"
 #include "Manager.h"
 
@@ -40,14 +42,14 @@ public:
 
     bool lval; // Whether this node is an lval or not
 
-    Tac *code;         // TAC Code generated for this node
-    std::string *temp; // Name of the temporary register synthesized for this node
+    TacList code;  // TAC Code generated for this node
+    Operand *temp; // Temporary register synthesized for this node
 
     bool address; // Whether this node has an address in it's temporary register
     bool value;   // Whether this node has a value in it's temporary register
 
-    std::list<std::string *> true_list;  // List of instructions with holes to be patched in case of TRUE
-    std::list<std::string *> false_list; // List of instructions with holes to be patched in case of FALSE
+    std::list<Operand *> true_list;  // List of instructions with holes to be patched in case of TRUE
+    std::list<Operand *> false_list; // List of instructions with holes to be patched in case of FALSE
 
     /**
      * @brief Constructs a node based on provided data
@@ -59,7 +61,7 @@ public:
     Node(Token *lexval_, Type type_, Statement statement_, bool lval_ = true);
 
     /**
-     * @brief Recursively deletes the tree that has this node has root
+     * @brief Deletes the tree that has this node as root
      */
     ~Node();
 
@@ -92,10 +94,16 @@ public:
     std::string exportAllEdges();
 
     /**
-     * @brief Exports this node's code as a string
-     * @returns String containing exported code
+     * @brief Returns every node in the tree rooted at this one, in pre-order:
+     * a node, its children from left to right, its next element and then its next command
      */
-    std::string exportCode();
+    std::vector<Node *> getSubtree();
+
+    /**
+     * @brief Exports this node's code
+     * @param out Where to
+     */
+    void exportCode(Writer &out);
 
     // SETTERS
 
@@ -131,7 +139,19 @@ public:
     /**
      * @brief Sets this node's temporary register 
      */
-    void setTemp(std::string *temp);
+    void setTemp(Operand *temp);
+
+    /**
+     * @brief Replaces this node's code with the given one, which it takes over
+     */
+    void setCode(TacList code);
+
+    /**
+     * @brief Unlinks the indexed child from this node, so that it survives it
+     * @param index Child index [0- n]
+     * @returns Pointer to the child
+     */
+    Node *removeChild(int index);
 
     /**
      * @brief Generate intermediate code for this node
@@ -205,12 +225,35 @@ public:
     /**
      * @brief Returns the temporary register name created for this node
      */
-    std::string *getTemp();
+    Operand *getTemp();
+
+    /**
+     * @brief Returns the code for this node, which remains owned by it
+     */
+    TacList getCode();
+
+    /**
+     * @brief Hands this node's code over to the caller, which becomes
+     * responsible for it. No copy is made, the node is left without code
+     */
+    TacList takeCode();
+
+    /**
+     * @brief If this node is a literal with a numeric value known at compile time
+     * (Integers, floats, chars and bools, but not strings)
+     */
+    bool isConstant();
 
     /**
-     * @brief Returns A COPY of the code for this register 
+     * @brief If this node is a comparison, whose compare writes 1 or 0 to its temp
      */
-    Tac *getCode();
+    bool isComparison();
+
+    /**
+     * @brief Hands this node's code over to the caller to use its value, as takeCode does.
+     * Comparisons lose the branch on their result (Their true and false lists are left empty)
+     */
+    TacList takeValueCode();
 
     /**
      * @brief If this node has an address
@@ -225,12 +268,12 @@ public:
     /**
      * @brief Returns this node's true list 
      */
-    std::list<std::string *> getTrueList();
+    std::list<Operand *> getTrueList();
 
     /**
      * @brief Returns this node's false list 
      */
-    std::list<std::string *> getFalseList();
+    std::list<Operand *> getFalseList();
 
     /**
      * @brief CLeras this node's true list 
@@ -249,121 +292,155 @@ private:
      * @brief Creates TAC sequence for accessing a variable
      * and sets the node's temp to the variable address 
      */
-    Tac *generateLvalVariableTAC();
+    TacList generateLvalVariableTAC();
 
     /**
      * @brief Creates a TAC sequence for acessing the value of a variable
      * and sets the node's temp to the variable value
      */
-    Tac *generateRvalVariableTAC();
+    TacList generateRvalVariableTAC();
+
+    /**
+     * @brief Creates a TAC sequence for loading a literal value
+     * and sets the node's temp to the value
+     */
+    TacList generateLiteralTAC();
 
     /**
      * @brief Creates a TAC sequence for accessing a vector and
      * sets the node's temp to the indexed element's address
      */
-    Tac *generateLvalVectorTAC();
+    TacList generateLvalVectorTAC();
 
     /**
      * @brief Creates a TAC sequence for accesing a vector in a given index,
      * and sets the node's temp to the value of the element at that index 
      */
-    Tac *generateRvalVectorTAC();
+    TacList generateRvalVectorTAC();
 
     /**
      * @brief Creates a TAC sequence for a variable initialization operation 
      */
-    Tac *generateInitializationTAC();
+    TacList generateInitializationTAC();
 
     /**
      * @brief Creates a TAC sequence for an attribution operation
      */
-    Tac *generateAttributionTAC();
+    TacList generateAttributionTAC();
 
     /**
      * @brief Creates a TAC sequence for a unary opration
      * @param op String with the operator 
      */
-    Tac *generateUnopTAC(std::string op);
+    TacList generateUnopTAC(std::string op);
 
     /**
      * @brief Creates a TAC for binary operations
      * @param op String with the operator
      */
-    Tac *generateBinopTAC(std::string op);
+    TacList generateBinopTAC(std::string op);
 
     /**
      * @brief Creates a TAC for a binary arithmetic operation
      * @param op ILOC opcode for the operation 
      */
-    Tac *generateArithmeticBinopTAC(ILOCop op);
+    TacList generateArithmeticBinopTAC(ILOCop op);
+
+    /**
+     * @brief Creates a TAC for a modulo operation (What is left of a division)
+     */
+    TacList generateModuloTAC();
+
+    /**
+     * @brief Creates a TAC for an exponentiation, by squaring (Unrolled if the
+     * exponent is a literal, a loop otherwise)
+     */
+    TacList generatePowerTAC();
 
     /**
      * @brief Creates a TAC for an AND logic expression 
      */
-    Tac *generateAndTAC();
+    TacList generateAndTAC();
 
     /**
      * @brief Creates a TAC for an OR logic expression 
      */
-    Tac *generateOrTAC();
+    TacList generateOrTAC();
 
     /**
      * @brief Creates a TAC for a comparison logic expression
      * @param op Comparison operation
      */
-    Tac *generateComparisonTAC(ILOCop op);
+    TacList generateComparisonTAC(ILOCop op);
 
     /**
      * @brief Creates a TAC for a binary logic operation
      * @param op String with the operator
      */
-    Tac *generateLogicBinopTAC(ILOCop op);
+    TacList generateLogicBinopTAC(ILOCop op);
 
     /**
      * @brief Creates a TAC for a ternary operation 
      */
-    Tac *generateTernopTAC();
+    TacList generateTernopTAC();
+
+    /**
+     * @brief Labels the first instruction of a statement, or a nop added before it if
+     * it already has a label of its own
+     * @param code        Code the statement is in
+     * @param instruction First instruction of the statement
+     * @param label       The label
+     */
+    static void labelInstruction(TacList &code, Tac *instruction, Operand *label);
 
     /**
      * @brief Creates a TAC sequence for an IF statement (no else)
      */
-    Tac *generateIfTAC();
+    TacList generateIfTAC();
 
     /**
      * @brief Creates a TAC sequence for an IF-ELSE statement 
      */
-    Tac *generateIfElseTAC();
+    TacList generateIfElseTAC();
 
     /**
      * @brief Creates a TAC sequence for a FOR statement 
      */
-    Tac *generateForTAC();
+    TacList generateForTAC();
 
     /**
      *@brief Creates a TAC sequence for a WHILE statement 
      */
-    Tac *generateWhileTAC();
+    TacList generateWhileTAC();
 
     /**
      * @brief Creates a TAC sequence for a SHIFT statement
      * @param op Operation code (shift left or right) 
      */
-    Tac *generateShiftTAC(ILOCop op);
+    TacList generateShiftTAC(ILOCop op);
 
     /**
      * @brief Creates a TAC sequence for a function declaration
      */
-    Tac *generateFunctionDeclarationTAC();
+    TacList generateFunctionDeclarationTAC();
 
     /**
-     * @brief Creates a TAC sequence for a function call 
+     * @brief Creates a TAC sequence for a function call (Every argument is calculated
+     * before the frame is written, so that calls in them do not overwrite it)
      */
-    Tac *generateFunctionCallTAC();
+    TacList generateFunctionCallTAC();
 
     /**
      * @brief Creates a TAC sequence for a return statement 
      */
-    Tac *generateReturnTAC();
+    TacList generateReturnTAC();
+
+    /**
+     * @brief Creates a TAC sequence for a return statement of a call, which jumps to the
+     * called function instead (Back to the start of the body, if it is the function itself,
+     * or with the frame freed, if the function returns its value to where this one's would go)
+     */
+    TacList generateTailCallTAC();
 
 public:
     /**
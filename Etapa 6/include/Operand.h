@@ -0,0 +1,115 @@
+/**
+ * This file contains the Operand class, used for representing the arguments of
+ * the intermediate code instructions. Each operand is a kind tag and a number:
+ *
+ *  Register  | Dense identifier within its function, and the number used in its name
+ *  Immediate | The constant's value
+ *  Label     | The label's number
+ *  Hole      | The hole's number, until it is patched into a label
+ *  Base      | Which of the special registers (rfp, rsp, rbss, rpc) it is
+ *
+ * Operands are interned: there is a single object for each register, label and
+ * special register, and for each immediate value within a code arena. So operands
+ * can be compared by their address, and registers can index plain arrays.
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef OPERAND_H
+#define OPERAND_H
+
+#include "Type.h"
+#include "Writer.h"
+
+#include <string>
+
+class Operand
+{
+private:
+    static Operand bases[]; // The special registers
+
+    OperandKind kind; // What this operand is
+
+    int value;  // Register id, immediate value, label/hole number or special register
+    int number; // Number used in the register's name
+
+public:
+    /**
+     * @brief Returns the operand for a special register
+     * @param base The special register
+     */
+    static Operand *getBase(Base base);
+
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Class constructor
+     * @param kind_   What the operand is
+     * @param value_  Register id, immediate value, label/hole number or special register
+     * @param number_ Number used in the register's name, unused for other kinds
+     */
+    Operand(OperandKind kind_, int value_, int number_ = 0);
+
+    /**
+     * @brief Class destructor
+     */
+    ~Operand();
+
+    // GETTERS
+
+    /**
+     * @brief Returns what kind of operand this is
+     */
+    OperandKind getKind();
+
+    /**
+     * @brief Returns the operand's register id, immediate value, label/hole number
+     * or special register
+     */
+    int getValue();
+
+    // CHECKERS
+
+    /**
+     * @brief If this operand is a temporary register
+     */
+    bool isRegister();
+
+    /**
+     * @brief If this operand is an immediate value
+     */
+    bool isImmediate();
+
+    /**
+     * @brief If this operand is a label
+     */
+    bool isLabel();
+
+    /**
+     * @brief If this operand is the given special register
+     * @param base The special register
+     */
+    bool isBase(Base base);
+
+    // SETTERS
+
+    /**
+     * @brief Fills this hole with the given label
+     * @param label Label the hole now refers to
+     */
+    void patch(Operand *label);
+
+    // EXPORT
+
+    /**
+     * @brief Returns this operand's name in ILOC code
+     */
+    std::string toString();
+
+    /**
+     * @brief Outputs this operand's name in ILOC code
+     * @param out Where to
+     */
+    void write(Writer &out);
+};
+
+#endif // OPERAND_H
@@ -0,0 +1,64 @@
+/**
+ * This file contains the Optimizer class, which runs the machine independent
+ * optimizations over the TAC of each function, right after its code is generated
+ * and before it is linked to the rest of the program (Its labels and registers are
+ * still its own). Functions that were already optimized are kept for inlining into
+ * the ones after them (See Inliner).
+ *
+ * In the ILOC output, calls save the address to return to as an offset from the
+ * instruction that calculates it (addI rpc), which counts the instructions up to
+ * the call (The stores of the arguments and the frame). The offsets are
+ * recalculated after the passes, in case any of them changed that. The x86
+ * output drops that instruction, since call pushes the return address and ret
+ * jumps back to it (See ASM).
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include "TacList.h"
+#include "Symbol.h"
+#include "ValueNumbering.h"
+#include "DeadCode.h"
+#include "CopyPropagation.h"
+#include "StrengthReduction.h"
+#include "LoopInvariant.h"
+#include "Inliner.h"
+
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+class Optimizer
+{
+private:
+    static bool output_stats; // Whether what each pass did is written to stderr
+
+    /**
+     * @brief Recalculates the offset from rpc each call in a function's ILOC code
+     * returns to (The x86 output uses call and ret instead)
+     */
+    static void updateReturnAddresses(TacList &code);
+
+public:
+    // SETTERS
+
+    /**
+     * @brief Sets whether what each pass did is written to stderr
+     */
+    static void setOutputStats(bool output_stats_);
+
+    // OPTIMIZATION
+
+    /**
+     * @brief Runs every pass over a function's code
+     * @param function The function
+     * @param code     Its code
+     * @returns The optimized code
+     */
+    static TacList optimizeFunction(Symbol *function, TacList code);
+};
+
+#endif // OPTIMIZER_H
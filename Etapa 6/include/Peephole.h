@@ -0,0 +1,118 @@
+/**
+ * This file contains the Peephole class, which cleans up the x86_64 code of a
+ * function after it is translated from TAC one instruction at a time. It slides
+ * a window of up to three instructions over the code (Comments are skipped, but
+ * a label ends the window, since other code may jump there) and rewrites the ones
+ * matching a rule (See PeepholeRule):
+ *
+ *  - Moves that copy a value back to where it came from are removed, and loads
+ *    of a value that was just stored take it from the stored register instead
+ *  - Values computed in %rax and moved out right after are computed in place
+ *    (%rax is only a scratch register between instructions)
+ *  - Zeros are loaded with xor, and additions into a new register use lea
+ *  - Additions of zero, nops, jumps to the next instruction, code right after a
+ *    jump or return, labels nothing jumps to and labels right after another label
+ *    are removed, and conditional jumps over a jmp take its place
+ *
+ * Rules that remove or add instructions that write the condition flags are only
+ * applied if the flags are not read before being written again. The passes go on
+ * until no rule applies, and the times each rule was applied are counted.
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include <list>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <iterator>
+
+#include "Instruction.h"
+#include "Type.h"
+
+class Peephole
+{
+private:
+    typedef std::list<Instruction>::iterator Position;
+
+    std::vector<int> hits; // Times each rule was applied
+
+    /**
+     * @brief Counts a rule as applied
+     * @returns True, for convenience
+     */
+    bool hit(PeepholeRule rule);
+
+    /**
+     * @brief Returns the next machine instruction after a position, or the end of
+     * the code if there is a label before it
+     */
+    Position getNextOperation(std::list<Instruction> &code, Position position);
+
+    /**
+     * @brief If a label comes right after a position (Only comments and other
+     * labels between them), so that jumping there is the same as going on
+     */
+    bool isFollowedBy(std::list<Instruction> &code, Position position, std::string label);
+
+    /**
+     * @brief If the condition flags may be read after a position, before being
+     * written again (They are assumed to be read at labels and jumps)
+     */
+    bool areFlagsLive(std::list<Instruction> &code, Position position);
+
+    /**
+     * @brief Applies the first rule that matches the window starting at a machine
+     * instruction
+     * @param code     The function's code
+     * @param position The instruction, moved to the next one to look at if it is removed
+     * @returns True if a rule was applied
+     */
+    bool rewrite(std::list<Instruction> &code, Position &position);
+
+    /**
+     * @brief Removes labels nothing jumps to, and labels right after another
+     * label (Jumps to them go to that one instead)
+     * @returns True if a label was removed
+     */
+    bool foldLabels(std::list<Instruction> &code);
+
+public:
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Creates an optimizer without any rule applied
+     */
+    Peephole();
+
+    /**
+     * @brief Class destructor
+     */
+    ~Peephole();
+
+    // GETTERS
+
+    /**
+     * @brief Returns the times a rule was applied
+     */
+    int getHits(PeepholeRule rule);
+
+    /**
+     * @brief Returns the times each rule was applied, in a single line
+     */
+    std::string getStats();
+
+    // COMPILER LOGIC
+
+    /**
+     * @brief Rewrites a function's code until no rule applies
+     * @param code The function's code
+     */
+    void optimize(std::list<Instruction> &code);
+};
+
+#endif // PEEPHOLE_H
@@ -0,0 +1,76 @@
+/**
+ * This file contains the StrengthReduction class, which replaces multiplications and
+ * divisions of a function by a constant with cheaper instructions (Copy propagation
+ * leaves every operation with a constant operand in its form with an immediate):
+ *
+ *  multI r1, 0   => loadI 0
+ *  multI r1, 1   => i2i r1         | As does divI r1, 1
+ *  multI r1, -1  => rsubI r1, 0    | As does divI r1, -1
+ *  multI r1, 2^k => lshiftI r1, k
+ *  divI  r1, 2^k => rshiftI r1, 31   => t1  | -1 for negative numbers, 0 otherwise
+ *                   andI    t1, 2^k-1 => t2 | Which are rounded towards zero, so 2^k-1
+ *                   add     r1, t2    => t3 | is added to them before shifting
+ *                   rshiftI t3, k     => r3
+ *
+ * Division by other constants is left to the ASM generator, which multiplies by the
+ * divisor's reciprocal instead, since ILOC has no instruction for the upper half of
+ * a product.
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef STRENGTHREDUCTION_H
+#define STRENGTHREDUCTION_H
+
+#include "TacList.h"
+#include "Operand.h"
+#include "Type.h"
+
+// Forward declare Tac
+class Tac;
+
+class StrengthReduction
+{
+private:
+    TacList *code; // Function's code
+    int reduced;   // Operations replaced
+
+    /**
+     * @brief Returns k if a value is 2^k (k > 0), or -1 if it is not a power of two
+     */
+    static int getPowerOfTwo(int value);
+
+    /**
+     * @brief Replaces a multiplication by a constant, if it can be
+     * @returns True if it was replaced
+     */
+    bool reduceMultiplication(Tac *instruction);
+
+    /**
+     * @brief Replaces a division by a constant, if it can be
+     * @returns True if it was replaced
+     */
+    bool reduceDivision(Tac *instruction);
+
+public:
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Reduces the operations in a function
+     * @param code_ The function's code
+     */
+    StrengthReduction(TacList &code_);
+
+    /**
+     * @brief Class destructor
+     */
+    ~StrengthReduction();
+
+    // GETTERS
+
+    /**
+     * @brief Returns the amount of operations replaced
+     */
+    int getReducedCount();
+};
+
+#endif // STRENGTHREDUCTION_H
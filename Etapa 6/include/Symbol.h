@@ -10,10 +10,15 @@
 
 #include "Type.h"
 #include "Token.h"
+#include "TacList.h"
 
 #include <vector>
 #include <sstream>
 
+// Forward declare TacArena and Operand
+class TacArena;
+class Operand;
+
 class Symbol
 {
 
@@ -26,7 +31,10 @@ private:
     Type type;     // Symbol type
     Nature nature; // Symbol nature
 
-    std::string *label;           // Label given to the first instruction in this function
+    Operand *label;               // Label given to the first instruction in this function
+    Operand *body_label;          // Label given to its body, after the parameters are loaded (Where tail calls to itself go)
+    TacArena *arena;              // Arena holding this function's code
+    TacList code;                 // This function's code, from its first to its last instruction
     std::vector<Symbol *> params; // List of parameters if this symbol is a function
 
     Token *data; // Symbol token data
@@ -106,7 +114,25 @@ public:
      * @brief Gives a new label to this function, which points to it's code segment startint poirnt 
      * @param label The label being given
      */
-    void giveLabel(std::string *label);
+    void giveLabel(Operand *label);
+
+    /**
+     * @brief Gives a label to the start of this function's body, right after its parameters are loaded
+     * @param body_label The label being given
+     */
+    void giveBodyLabel(Operand *body_label);
+
+    /**
+     * @brief Gives this function the arena where its code is placed
+     * @param arena The function's code arena
+     */
+    void giveArena(TacArena *arena);
+
+    /**
+     * @brief Gives this function its code, once it has been generated
+     * @param code The function's instructions
+     */
+    void giveCode(TacList code);
 
     // GETTERS
 
@@ -128,7 +154,10 @@ public:
 
     bool isGlobal();
 
-    std::string *getLabel();
+    Operand *getLabel();
+    Operand *getBodyLabel();
+    TacArena *getArena();
+    TacList getCode();
 
     Token *getValue();
 };
@@ -17,6 +17,9 @@
 
 #include "Type.h"
 #include "ASM.h"
+#include "TacArena.h"
+#include "Operand.h"
+#include "Writer.h"
 
 #include <iostream>
 #include <string>
@@ -35,71 +38,69 @@ private:
     static uint label_count;    // Number of temporary labels used
     static uint hole_count;     // Number of label holes used
 
-    // List containing a reference to every name that was generated (Registers, labels and patched holes)
-    static std::list<std::string *> used_names;
-
     ILOCop opcode; // TAC Operation code
 
-    std::string *arg1; // First argument
-    std::string *arg2; // Second argument
-    std::string *arg3; // Third argument
+    Operand *arg1; // First argument
+    Operand *arg2; // Second argument
+    Operand *arg3; // Third argument
 
-    std::string *label; // Label for this instruction, if there is one
+    Operand *label; // Label for this instruction, if there is one
 
     // Double linked list
     Tac *next; // Next instruction
     Tac *prev; // Previous instruction
 
-    // Live variables in this instruciton
-    std::vector<std::string *> live_in;
-    std::vector<std::string *> live_out;
-
-    bool starts_return; // If this instruction starts a return command
-
 public:
     /**
-     * @brief Creates a new register name for usage with temporary variables
-     * @returns A new register name, previously unused
+     * @brief Creates a new register for usage with temporary variables
+     * @returns A new register, previously unused
      */
-    static std::string *newRegister();
+    static Operand *newRegister();
 
     /**
-     * @brief Creates a new label name for usage with jumps
-     * @returns A new label name, previously unused 
+     * @brief Creates a new label for usage with jumps
+     * @returns A new label, previously unused 
      */
-    static std::string *newLabel();
+    static Operand *newLabel();
 
     /**
      * @brief Creates a new "hole" for a label, to be filled by a later expression
-     * @returns A new hole name, previously unused 
+     * @returns A new hole, previously unused 
      */
-    static std::string *newHole();
+    static Operand *newHole();
 
     /**
-     * @brief Returns the appropriate register name given the variable global status
+     * @brief Returns the appropriate base register given the variable global status
      * @param global If the symbol being addressed is local or global
-     * @returns "rbss" or "rfp", base on given global status 
+     * @returns rbss or rfp, base on given global status 
      */
-    static std::string *getRegister(int global);
+    static Operand *getRegister(int global);
 
     /**
-     * @brief Returns a new string that was saved in the global name list, used for literal values
-     * @param literal The literal that should be kept track of
-     * @returns String with the literal 
+     * @brief Returns the immediate operand for a constant, kept in the active code arena
+     * @param value The constant's value
+     * @returns Immediate operand with that value
      */
-    static std::string *getName(std::string literal);
+    static Operand *getImmediate(int value);
 
     /**
      * @brief Patches a list of holes with the given label
      * @param holes List of holes to be patched
      * @param label Label to be given to those holes
      */
-    static void patch(std::list<std::string *> holes, std::string *label);
+    static void patch(std::list<Operand *> holes, Operand *label);
+
+    // ALLOCATION
+
+    /**
+     * @brief Places new instructions in the active code arena 
+     */
+    static void *operator new(size_t size);
 
     /**
-     * @brief Frees all the memory used for the labels and names that were generated 
+     * @brief Does nothing, instructions are freed along with their arena 
      */
-    static void freeNames();
+    static void operator delete(void *instruction);
 
     // CONSTRUCTOR AND DESTRUCTOR
 
@@ -110,7 +111,7 @@ public:
      * @param arg2_   Second argument, none by default
      * @param arg3_   Third argument, none by default
      */
-    Tac(ILOCop opcode_, std::string *arg1_ = NULL, std::string *arg2_ = NULL, std::string *arg3_ = NULL);
+    Tac(ILOCop opcode_, Operand *arg1_ = NULL, Operand *arg2_ = NULL, Operand *arg3_ = NULL);
 
     /**
      * @brief Copy constructor
@@ -126,26 +127,20 @@ public:
     // GETTERS
 
     /**
-     * @brief Returns a string containing the entire instruction chain
-     * that follows this one, inclusive, one instruction per line:
+     * @brief Outputs the entire instruction chain that follows this one,
+     * inclusive, one instruction per line:
      * 
      *  opcode arg1, arg2 => arg3;
      *  opcode arg1, arg2 => arg3;
      *  ...
-     * @returns String containig the ILOC code
+     * @param out Where to
      */
-    std::string getCodeString();
+    void writeCode(Writer &out);
 
     /**
      * @brief Retruns this instruction's label, if there is one  
      */
-    std::string *getLabel();
-
-    /**
-     * @brief Retruns the total amount of instructions in the code chain starting
-     * on this instruction 
-     */
-    int getCodeSize();
+    Operand *getLabel();
 
     /**
      * @brief Returns operation code for this instruction 
@@ -166,62 +161,54 @@ public:
      * @brief Returns the selected argument
      * @param index Selected arg 
      */
-    std::string *getArgument(int index);
+    Operand *getArgument(int index);
 
     /**
-     * @brief If this instruction starts a return command 
+     * @brief If this instruction jumps to a function in place of returning, its frame
+     * freed right before (i2i rfp => rsp), so that function returns to this one's caller
      */
-    bool startsReturn();
+    bool isTailCall();
 
     /**
      * @brief Retruns a list with this instruction's used 
      * variables 
      */
-    std::list<std::string *> getVariables();
-
-    // SETTERS
+    std::list<Operand *> getVariables();
 
     /**
-     * @brief Sets this instruction's label to the given one 
+     * @brief Returns the temporary register written by this instruction,
+     * or NULL if it does not write one 
      */
-    void setLabel(std::string *label);
+    Operand *getDefinition();
 
     /**
-     *  @brief Sets this instruction as starting a return sequence
+     * @brief Returns the temporary registers read by this instruction 
      */
-    void setReturn();
-
-    // TEMPORARY VARIABLE LIVENESS
+    std::list<Operand *> getUses();
 
-    /**
-     * @brief Adds a new variable to this TAC's live-in list
-     * @param temp Temporary variable's name
-     */
-    void addLiveIn(std::string *temp);
-
-    /**
-     * @brief Adds a new variable to this TAC's live-out list 
-     * @param temp Temporary variable's name
-     */
-    void addLiveOut(std::string *temp);
+    // SETTERS
 
     /**
-     * @brief Removes a variable from this TAC's live-in list
-     * @param temp Temporary variable's name 
+     * @brief Sets this instruction's label to the given one 
      */
-    void removeLiveIn(std::string *temp);
+    void setLabel(Operand *label);
 
     /**
-     * @brief Removes a variable from this TAC's live-out list
-     * @param temp Temporary variable's name 
+     * @brief Replaces every argument that is the given operand by another one
+     * @param old_operand The operand being replaced
+     * @param new_operand Its replacement
      */
-    void removeLiveOut(std::string *temp);
+    void replace(Operand *old_operand, Operand *new_operand);
 
     /**
-     * @brief Returns the variables that are 'live' during this 
-     * instruction 
+     * @brief Turns this instruction into another one, keeping its label and its
+     * place in the code
+     * @param opcode_ New operation code
+     * @param arg1_   New first argument
+     * @param arg2_   New second argument
+     * @param arg3_   New third argument
      */
-    std::vector<std::string *> getLive();
+    void rewrite(ILOCop opcode_, Operand *arg1_, Operand *arg2_ = NULL, Operand *arg3_ = NULL);
 
     // INSTRUCTION LIST LOGIC
 
@@ -238,10 +225,16 @@ public:
     void addAfter(Tac *instruction);
 
     /**
-     * @brief Adds another instruction at the end of
-     * the instruction chain starting with this one
+     * @brief Splits the instruction chain right before this instruction,
+     * which becomes the first one in its own chain
      */
-    void addLast(Tac *instruction);
+    void splitBefore();
+
+    /**
+     * @brief Takes this instruction out of its chain, linking the instructions
+     * before and after it together (It stays in its code arena)
+     */
+    void unlink();
 
     // EXPORT
 
@@ -250,6 +243,12 @@ public:
      * @returns a string containing this operation in ILOC standard format 
      */
     std::string toString();
+
+    /**
+     * @brief Outputs this instruction in ILOC standard format
+     * @param out Where to
+     */
+    void write(Writer &out);
 };
 
 #endif
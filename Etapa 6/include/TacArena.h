@@ -0,0 +1,119 @@
+/**
+ * This file contains the TacArena class, which stores the instructions and
+ * operands (registers, immediates, holes) generated for a function's code. Instructions
+ * are placed contiguously in fixed size blocks, and everything is freed in bulk
+ * once the function's code is no longer needed (After it has been emitted).
+ *
+ * Code generated outside of any function (Program start) and the labels, which
+ * are referenced across functions, are kept in a global arena that lives until
+ * the end of the compilation.
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef TACARENA_H
+#define TACARENA_H
+
+#include "Type.h"
+#include "Operand.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <unordered_map>
+
+// Forward declare Tac
+class Tac;
+
+class TacArena
+{
+private:
+    static std::list<TacArena *> arenas; // Every arena created, freed at the end of the compilation
+    static TacArena *global;             // Arena for labels and code outside of functions
+    static TacArena *active;             // Arena new instructions and operands are placed in
+
+    std::vector<Tac *> blocks; // Blocks of contiguous instructions
+    int used;                  // Amount of instructions placed in the last block
+
+    std::deque<Operand> operands;                  // Operands used by the instructions in this arena
+    std::unordered_map<int, Operand *> immediates; // Immediate operand for each value, so they are shared
+    int register_count;                            // Number of registers created in this arena
+
+public:
+    // ARENA MANAGEMENT
+
+    /**
+     * @brief Returns the global arena, creating it if necessary
+     */
+    static TacArena *getGlobal();
+
+    /**
+     * @brief Returns the arena where new instructions and operands are being placed
+     */
+    static TacArena *getActive();
+
+    /**
+     * @brief Sets the arena where new instructions and operands will be placed
+     * @param arena The new active arena
+     */
+    static void setActive(TacArena *arena);
+
+    /**
+     * @brief Frees every arena that was created, including the global one
+     */
+    static void releaseAll();
+
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Creates an empty arena
+     */
+    TacArena();
+
+    /**
+     * @brief Class destructor, frees everything in the arena
+     */
+    ~TacArena();
+
+    // ALLOCATION
+
+    /**
+     * @brief Returns memory for a new instruction, placed right after the last one
+     */
+    void *allocate();
+
+    /**
+     * @brief Stores a new operand in the arena
+     * @param kind  What the operand is
+     * @param value Label or hole number
+     * @returns Pointer to the stored operand, valid until the arena is released
+     */
+    Operand *newOperand(OperandKind kind, int value);
+
+    /**
+     * @brief Creates a new register, identified by the next unused id in the arena
+     * @param number Number used in the register's name
+     * @returns Pointer to the new register, valid until the arena is released
+     */
+    Operand *newRegister(int number);
+
+    /**
+     * @brief Returns the immediate operand for the given value, creating it if necessary
+     * @param value The immediate value
+     */
+    Operand *getImmediate(int value);
+
+    /**
+     * @brief Returns how many registers were created in the arena. Their ids go
+     * from 0 up to (but not including) this number
+     */
+    int getRegisterCount();
+
+    /**
+     * @brief Destroys every instruction and operand in the arena at once. The arena
+     * can still be used afterwards
+     */
+    void release();
+};
+
+#endif // TACARENA_H
@@ -0,0 +1,106 @@
+/**
+ * This file contains the TacList class, a handle to a sequence of instructions
+ * linked together through their next/prev pointers. It keeps track of the first
+ * and last instructions and of the sequence length, so that appending, prepending
+ * and concatenating code are constant time operations.
+ *
+ * A TacList does not own its instructions, they belong to the code arena they
+ * were placed in (See TacArena). Copies of a handle refer to the same instructions.
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef TACLIST_H
+#define TACLIST_H
+
+#include <string>
+
+// Forward declare Tac and Writer
+class Tac;
+class Writer;
+
+class TacList
+{
+private:
+    Tac *first; // First instruction in the sequence
+    Tac *last;  // Last instruction in the sequence
+
+    int size; // Amount of instructions in the sequence
+
+public:
+    // CONSTRUCTORS
+
+    /**
+     * @brief Creates an empty instruction sequence
+     */
+    TacList();
+
+    /**
+     * @brief Creates a sequence containing only the given instruction
+     * @param instruction First instruction, empty sequence if NULL
+     */
+    TacList(Tac *instruction);
+
+    // GETTERS
+
+    /**
+     * @brief Returns the first instruction in the sequence, or NULL if empty
+     */
+    Tac *getFirst();
+
+    /**
+     * @brief Returns the last instruction in the sequence, or NULL if empty
+     */
+    Tac *getLast();
+
+    /**
+     * @brief Returns the amount of instructions in the sequence
+     */
+    int getSize();
+
+    /**
+     * @brief If there are no instructions in the sequence
+     */
+    bool isEmpty();
+
+    /**
+     * @brief Outputs the ILOC code for the sequence, one instruction per line
+     * @param out Where to
+     */
+    void writeCode(Writer &out);
+
+    // INSTRUCTION LIST LOGIC
+
+    /**
+     * @brief Adds a single instruction at the end of the sequence
+     * @param instruction New instruction being added, ignored if NULL
+     */
+    void append(Tac *instruction);
+
+    /**
+     * @brief Adds a single instruction at the start of the sequence
+     * @param instruction New instruction being added, ignored if NULL
+     */
+    void prepend(Tac *instruction);
+
+    /**
+     * @brief Adds a single instruction before another one in the sequence
+     * @param position    Instruction in the sequence it goes before
+     * @param instruction New instruction being added, ignored if NULL
+     */
+    void insertBefore(Tac *position, Tac *instruction);
+
+    /**
+     * @brief Links another sequence at the end of this one. The given handle
+     * stays valid and still refers to its (now shared) instructions
+     * @param list Sequence being added, ignored if empty
+     */
+    void concatenate(TacList list);
+
+    /**
+     * @brief Takes an instruction out of the sequence (It stays in its code arena)
+     * @param instruction The instruction, which must be in the sequence
+     */
+    void remove(Tac *instruction);
+};
+
+#endif // TACLIST_H
@@ -90,6 +90,16 @@ public:
      * @brief Returns field used by this token 
      */
     int getField();
+
+    /**
+     * @brief Returns token value as an integer, for literals used in the generated code 
+     */
+    int getInteger();
+
+    /**
+     * @brief Returns token value as a float, for literals folded at compile time
+     */
+    float getFloating();
 };
 
 #endif
\ No newline at end of file
@@ -11,10 +11,17 @@
 
 #include <unordered_map>
 #include <string>
+#include <vector>
 
 #define SHIFT_MAX 16      // Max shift amount
 #define MAX_CHILDREN 5    // Maximum number of children in a node
 #define X86_64_REGCOUNT 8 // Number of general use registers available in x86_64 processor
+#define TAC_ARENA_BLOCK_SIZE 256 // Number of instructions in each block of a code arena
+#define GRAPH_MATRIX_MAX_VERTEXES 8192 // Biggest graph that keeps its edges in a bit-matrix
+#define SPILL_LOOP_WEIGHT 10 // How many times a reference inside a loop costs more than one outside
+#define WRITER_BUFFER_SIZE (1 << 20) // Bytes of output gathered before each write to a file
+#define VALUE_NUMBERING_WINDOW 1024 // Instructions of a block after which value numbering starts over
+#define X86_64_RED_ZONE 128 // Bytes below the stack pointer that a function may use without reserving them
 
 // Available language types
 typedef enum
@@ -109,7 +116,8 @@ typedef enum
     ILOC_STOREAI, // r1 => r2, c3 | Mem(r2 + c3) = r1
     ILOC_STOREAO, // r1 => r2, r3 | Mem(r2 + r3) = r1
     // Copy
-    ILOC_I2I, // r1 => r2 | r2 = r1
+    ILOC_I2I,  // r1     => r2 | r2 = r1
+    ILOC_CMOV, // cc, r2 => r3 | r3 = (cc == true)? r2 : r3 (Made by the x86_64 backend only, after the compare that sets cc)
     // Compares
     ILOC_CMP_LT, // r1, r2 => r3 | r3 = (r1 <  r2)? true : false
     ILOC_CMP_LE, // r1, r2 => r3 | r3 = (r1 <= r2)? true : false
@@ -124,6 +132,54 @@ typedef enum
 
 } ILOCop;
 
+// Kinds of operands used by the intermediate code instructions
+typedef enum
+{
+    OPERAND_REGISTER,  // A temporary register, such as 'r5'
+    OPERAND_IMMEDIATE, // An integer constant, such as '16'
+    OPERAND_LABEL,     // A label, such as 'L3'
+    OPERAND_HOLE,      // A label hole, to be patched with a label later on
+    OPERAND_BASE       // One of the special registers used as base addresses
+
+} OperandKind;
+
+// Special registers
+typedef enum
+{
+    BASE_RFP,  // Frame pointer
+    BASE_RSP,  // Stack pointer
+    BASE_RBSS, // Data segment start
+    BASE_RPC,  // Program counter
+    BASE_CC    // Condition codes, written by a compare only the branch right after it reads
+
+} Base;
+
+// Kinds of lines in the generated x86_64 code
+typedef enum
+{
+    INSTRUCTION_OPERATION, // A machine instruction, such as 'movq %r8, %r9'
+    INSTRUCTION_LABEL,     // A label definition, such as 'L3:'
+    INSTRUCTION_COMMENT    // A comment, such as the TAC an instruction was translated from
+
+} InstructionKind;
+
+// Rewriting rules of the peephole optimizer (See Peephole)
+typedef enum
+{
+    PEEPHOLE_REDUNDANT_MOVE,     // mov a, a | mov a, b; mov b, a                => (nothing) | mov a, b
+    PEEPHOLE_FORWARDED_LOAD,     // mov a, mem; mov mem, b                       => mov a, mem; mov a, b
+    PEEPHOLE_ACCUMULATOR,        // movq a, %rax; op b, %rax; movq %rax, c       => movq a, c; op b, c
+    PEEPHOLE_ZERO_IDIOM,         // mov $0, r                                    => xorl r, r
+    PEEPHOLE_LEA,                // movq a, c; addq b, c                         => leaq (a,b), c
+    PEEPHOLE_USELESS_ARITHMETIC, // addq $0, r | subq $0, r | imulq $1, r        => (nothing)
+    PEEPHOLE_JUMP_TO_NEXT,       // jmp L; L: | jcc L1; jmp L2; L1:              => L: | jncc L2; L1:
+    PEEPHOLE_UNREACHABLE,        // jmp L | ret; (code up to a label)            => jmp L | ret
+    PEEPHOLE_NOP,                // nop                                          => (nothing)
+    PEEPHOLE_LABEL,              // L1: L2: | L1: (Never jumped to)              => L1: | (nothing)
+    PEEPHOLE_RULE_COUNT          // Number of rules
+
+} PeepholeRule;
+
 // Binop codes based on token for arithmetic operations
 const std::unordered_map<std::string, ILOCop> arithmetic_binop_code = {
 
@@ -132,8 +188,8 @@ const std::unordered_map<std::string, ILOCop> arithmetic_binop_code = {
     {"-", ILOC_SUB},
     {"*", ILOC_MULT},
     {"/", ILOC_DIV},
-    {"%", ILOC_NOP}, // ?
-    {"^", ILOC_NOP}  // ?
+    {"%", ILOC_DIV}, // Followed by a multiplication and a subtraction (See Node::generateModuloTAC)
+    {"^", ILOC_MULT} // Repeated (See Node::generatePowerTAC)
 
 };
 
@@ -187,6 +243,7 @@ const std::unordered_map<ILOCop, std::string> opname = {
     {ILOC_STOREAI, "storeAI"},
     {ILOC_STOREAO, "storeAO"},
     {ILOC_I2I, "i2i"},
+    {ILOC_CMOV, "cmov"},
     {ILOC_CMP_LT, "cmp_LT"},
     {ILOC_CMP_LE, "cmp_LE"},
     {ILOC_CMP_EQ, "cmp_EQ"},
@@ -212,6 +269,34 @@ const std::unordered_map<ILOCop, std::string> x86_64_ASM = {
 
 };
 
+// Registers the first arguments of a call are passed in, in order (System V ABI)
+const std::vector<std::string> x86_64_argument_registers = {"%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9"};
+
+// Registers a function must give back as it found them, the others are lost across calls (System V ABI)
+const std::vector<std::string> x86_64_callee_saved_registers = {"%rbx", "%r12", "%r13", "%r14", "%r15"};
+
+// Registers given to a function that calls none, in order: the ones no caller keeps anything in first, the
+// argument registers once the prologue stored them, and the callee-saved ones last (%rax, %rcx and %rdx are scratch)
+const std::vector<std::string> x86_64_leaf_registers = {"%r8", "%r9", "%r10", "%r11", "%rdi", "%rsi", "%r12", "%r13"};
+
+// Condition each comparison tests, as the suffix of the x86_64 jumps and sets that read it (Signed)
+const std::unordered_map<ILOCop, std::string> x86_64_condition_codes = {
+    {ILOC_CMP_LT, "l"},
+    {ILOC_CMP_LE, "le"},
+    {ILOC_CMP_EQ, "e"},
+    {ILOC_CMP_GE, "ge"},
+    {ILOC_CMP_GT, "g"},
+    {ILOC_CMP_NE, "ne"}};
+
+// Comparison that holds exactly when another one does not
+const std::unordered_map<ILOCop, ILOCop> inverse_comparisons = {
+    {ILOC_CMP_LT, ILOC_CMP_GE},
+    {ILOC_CMP_LE, ILOC_CMP_GT},
+    {ILOC_CMP_EQ, ILOC_CMP_NE},
+    {ILOC_CMP_GE, ILOC_CMP_LT},
+    {ILOC_CMP_GT, ILOC_CMP_LE},
+    {ILOC_CMP_NE, ILOC_CMP_EQ}};
+
 // UTILITY FUNCTIONS
 
 /**
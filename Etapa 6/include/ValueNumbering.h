@@ -0,0 +1,112 @@
+/**
+ * This file contains the ValueNumbering class, which removes redundant computations
+ * from each basic block of a function (Local value numbering). Walking a block in
+ * order, each value gets a number: operands read before being written get a new one,
+ * and each instruction's result gets the number of its expression,
+ *
+ *  (operation, number of the first operand, number of the second operand)
+ *
+ * so that instructions computing an expression already held in a register become
+ * a copy of that register instead (i2i). Copies and constants give their target
+ * the number of their source, so that equal values are found through them as well.
+ *
+ * Loads are numbered by their address, until a store may write it: addresses of
+ * variables (rfp/rbss plus an offset) only alias themselves, others (Vector
+ * positions) may alias any global. A store also makes the stored value the one
+ * loaded from its address afterwards. Calls and the stores of the calling sequence
+ * (storeAI) forget every load.
+ *
+ * The ASM generator folds the address calculation of a variable into the load or
+ * store right after it, so those are left alone, and an address calculated only for
+ * a load that becomes a copy is removed with it.
+ *
+ * Values held in a register are kept alive until they are reused, so numbering
+ * starts over every VALUE_NUMBERING_WINDOW instructions of a block, which keeps
+ * them from spanning huge blocks (And the register allocator fast).
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef VALUENUMBERING_H
+#define VALUENUMBERING_H
+
+#include "CFG.h"
+#include "TacList.h"
+#include "Operand.h"
+#include "Type.h"
+
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+// Forward declare Tac
+class Tac;
+
+class ValueNumbering
+{
+private:
+    TacList *code; // Function's code
+    int removed;   // Instructions turned into copies or removed
+
+    int next_number; // Number given to the next new value
+
+    std::unordered_map<Operand *, int> numbers;              // Number of the value each operand holds
+    std::map<std::tuple<ILOCop, int, int>, int> expressions; // Number of each expression computed
+    std::unordered_map<int, Operand *> holders;              // A register holding each value, if any
+    std::unordered_map<int, int> memory;                     // Number of the value loaded from each address
+    std::unordered_map<int, Operand *> locations;            // Base register of each variable address
+
+    /**
+     * @brief Returns the number of the value an operand holds, numbering it if needed
+     */
+    int getNumber(Operand *operand);
+
+    /**
+     * @brief Sets the value an operand holds after an instruction writes it
+     */
+    void setNumber(Operand *operand, int number);
+
+    /**
+     * @brief Returns a register that still holds a value, or NULL if none does
+     */
+    Operand *getHolder(int number);
+
+    /**
+     * @brief Forgets the loads a store to an address may change
+     * @param address Number of the address, -1 for every load
+     */
+    void killMemory(int address);
+
+    /**
+     * @brief Forgets every value numbered so far
+     */
+    void forget();
+
+    /**
+     * @brief Numbers the values in a block, rewriting redundant instructions
+     * @param block The block
+     */
+    void numberBlock(BasicBlock *block);
+
+public:
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Removes redundant computations from each block of a function
+     * @param code_ The function's code
+     */
+    ValueNumbering(TacList &code_);
+
+    /**
+     * @brief Class destructor
+     */
+    ~ValueNumbering();
+
+    // GETTERS
+
+    /**
+     * @brief Returns the amount of instructions turned into copies or removed
+     */
+    int getRemovedCount();
+};
+
+#endif // VALUENUMBERING_H
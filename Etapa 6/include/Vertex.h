@@ -5,6 +5,7 @@
 #include <string>
 
 #include "Color.h"
+#include "Operand.h"
 
 class Color;
 
@@ -13,11 +14,14 @@ class Vertex
 private:
     // Vertex unique identifier
     unsigned int id;
-    std::string *name;
+    Operand *reg; // Temporary register this vertex stands for
 
     // Color assigned to vertex
     unsigned int color;
 
+    // Estimated cost of keeping the register in memory instead
+    double cost;
+
     // Vertexes that are adjacent to vertex
     std::vector<unsigned int> adjacency_list;
 
@@ -25,7 +29,7 @@ public:
     /**
      * @brief Vertex constructor
      */
-    Vertex(std::string *name, unsigned int vertex_id = -1, unsigned int color_id = -1);
+    Vertex(Operand *reg, unsigned int vertex_id = -1, unsigned int color_id = -1, double spill_cost = 1);
 
     /**
      * @brief Class destructor 
@@ -36,12 +40,12 @@ public:
      * @brief Returns the adjacency list for this vertex 
      * @returns std::vector containing every vertex adjacent to this
      */
-    std::vector<unsigned int> getAdjacent();
+    std::vector<unsigned int> &getAdjacent();
 
     // SETTERS
 
     /**
-     * @brief Inserts a new vertex and adjacent
+     * @brief Inserts a new vertex as adjacent (The graph makes sure it is not there yet)
      */
     void setAdjacent(unsigned int vertex_id);
 
@@ -56,6 +60,11 @@ public:
      */
     void setColor(unsigned int color_id);
 
+    /**
+     * @brief Sets the cost of keeping this vertex's register in memory 
+     */
+    void setCost(double spill_cost);
+
     // GETTERS
 
     /**
@@ -64,22 +73,19 @@ public:
     unsigned int getColor();
 
     /**
-     * @brief Returns this vertex's identifier 
+     * @brief Returns the cost of keeping this vertex's register in memory 
      */
-    unsigned int getId();
+    double getCost();
 
     /**
-     * @brief Returns this verte'x's name 
+     * @brief Returns this vertex's identifier 
      */
-    std::string *getName();
-
-    // CHECKERS
+    unsigned int getId();
 
     /**
-     * @brief Checks if this vertex is adjacent to given vertex
-     * @param vertex_id
+     * @brief Returns the temporary register this vertex stands for 
      */
-    bool isAdjacentTo(unsigned int vertex_id);
+    Operand *getRegister();
 };
 
 #endif //VERTEX_H
@@ -0,0 +1,89 @@
+/**
+ * This file contains the Writer class, which gathers the compiler's output (The
+ * ILOC or x86_64 code) in a large buffer and writes it to a file descriptor in
+ * batches, instead of building the whole program in memory first. It can also
+ * append to a string instead, so that the same code formats single instructions
+ * for comments and debugging.
+ *
+ * Author: Fábio de Azevedo Gomes
+ */
+#ifndef WRITER_H
+#define WRITER_H
+
+#include "Type.h"
+
+#include <string>
+#include <cstring>
+#include <unistd.h>
+#include <errno.h>
+
+class Writer
+{
+private:
+    int fd;              // File descriptor written to, -1 if writing to a string
+    std::string *target; // String appended to, NULL if writing to a file
+    char *buffer;        // Output not yet written
+    size_t used;         // Bytes in the buffer
+    size_t capacity;     // Size of the buffer
+    size_t total;        // Bytes output so far, written or not
+
+    /**
+     * @brief Writes bytes to the file, in as many calls as it takes
+     */
+    void writeFile(const char *data, size_t length);
+
+public:
+    // CONSTRUCTOR AND DESTRUCTOR
+
+    /**
+     * @brief Creates a writer to a file
+     * @param fd_       File descriptor to write to, such as STDOUT_FILENO
+     * @param capacity_ Bytes gathered before each write
+     */
+    Writer(int fd_, size_t capacity_ = WRITER_BUFFER_SIZE);
+
+    /**
+     * @brief Creates a writer that appends to a string (Without any buffer)
+     * @param target_ The string
+     */
+    Writer(std::string &target_);
+
+    /**
+     * @brief Writers own their buffer, and are not copied
+     */
+    Writer(const Writer &) = delete;
+
+    /**
+     * @brief Class destructor, writes whatever is left in the buffer
+     */
+    ~Writer();
+
+    // GETTERS
+
+    /**
+     * @brief Returns the amount of bytes output so far
+     */
+    size_t getTotal();
+
+    // OUTPUT
+
+    /**
+     * @brief Outputs a sequence of bytes
+     * @param data   The bytes
+     * @param length How many
+     */
+    void write(const char *data, size_t length);
+
+    /**
+     * @brief Writes the buffered bytes to the file
+     */
+    void flush();
+
+    Writer &operator<<(const std::string &text);
+    Writer &operator<<(const char *text);
+    Writer &operator<<(char character);
+    Writer &operator<<(long long number);
+    Writer &operator<<(int number);
+};
+
+#endif // WRITER_H
@@ -1,40 +1,83 @@
 #include "ASM.h"
 
 Tac *ASM::ILOC_code = NULL;
-std::map<std::string *, Symbol *> ASM::functions;
+std::vector<Symbol *> ASM::functions;
 Symbol *ASM::current_function = NULL;
 int ASM::function_index = 0;
-std::map<std::string *, std::string> ASM::registers;
+std::vector<std::string> ASM::registers;
+bool ASM::output_stats = false;
+bool ASM::linear_scan = false;
+int ASM::spill_start = 0;
+int ASM::spill_slots = 0;
+int ASM::locals_size = 0;
+int ASM::frame_size = 0;
+bool ASM::force_frame_pointer = false;
+int ASM::cmov_threshold = 6;
+bool ASM::frame_omitted = false;
+std::unordered_map<std::string, int> ASM::save_slots;
+std::vector<std::string> ASM::callee_saved;
+std::unordered_map<Tac *, std::vector<std::string>> ASM::caller_saved;
+std::vector<Operand *> ASM::call_arguments;
+int ASM::outgoing_size = 0;
+std::list<Instruction> ASM::function_code;
+bool ASM::output_peephole_stats = false;
+bool ASM::output_tac_comments = true;
+
+void ASM::setOutputStats(bool output_stats_)
+{
+    ASM::output_stats = output_stats_;
+}
+
+void ASM::setLinearScan(bool linear_scan_)
+{
+    ASM::linear_scan = linear_scan_;
+}
+
+void ASM::setOutputPeepholeStats(bool output_peephole_stats_)
+{
+    ASM::output_peephole_stats = output_peephole_stats_;
+}
+
+void ASM::setOutputTacComments(bool output_tac_comments_)
+{
+    ASM::output_tac_comments = output_tac_comments_;
+}
 
-std::string ASM::generateASM(Tac *first)
+void ASM::setForceFramePointer(bool force_frame_pointer_)
 {
-    std::stringstream program;
+    ASM::force_frame_pointer = force_frame_pointer_;
+}
+
+void ASM::setCmovThreshold(int cmov_threshold_)
+{
+    ASM::cmov_threshold = cmov_threshold_;
+}
 
+void ASM::generateASM(Tac *first, Writer &out)
+{
     // Code starting point
     ASM::ILOC_code = first;
 
     // Generate data segment (Global vars, literals)
-    program << ASM::generateDataSegment() << std::endl;
+    ASM::generateDataSegment(out);
+    out << '\n';
 
     // Generate code segment (function declaration and code)
-    program << ASM::generateCodeSegment() << std::endl;
+    ASM::generateCodeSegment(out);
+    out << '\n';
 
     // Generate end segment (meta-info)
-    program << ASM::generateEndSegment();
-
-    // Return generated program
-    return program.str();
+    ASM::generateEndSegment(out);
 }
 
-std::string ASM::generateDataSegment()
+void ASM::generateDataSegment(Writer &out)
 {
     int literal;
-    std::stringstream data_segment;
 
     // Comments for legibility of generated ASM file
-    data_segment << "# =======================" << std::endl
-                 << "#  Start of Data Segment" << std::endl
-                 << "# =======================" << std::endl;
+    out << "# =======================\n"
+        << "#  Start of Data Segment\n"
+        << "# =======================\n";
 
     // Get global symbol table
     SymbolTable *global_symbol_table = Manager::getActiveSymbolTable();
@@ -50,7 +93,7 @@ std::string ASM::generateDataSegment()
               [](Symbol *e1, Symbol *e2) { return (e1->getAddress() < e2->getAddress()); });
 
     // Add starting text directive
-    data_segment << "  \t.text" << std::endl;
+    out << "  \t.text\n";
 
     // Iterate symbol table
     for (auto i = ordered_symbols.begin(); i != ordered_symbols.end(); ++i)
@@ -60,8 +103,8 @@ std::string ASM::generateDataSegment()
         case NAT_IDENTIFIER: // Global variable
         case NAT_VECTOR:     // Global vector
         {
-            // Add symbol name and size
-            data_segment << "\t.comm " << (*i)->getName() << "," << (*i)->getOccupiedSize() << std::endl;
+            // Add symbol name and size (Prefixed as where it is used, so it does not clash with the C library)
+            out << "\t.comm __" << (*i)->getName() << "," << (*i)->getOccupiedSize() << '\n';
         }
         break;
         case NAT_NONE: // Literals
@@ -70,14 +113,20 @@ std::string ASM::generateDataSegment()
             literal = (*i)->getValue()->getValue().integer;
 
             // 'Declare' literal
-            data_segment << "__" << (*i)->getName() << ":" << std::endl;
-            data_segment << "\t.long " << literal << "\t# Literal: " << (*i)->getName() << std::endl;
+            out << "__" << (*i)->getName() << ":\n";
+            out << "\t.long " << literal << "\t# Literal: " << (*i)->getName() << '\n';
         }
         break;
         case NAT_FUNCTION: // Functions
         {
-            // Save the <label,function> tuple for easier access during code generation
-            ASM::functions.insert(std::make_pair((*i)->getLabel(), *i));
+            // Save the function under its label's number for easier access during code generation
+            if ((*i)->getLabel() != NULL)
+            {
+                if ((unsigned int)(*i)->getLabel()->getValue() >= ASM::functions.size())
+                    ASM::functions.resize((*i)->getLabel()->getValue() + 1, NULL);
+
+                ASM::functions[(*i)->getLabel()->getValue()] = *i;
+            }
         }
         break;
         default: // Error
@@ -85,22 +134,18 @@ std::string ASM::generateDataSegment()
             break;
         }
     }
-
-    // Return generated data segment
-    return data_segment.str();
 }
 
-std::string ASM::generateCodeSegment()
+void ASM::generateCodeSegment(Writer &out)
 {
-    std::string *label = NULL;
+    Operand *label = NULL;
     Symbol *function = NULL;
-    std::stringstream code_segment;
     Tac *current = NULL;
 
     // Comments for legibility of generated ASM file
-    code_segment << "# =======================" << std::endl
-                 << "#  Start of Code Segment" << std::endl
-                 << "# =======================" << std::endl;
+    out << "# =======================\n"
+        << "#  Start of Code Segment\n"
+        << "# =======================\n";
 
     // DEBUG
     // SymbolTable *global = Manager::getActiveSymbolTable();
@@ -118,364 +163,1197 @@ std::string ASM::generateCodeSegment()
     for (current = current->getNext(); current != NULL; current = current->getNext())
     {
         // Get instruction label
-        if ((label = current->getLabel()) != NULL)
+        label = current->getLabel();
+
+        // Get function corresponding to label, if there is one
+        if ((function = ASM::getFunction(label)) != NULL)
         {
-            try
-            {
-                // Get function corresponding to label
-                function = functions.at(label);
+            // If ending a function's code segment
+            if (current_function != NULL)
+                ASM::generateFunctionEnd(current, out);
 
-                // If ending a function's code segment
-                if (current_function != NULL)
-                    code_segment << ASM::generateFunctionEnd(current);
+            // Update current function
+            current_function = function;
 
-                // Update current function
-                current_function = function;
+            // Generate function initial code
+            ASM::generateFunctionStart(current, out);
 
-                // Generate function initial code
-                code_segment << ASM::generateFunctionStart(current);
+            // Move past initialization instructions (Up to the local variables allocation)
+            for (; current->getOpcode() != ILOC_ADDI; current = current->getNext())
+                ;
+            current = current->getNext();
 
-                // Move past initialization instructions
-                for (; current->getPrev()->getOpcode() != ILOC_ADDI; current = current->getNext())
-                    ;
-            }
-            catch (const std::out_of_range &e)
+            // The body may start at a label too (Tail calls to the function itself jump there)
+            label = current->getLabel();
+        }
+
+        // If instruction has a label that does not start a function, add it
+        if (label != NULL && ASM::getFunction(label) == NULL)
+        {
+            ASM::function_code.push_back(Instruction(INSTRUCTION_LABEL, label->toString()));
+        }
+
+        // Transate instruction to x86 ASM
+        ASM::translateTac(current);
+
+        // Reset label
+        label = NULL;
+    }
+
+    // When done, insert end code for last function
+    ASM::generateFunctionEnd(current, out);
+}
+
+void ASM::generateEndSegment(Writer &out)
+{
+    // Comments for legibility of generated ASM file
+    out << "# =======================\n"
+        << "#           END \n"
+        << "# =======================\n";
+
+    // Code generation info
+    out << "\t.ident \"INF01147\"\n"
+        << "\t.section	.note.GNU-stack,\"\",@progbits";
+}
+
+//
+
+void ASM::generateFunctionStart(Tac *current, Writer &out)
+{
+    // Comments for legibility
+    out << '\n'
+        << "# =======================\n"
+        << "#  Start of function \"" << current_function->getName() << "\"\n"
+        << "# =======================\n";
+
+    // Add function start code
+    out << "\t.globl " << current_function->getName() << '\n'
+        << "\t.type  " << current_function->getName() << ", @function\n";
+
+    out << current_function->getName() << ":\n"
+        << ".LFB" << ASM::function_index << ":\n";
+
+    // Branch on the flags of the compares right before them
+    ASM::fuseComparisons();
+
+    // And select the value of short conditionals without branching
+    if (ASM::cmov_threshold > 0)
+        ASM::selectConditionalMoves();
+
+    // Split the function's code into basic blocks
+    CFG cfg(current_function->getCode());
+
+    // Generate a register allocation map
+    ASM::allocateRegisters(&cfg);
+
+    // And find the registers that must be kept across calls
+    ASM::findSavedRegisters();
+
+    // Bytes below the stack pointer the function's variables and stack slots reach
+    int stack_size = ASM::locals_size + 8 * (ASM::spill_slots + ASM::save_slots.size());
+
+    // Functions that call none need no frame if all of it fits in the red zone, where nothing else writes
+    ASM::frame_omitted = !ASM::force_frame_pointer && stack_size <= X86_64_RED_ZONE && ASM::isLeaf(current_function->getCode());
+
+    // The arguments passed in the stack go at its bottom, kept aligned to 16 bytes as calls expect
+    ASM::frame_size = (stack_size + ASM::outgoing_size + 15) / 16 * 16;
+
+    if (!ASM::frame_omitted)
+    {
+        out << "\tpushq \%rbp\n"
+            << "\tmovq \%rsp, \%rbp\n";
+
+        // Reserve the stack frame
+        if (ASM::frame_size > 0)
+            out << "\tsubq $" << ASM::frame_size << ", \%rsp\n";
+    }
+
+    for (auto i = ASM::callee_saved.begin(); i != ASM::callee_saved.end(); ++i)
+        ASM::function_code.push_back(Instruction("movq", {*i, ASM::getSlot(ASM::save_slots[*i])}));
+
+    // Keep each argument where its parameter is read from, the first ones come in registers and the rest above the return address
+    for (unsigned int i = 0; i < current_function->getParams().size(); ++i)
+    {
+        std::string slot = ASM::getSlot(3 * getSize(TYPE_INT) + i * getSize(TYPE_INT));
+
+        if (i < x86_64_argument_registers.size())
+            ASM::function_code.push_back(Instruction("movl", {Instruction::getLowRegister(x86_64_argument_registers[i]), slot}));
+        else
+        {
+            int offset = (ASM::frame_omitted ? 8 : 16) + 8 * (i - x86_64_argument_registers.size());
+
+            ASM::function_code.push_back(Instruction("movl", {std::to_string(offset) + "(" + ASM::translateArgument(Operand::getBase(BASE_RFP)) + ")", "\%eax"}));
+            ASM::function_code.push_back(Instruction("movl", {"\%eax", slot}));
+        }
+    }
+}
+
+void ASM::generateFunctionEnd(Tac *current, Writer &out)
+{
+    Peephole peephole;
+
+    // Clean up the function's code, now that all of it was translated
+    peephole.optimize(ASM::function_code);
+
+    if (ASM::output_peephole_stats)
+        std::cerr << "peephole " << current_function->getName() << ": " << peephole.getStats() << std::endl;
+
+    for (auto i = ASM::function_code.begin(); i != ASM::function_code.end(); ++i)
+    {
+        i->write(out);
+        out << '\n';
+    }
+
+    ASM::function_code.clear();
+
+    // Add function end code
+    out << '\n'
+        << ".LFE" << ASM::function_index << ":\n"
+        << "\t.size " << current_function->getName() << ", .-" << current_function->getName() << '\n';
+
+    ASM::function_index++;
+
+    // The function's code was emitted, separate it from the next function's and free it
+    if (current != NULL)
+        current->splitBefore();
+
+    if (current_function->getArena() != NULL)
+        current_function->getArena()->release();
+
+    // Register mapping referred to the freed code
+    ASM::registers.clear();
+}
+
+void ASM::findSavedRegisters()
+{
+    TacList code = ASM::current_function->getCode();
+    CFG cfg(code);
+    Liveness liveness(&cfg, ASM::current_function->getArena()->getRegisterCount());
+    int slot = ASM::locals_size + 8 * ASM::spill_slots; // Last slot given
+
+    ASM::save_slots.clear();
+    ASM::callee_saved.clear();
+    ASM::caller_saved.clear();
+    ASM::outgoing_size = 0;
+
+    for (auto i = ASM::registers.begin(); i != ASM::registers.end(); ++i)
+        if (std::find(x86_64_callee_saved_registers.begin(), x86_64_callee_saved_registers.end(), *i) != x86_64_callee_saved_registers.end() &&
+            !ASM::save_slots.count(*i))
+        {
+            ASM::save_slots[*i] = slot += 8;
+            ASM::callee_saved.push_back(*i);
+        }
+
+    for (int block = 0; block < cfg.getBlockCount(); ++block)
+    {
+        Tac *last = cfg.getBlock(block)->getLast();
+        Symbol *function = last->getOpcode() == ILOC_JUMPI ? ASM::getFunction(last->getArgument(0)) : NULL;
+
+        if (function == NULL || last->isTailCall())
+            continue;
+
+        // Whatever is read after the call
+        Bitset &live = liveness.getLiveOut(block);
+        std::vector<std::string> &saved = ASM::caller_saved[last];
+
+        for (int i = live.next(0); i < live.getSize(); i = live.next(i + 1))
+        {
+            std::string reg = (unsigned int)i < ASM::registers.size() ? ASM::registers[i] : "";
+
+            if (reg.empty() || std::find(saved.begin(), saved.end(), reg) != saved.end() ||
+                std::find(x86_64_callee_saved_registers.begin(), x86_64_callee_saved_registers.end(), reg) != x86_64_callee_saved_registers.end())
+                continue;
+
+            if (!ASM::save_slots.count(reg))
+                ASM::save_slots[reg] = slot += 8;
+
+            saved.push_back(reg);
+        }
+
+        int stacked = (int)function->getParams().size() - (int)x86_64_argument_registers.size();
+
+        if (8 * stacked > ASM::outgoing_size)
+            ASM::outgoing_size = 8 * stacked;
+    }
+}
+
+bool ASM::passesArgument(Tac *instruction)
+{
+    if (instruction->getOpcode() != ILOC_STOREAI || !instruction->getArgument(1)->isBase(BASE_RSP))
+        return false;
+
+    // Past the return address, previous rsp and rfp, and not one of those copied to the stack right away
+    int index = (instruction->getArgument(2)->getValue() - 3 * getSize(TYPE_INT)) / getSize(TYPE_INT);
+
+    return index >= 0 && index < (int)x86_64_argument_registers.size();
+}
+
+void ASM::moveInParallel(std::vector<std::pair<std::string, std::string>> moves)
+{
+    // Copies to itself are already done
+    moves.erase(std::remove_if(moves.begin(), moves.end(),
+                               [](std::pair<std::string, std::string> &move) { return move.first == move.second; }),
+                moves.end());
+
+    while (!moves.empty())
+    {
+        auto ready = moves.end(); // A move whose destination no other move reads
+
+        for (auto i = moves.begin(); i != moves.end() && ready == moves.end(); ++i)
+        {
+            ready = i;
+
+            for (auto j = moves.begin(); j != moves.end(); ++j)
+                if (j != i && j->first == i->second)
+                    ready = moves.end();
+        }
+
+        if (ready != moves.end())
+        {
+            ASM::function_code.push_back(Instruction("movq", {ready->first, ready->second}));
+            moves.erase(ready);
+        }
+        else
+        {
+            // Every destination is read by another move, keep one of them aside
+            std::string kept = moves.front().second;
+
+            ASM::function_code.push_back(Instruction("movq", {kept, "\%rax"}));
+
+            for (auto i = moves.begin(); i != moves.end(); ++i)
+                if (i->first == kept)
+                    i->first = "\%rax";
+        }
+    }
+}
+
+std::string ASM::getSlot(int offset)
+{
+    return "-" + std::to_string(offset) + "(" + ASM::translateArgument(Operand::getBase(BASE_RFP)) + ")";
+}
+
+void ASM::fuseComparisons()
+{
+    TacList code = ASM::current_function->getCode();
+    std::vector<int> reads(ASM::current_function->getArena()->getRegisterCount(), 0);
+    Operand *cc = Operand::getBase(BASE_CC);
+
+    // Count the times each register is read
+    for (Tac *i = code.getFirst(); i != code.getLast()->getNext(); i = i->getNext())
+    {
+        std::list<Operand *> uses = i->getUses();
+
+        for (auto use = uses.begin(); use != uses.end(); ++use)
+            reads[(*use)->getValue()]++;
+    }
+
+    for (Tac *i = code.getFirst(); i != code.getLast(); i = i->getNext())
+    {
+        Tac *branch = i->getNext();
+        Operand *result = i->getArgument(2);
+
+        // Compares used as values keep them, the branch tests the register then
+        if (i->getOpcode() < ILOC_CMP_LT || i->getOpcode() > ILOC_CMP_NE || branch->getOpcode() != ILOC_CBR ||
+            !branch->getArgument(0)->isRegister() || branch->getArgument(0)->getValue() != result->getValue() ||
+            reads[result->getValue()] != 1)
+            continue;
+
+        i->rewrite(i->getOpcode(), i->getArgument(0), i->getArgument(1), cc);           // cmp_XX r1, r2 => cc
+        branch->rewrite(ILOC_CBR, cc, branch->getArgument(1), branch->getArgument(2)); // cbr cc => l1, l2
+    }
+}
+
+void ASM::selectConditionalMoves()
+{
+    TacList code = ASM::current_function->getCode();
+    std::vector<int> references(ASM::current_function->getArena()->getRegisterCount(), 0);
+    std::unordered_map<int, int> jumps; // Branches to each label
+    Operand *cc = Operand::getBase(BASE_CC);
+    TacArena *previous_arena = TacArena::getActive();
+
+    // New registers go in the function's arena
+    TacArena::setActive(ASM::current_function->getArena());
+
+    // Count the times each register and label is referenced
+    for (Tac *i = code.getFirst(); i != code.getLast()->getNext(); i = i->getNext())
+    {
+        std::list<Operand *> variables = i->getVariables();
+
+        for (auto var = variables.begin(); var != variables.end(); ++var)
+            references[(*var)->getValue()]++;
+
+        if (i->getOpcode() == ILOC_CBR)
+        {
+            jumps[i->getArgument(1)->getValue()]++;
+            jumps[i->getArgument(2)->getValue()]++;
+        }
+        else if (i->getOpcode() == ILOC_JUMPI)
+            jumps[i->getArgument(0)->getValue()]++;
+    }
+
+    // Backwards, so that conditionals inside the sides of others are selected first
+    for (Tac *branch = code.getLast(); branch != code.getFirst(); )
+    {
+        Tac *compare = branch->getPrev();
+        Tac *previous = compare;
+        Tac *first[2] = {branch->getNext(), NULL}; // First and last instruction of each side, in code order
+        Tac *last[2] = {NULL, NULL};
+        Tac *jump = NULL;   // Jump over the second side
+        Tac *after = NULL;  // Where both sides meet
+        int size[2] = {0, 0};
+        bool valid = branch->getOpcode() == ILOC_CBR && branch->getArgument(0)->isBase(BASE_CC);
+
+        // cmp_XX r1, r2 => cc; cbr cc => l1, l2; l1: A...; jumpI => l3; l2: B...; l3:
+        for (int side = 0; valid && side < 2; ++side)
+        {
+            valid = first[side] != NULL && first[side]->getLabel() != NULL && jumps[first[side]->getLabel()->getValue()] > 0 &&
+                    (first[side]->getLabel()->getValue() == branch->getArgument(1)->getValue() ||
+                     first[side]->getLabel()->getValue() == branch->getArgument(2)->getValue());
+
+            for (Tac *i = first[side]; valid && i != code.getLast() && (i == first[side] || i->getLabel() == NULL); i = i->getNext())
             {
-                // Was not a function
+                // The first side jumps over the second, that falls through
+                if (side == 0 && i->getOpcode() == ILOC_JUMPI)
+                {
+                    jump = i;
+                    first[1] = i->getNext();
+                    break;
+                }
+
+                valid = ASM::isSpeculable(i);
+                last[side] = i;
+                size[side]++;
             }
+
+            valid = valid && last[side] != NULL;
+        }
+
+        if (valid)
+        {
+            after = last[1]->getNext();
+            valid = jump != NULL && ASM::getFunction(jump->getArgument(0)) == NULL && after->getLabel() != NULL &&
+                    after->getLabel()->getValue() == jump->getArgument(0)->getValue() &&
+                    first[0]->getLabel()->getValue() != first[1]->getLabel()->getValue() &&
+                    size[0] + size[1] <= ASM::cmov_threshold;
         }
 
-        // If instruction has label
-        if (label != NULL)
+        if (valid)
         {
-            try
+            Operand *target = last[0]->getDefinition();
+            bool swapped = first[0]->getLabel()->getValue() != branch->getArgument(1)->getValue(); // If the first side runs when the compare fails
+            ILOCop opcode = swapped ? inverse_comparisons.at(compare->getOpcode()) : compare->getOpcode();
+            Operand *value[2] = {last[0]->getArgument(0), last[1]->getArgument(0)};
+
+            // Both sides set the same register last
+            valid = target != NULL && last[1]->getDefinition() != NULL && last[1]->getDefinition()->getValue() == target->getValue();
+
+            if (valid && size[0] == 1 && size[1] == 1 && last[0]->getOpcode() == ILOC_LOADI && last[1]->getOpcode() == ILOC_LOADI &&
+                value[0]->getValue() + value[1]->getValue() == 1 && value[0]->getValue() * value[1]->getValue() == 0)
             {
-                functions.at(label);
+                // The sides set it to whether the compare holds or not: cmp_XX r1, r2 => r3
+                if (value[0]->getValue() == 0)
+                    opcode = inverse_comparisons.at(opcode);
+
+                compare->rewrite(opcode, compare->getArgument(0), compare->getArgument(1), target);
+                references[target->getValue()]++;
+
+                jumps[branch->getArgument(1)->getValue()]--;
+                jumps[branch->getArgument(2)->getValue()]--;
+                branch->unlink();
 
-                // Starts a function, omit
+                // Sides other branches also reach stay, only this one skips them now
+                if (jumps[first[1]->getLabel()->getValue()] == 0)
+                {
+                    references[target->getValue()]--;
+                    last[1]->unlink();
+                }
+
+                if (jumps[first[0]->getLabel()->getValue()] == 0)
+                {
+                    references[target->getValue()]--;
+                    jumps[jump->getArgument(0)->getValue()]--;
+                    last[0]->unlink();
+                    jump->unlink();
+                }
+
+                if (compare->getNext() != after)
+                {
+                    jumps[after->getLabel()->getValue()]++;
+                    compare->addAfter(new Tac(ILOC_JUMPI, after->getLabel())); // jumpI => l3
+                }
+
+                previous = compare->getPrev();
             }
-            catch (const std::out_of_range &e)
+            else if (valid && jumps[first[0]->getLabel()->getValue()] == 1 && jumps[first[1]->getLabel()->getValue()] == 1 &&
+                     last[0]->getOpcode() != ILOC_CMOV && last[1]->getOpcode() != ILOC_CMOV)
             {
-                // Does not start a function, add
-                code_segment << *label << ": " << std::endl;
+                // The register is only written last in each side, and what each side writes is read there only
+                for (int side = 0; valid && side < 2; ++side)
+                    for (Tac *i = first[side]; valid && i != last[side]->getNext(); i = i->getNext())
+                    {
+                        std::list<Operand *> uses = i->getUses();
+                        Operand *definition = i->getDefinition();
+                        int inside = 0;
+
+                        for (auto use = uses.begin(); valid && use != uses.end(); ++use)
+                            valid = (*use)->getValue() != target->getValue();
+
+                        valid = valid && (i == last[side] || definition == NULL || definition->getValue() != target->getValue());
+
+                        if (valid && definition != NULL && i != last[side])
+                        {
+                            for (Tac *j = first[side]; j != last[side]->getNext(); j = j->getNext())
+                            {
+                                std::list<Operand *> variables = j->getVariables();
+                                inside += std::count_if(variables.begin(), variables.end(), [&](Operand *var) { return var->getValue() == definition->getValue(); });
+                            }
+
+                            valid = inside == references[definition->getValue()];
+                        }
+                    }
+
+                valid = valid && compare->getArgument(0)->getValue() != target->getValue() && compare->getArgument(1)->getValue() != target->getValue();
+
+                if (valid)
+                {
+                    Operand *selected = Tac::newRegister(); // What the first side writes instead
+                    Operand *label = compare->getLabel();
+
+                    if ((unsigned int)selected->getValue() >= references.size())
+                        references.resize(selected->getValue() + 1, 0);
+
+                    references[selected->getValue()] = 2;
+                    last[0]->replace(target, selected);
+
+                    // A...; B...; cmp_XX r1, r2 => cc; cmov cc, s => r3
+                    jumps[jump->getArgument(0)->getValue()]--;
+                    branch->unlink();
+                    jump->unlink();
+                    first[0]->setLabel(label);
+                    first[1]->setLabel(NULL);
+                    compare->setLabel(NULL);
+
+                    compare->unlink();
+                    last[1]->addAfter(compare);
+                    compare->rewrite(opcode, compare->getArgument(0), compare->getArgument(1), cc);
+                    compare->addAfter(new Tac(ILOC_CMOV, cc, selected, target));
+
+                    // Conditionals around this one may take it in now
+                    if (jumps[after->getLabel()->getValue()] == 0)
+                        after->setLabel(NULL);
+
+                    previous = first[0]->getPrev();
+                }
             }
         }
 
-        // If instruction starts a return sequence
-        if (current->startsReturn())
+        branch = previous;
+    }
+
+    TacArena::setActive(previous_arena);
+}
+
+bool ASM::isSpeculable(Tac *instruction)
+{
+    bool speculable = false;
+
+    switch (instruction->getOpcode())
+    {
+    case ILOC_ADD: // Arithmetic and logic (Divisions are slow and may fault)
+    case ILOC_SUB:
+    case ILOC_MULT:
+    case ILOC_SUBI:
+    case ILOC_RSUBI:
+    case ILOC_MULTI:
+    case ILOC_LSHIFT:
+    case ILOC_LSHIFTI:
+    case ILOC_RSHIFT:
+    case ILOC_RSHIFTI:
+    case ILOC_AND:
+    case ILOC_ANDI:
+    case ILOC_OR:
+    case ILOC_ORI:
+    case ILOC_XOR:
+    case ILOC_XORI:
+    case ILOC_LOADI:
+    case ILOC_I2I:
+        speculable = instruction->getDefinition() != NULL;
+        break;
+    case ILOC_CMP_LT: // Compares, unless they set the flags for anything but a cmov
+    case ILOC_CMP_LE:
+    case ILOC_CMP_EQ:
+    case ILOC_CMP_GE:
+    case ILOC_CMP_GT:
+    case ILOC_CMP_NE:
+        speculable = instruction->getDefinition() != NULL || instruction->getNext()->getOpcode() == ILOC_CMOV;
+        break;
+    case ILOC_ADDI: // Addresses of variables as well, but not return addresses nor the stack's
+        speculable = instruction->getDefinition() != NULL && !instruction->getArgument(0)->isBase(BASE_RPC) &&
+                     !instruction->getArgument(0)->isBase(BASE_RSP);
+        break;
+    case ILOC_LOADAI: // Local variables
+        speculable = instruction->getArgument(0)->isBase(BASE_RFP);
+        break;
+    case ILOC_LOAD: // And global ones, whose address is calculated right before
+        speculable = !ASM::isIndirect(instruction);
+        break;
+    case ILOC_CMOV: // Selected in a conditional inside this one, with its compare
+        speculable = instruction->getArgument(0)->isBase(BASE_CC);
+        break;
+    default:
+        break;
+    }
+
+    return speculable;
+}
+
+bool ASM::isLeaf(TacList code)
+{
+    for (Tac *i = code.getFirst(); i != code.getLast()->getNext(); i = i->getNext())
+        if (i->getOpcode() == ILOC_JUMPI && ASM::getFunction(i->getArgument(0)) != NULL)
+            return false;
+
+    return true;
+}
+
+void ASM::allocateRegisters(CFG *cfg)
+{
+    CFG *current_cfg = cfg; // Control flow graph of the function, rebuilt after spilling
+    Graph *G = NULL;        // Register interference graph
+    LinearScan *L = NULL;   // Or live intervals, for linear scan
+    bool colored = false;   // If the registers fit in the machine's
+    bool can_spill = true;  // If spilling more registers may still help
+    unsigned int interferences = 0;
+    int spilled_count = 0;
+    std::chrono::duration<double, std::milli> build_time(0), color_time(0);
+
+    // No stack slots yet, they go after the local variables
+    ASM::locals_size = 0;
+    ASM::spill_slots = 0;
+    ASM::frame_size = 0;
+
+    for (Tac *i = ASM::current_function->getCode().getFirst(); i != NULL; i = i->getNext())
+        if (i->getOpcode() == ILOC_ADDI && i->getArgument(2)->isBase(BASE_RSP))
+        {
+            ASM::locals_size = i->getArgument(1)->getValue();
+            break;
+        }
+
+    // Registers created from here on hold spilled values, between a load and a store
+    ASM::spill_start = ASM::current_function->getArena()->getRegisterCount();
+
+    while (!colored && can_spill)
+    {
+        // Number of registers in the function
+        int register_count = ASM::current_function->getArena()->getRegisterCount();
+
+        // List of temporary variables, in order of first use
+        std::vector<Operand *> temps;
+        Bitset seen(register_count);
+
+        for (int block = 0; block < current_cfg->getBlockCount(); ++block)
         {
-            // If loading a value
-            if (!current->getArgument(0)->compare("rbss"))
+            BasicBlock *current_block = current_cfg->getBlock(block);
+
+            for (Tac *current = current_block->getFirst(); current != current_block->getLast()->getNext(); current = current->getNext())
             {
-                Symbol *symbol = Manager::getActiveSymbolTable()->getSymbolByAddress(std::stoi(*current->getArgument(1)));
-                code_segment << "\tmovl __" << symbol->getName() << "(\%rip), \%eax" << std::endl;
+                // Get the temporary variables used in this instruction
+                std::list<Operand *> used_variables = current->getVariables();
+
+                // Add the ones not seen before
+                for (auto var = used_variables.begin(); var != used_variables.end(); ++var)
+                {
+                    if (!seen.test((*var)->getValue()))
+                    {
+                        seen.set((*var)->getValue());
+                        temps.push_back(*var);
+                    }
+                }
             }
-            else if (!current->getArgument(0)->compare("rfp"))
+        }
+
+        // Find the variables live at the start and end of each block
+        Liveness liveness(current_cfg, register_count);
+
+        // And how much keeping each one in memory would cost
+        std::vector<double> costs = ASM::getSpillCosts(current_cfg, register_count);
+
+        auto build_start = std::chrono::steady_clock::now();
+        auto color_start = build_start;
+
+        delete G;
+        delete L;
+        G = NULL;
+        L = NULL;
+
+        if (ASM::linear_scan)
+        {
+            // Generate the live intervals
+            L = ASM::createLiveIntervals(current_cfg, &liveness, temps, costs);
+            color_start = std::chrono::steady_clock::now();
+
+            // And scan them
+            colored = L->allocateRegisters(X86_64_REGCOUNT);
+        }
+        else
+        {
+            // Generate the register interference graph
+            G = ASM::createRegisterInterferenceGraph(current_cfg, &liveness, temps, costs);
+            color_start = std::chrono::steady_clock::now();
+
+            // Try to minimize the amount of registers used
+            interferences = G->getEdgeCount();
+            colored = G->minimizeRegisterUsage(X86_64_REGCOUNT);
+        }
+
+        auto color_end = std::chrono::steady_clock::now();
+
+        build_time += color_start - build_start;
+        color_time += color_end - color_start;
+
+        if (!colored)
+        {
+            // Was not able to fit entire code in X86_64_REGCOUNT registers, must spill
+            std::vector<Operand *> spilled = ASM::linear_scan ? L->getSpilled() : G->getSpilled();
+
+            // Registers that hold spilled values already live as short as possible
+            spilled.erase(std::remove_if(spilled.begin(), spilled.end(),
+                                         [&costs](Operand *reg) { return std::isinf(costs[reg->getValue()]); }),
+                          spilled.end());
+
+            can_spill = !spilled.empty();
+
+            if (can_spill)
             {
-                code_segment << "\tmovl -" << *current->getArgument(1) << "(\%rbp), \%eax" << std::endl;
+                ASM::spillRegisters(spilled);
+                spilled_count += spilled.size();
+
+                // And try again, with the new code
+                if (current_cfg != cfg)
+                    delete current_cfg;
+
+                current_cfg = new CFG(ASM::current_function->getCode());
             }
-            else
+        }
+    }
+
+    if (colored)
+    {
+        // Number of used registers was minimized, get temp->register mapping
+        ASM::registers = ASM::linear_scan ? L->getColorMapping() : G->getColorMapping();
+
+        // Functions that call none would have to save %r12-%r15, but not the registers a call overwrites
+        if (ASM::isLeaf(ASM::current_function->getCode()))
+            for (auto i = ASM::registers.begin(); i != ASM::registers.end(); ++i)
+                if (!i->empty())
+                    *i = x86_64_leaf_registers[std::stoi(i->substr(2)) - X86_64_REGCOUNT];
+    }
+
+    if (ASM::output_stats)
+    {
+        int copies = 0;     // Instructions that may need a mov
+        int eliminated = 0; // The ones that do not, with the registers given
+
+        for (int block = 0; block < current_cfg->getBlockCount(); ++block)
+        {
+            BasicBlock *current_block = current_cfg->getBlock(block);
+
+            for (Tac *current = current_block->getFirst(); current != current_block->getLast()->getNext(); current = current->getNext())
             {
-                // Add regload instruction
-                code_segment << "\tmovl "
-                             << ASM::translateArgument(current->getArgument(0))
-                             << ", \%eax" << std::endl;
+                std::vector<std::pair<Operand *, Operand *>> pairs = ASM::getCopies(current);
+
+                if (!pairs.empty())
+                    copies++;
+
+                for (auto i = pairs.begin(); i != pairs.end(); ++i)
+                {
+                    if (colored && ASM::translateArgument(i->first) == ASM::translateArgument(i->second))
+                    {
+                        eliminated++;
+                        break;
+                    }
+                }
             }
+        }
 
-            // Ignore everything until jump return
-            for (; current->getOpcode() != ILOC_JUMP; current = current->getNext())
-                ;
+        std::cerr << "regalloc " << ASM::current_function->getName();
+
+        if (ASM::linear_scan)
+            std::cerr << ": temps " << L->getIntervalCount()
+                      << ", intervals " << L->getIntervalCount();
+        else
+            std::cerr << ": temps " << G->getVertexCount()
+                      << ", interferences " << interferences;
+
+        std::cerr << ", build " << build_time.count() << " ms"
+                  << ", color " << color_time.count() << " ms"
+                  << ", registers " << (ASM::linear_scan ? L->getUsedColorCount() : G->getUsedColorCount())
+                  << ", movs eliminated " << eliminated << "/" << copies
+                  << ", spilled " << spilled_count
+                  << std::endl;
+    }
+
+    // DEBUG
+    //std::cout << G->outputInfo() << std::endl;
+
+    // Free memory used in the register interference graph (Or intervals)
+    delete G;
+    delete L;
+
+    if (current_cfg != cfg)
+        delete current_cfg;
+
+    return;
+}
+
+std::vector<double> ASM::getSpillCosts(CFG *cfg, int register_count)
+{
+    std::vector<double> costs(register_count, 0);
+
+    for (int block = 0; block < cfg->getBlockCount(); ++block)
+    {
+        BasicBlock *current_block = cfg->getBlock(block);
+
+        // Each loop the block is in makes its instructions run more often
+        double weight = std::pow(SPILL_LOOP_WEIGHT, cfg->getLoopDepth(block));
+
+        for (Tac *current = current_block->getFirst(); current != current_block->getLast()->getNext(); current = current->getNext())
+        {
+            // Each reference would need a load or store
+            std::list<Operand *> variables = current->getVariables();
+
+            for (auto i = variables.begin(); i != variables.end(); ++i)
+                costs[(*i)->getValue()] += weight;
+
+            // Addresses are not kept in registers by the instructions that consume them
+            if (ASM::isGlued(current) && current->getOpcode() != ILOC_LOAD && current->getPrev()->getDefinition() != NULL)
+                costs[current->getPrev()->getDefinition()->getValue()] = INFINITY;
+        }
+    }
+
+    // Nor can values already loaded from memory be spilled again
+    for (int i = ASM::spill_start; i < register_count; ++i)
+        costs[i] = INFINITY;
+
+    return costs;
+}
+
+bool ASM::isGlued(Tac *instruction)
+{
+    bool glued = false;
+    Tac *prev = instruction->getPrev();
+
+    if (prev != NULL)
+    {
+        switch (instruction->getOpcode())
+        {
+        case ILOC_LOAD: // Translated with the address calculation before it
+        case ILOC_STORE:
+            glued = prev->getOpcode() == ILOC_ADDI && (prev->getArgument(0)->isBase(BASE_RFP) || prev->getArgument(0)->isBase(BASE_RBSS));
+            break;
+        case ILOC_CBR: // Jumps on or moves by the flags of the comparison before it
+        case ILOC_CMOV:
+            glued = instruction->getArgument(0)->isBase(BASE_CC);
+            break;
+        case ILOC_LOADAI: // Reads the return value right after a call
+            glued = prev->getOpcode() == ILOC_JUMPI && ASM::getFunction(prev->getArgument(0)) != NULL;
+            break;
+        default:
+            break;
         }
+    }
 
-        // Transate instruction to x86 ASM
-        code_segment << "\t" << ASM::translateTac(current) << std::endl;
+    return glued;
+}
 
-        // Reset label
-        label = NULL;
-    }
+bool ASM::isIndirect(Tac *instruction)
+{
+    Tac *prev = instruction->getPrev();
+    Operand *address = NULL;
 
-    // When done, insert end code for last function
-    code_segment << generateFunctionEnd(current);
+    switch (instruction->getOpcode())
+    {
+    case ILOC_LOAD:
+        address = instruction->getArgument(0);
+        break;
+    case ILOC_STORE:
+        address = instruction->getArgument(1);
+        break;
+    default:
+        return false;
+    }
 
-    // Return generated code segment
-    return code_segment.str();
+    return !ASM::isGlued(instruction) || prev->getArgument(2) != address;
 }
 
-std::string ASM::generateEndSegment()
+void ASM::spillRegisters(std::vector<Operand *> spilled)
 {
-    std::stringstream end_segment;
+    std::vector<Operand *> slots(ASM::current_function->getArena()->getRegisterCount(), NULL);
+    TacArena *previous_arena = TacArena::getActive();
+    TacList code = ASM::current_function->getCode();
+    Operand *rfp = Operand::getBase(BASE_RFP);
 
-    // Comments for legibility of generated ASM file
-    end_segment << "# =======================" << std::endl
-                << "#           END " << std::endl
-                << "# =======================" << std::endl;
+    // Spill code goes in the function's arena
+    TacArena::setActive(ASM::current_function->getArena());
 
-    // Code generation info
-    end_segment << "\t.ident \"INF01147\"" << std::endl
-                << "\t.section	.note.GNU-stack,\"\",@progbits";
+    // Give each register a stack slot (8 bytes each, after the local variables)
+    for (auto i = spilled.begin(); i != spilled.end(); ++i)
+        slots[(*i)->getValue()] = Tac::getImmediate(ASM::locals_size + 8 * ++ASM::spill_slots);
 
-    // Return generated end segment
-    return end_segment.str();
-}
+    // Instructions that must stay together (See isGlued) are rewritten as one
+    for (Tac *first = code.getFirst(); first != code.getLast()->getNext(); first = first->getNext())
+    {
+        Tac *last = first;
+        Tac *start = first; // First instruction of the rewritten group, loads included
 
-//
+        // The arguments of a call are read from their registers at the call, so none can be given to the spill code
+        while (last != code.getLast() && (ASM::isGlued(last->getNext()) || ASM::passesArgument(last)))
+            last = last->getNext();
 
-std::string ASM::generateFunctionStart(Tac *current)
-{
-    std::stringstream function_start;
+        // Spilled registers in the group
+        std::vector<Operand *> group_spilled;
 
-    // Comments for legibility
-    function_start << std::endl
-                   << "# =======================" << std::endl
-                   << "#  Start of function \"" << current_function->getName() << "\"" << std::endl
-                   << "# =======================" << std::endl;
+        for (Tac *i = first; i != last->getNext(); i = i->getNext())
+        {
+            std::list<Operand *> variables = i->getVariables();
 
-    // Add function start code
-    function_start << "\t.globl " << current_function->getName() << std::endl
-                   << "\t.type  " << current_function->getName() << ", @function" << std::endl;
+            for (auto var = variables.begin(); var != variables.end(); ++var)
+                if ((unsigned int)(*var)->getValue() < slots.size() && slots[(*var)->getValue()] != NULL &&
+                    std::find(group_spilled.begin(), group_spilled.end(), *var) == group_spilled.end())
+                    group_spilled.push_back(*var);
+        }
 
-    function_start << current_function->getName() << ":" << std::endl
-                   << ".LFB" << ASM::function_index << ":" << std::endl
-                   << "\tpushq \%rbp" << std::endl
-                   << "\tmovq \%rsp, \%rbp" << std::endl;
+        // Each gets a new register, loaded before the group and stored after it
+        for (auto spilled_register = group_spilled.begin(); spilled_register != group_spilled.end(); ++spilled_register)
+        {
+            Operand *slot = slots[(*spilled_register)->getValue()];
+            Operand *new_register = Tac::newRegister();
+            bool loaded = false;  // If read before being written in the group
+            bool written = false; // If written in the group
 
-    // Generate a register allocation map
-    ASM::allocateRegisters(current);
+            for (Tac *i = first; i != last->getNext(); i = i->getNext())
+            {
+                std::list<Operand *> uses = i->getUses();
 
-    // Return genrated code
-    return function_start.str();
-}
+                if (!written && std::find(uses.begin(), uses.end(), *spilled_register) != uses.end())
+                    loaded = true;
 
-std::string ASM::generateFunctionEnd(Tac *current)
-{
-    std::stringstream function_end;
+                if (i->getDefinition() == *spilled_register)
+                    written = true;
 
-    // Add function end code
-    function_end << std::endl
-                 << ".LFE" << ASM::function_index << ":" << std::endl
-                 << "\t.size " << current_function->getName() << ", .-" << current_function->getName() << std::endl;
+                i->replace(*spilled_register, new_register);
+            }
 
-    ASM::function_index++;
+            if (loaded)
+            {
+                Tac *load = new Tac(ILOC_LOADAI, rfp, slot, new_register); // loadAI rfp, slot => new
+
+                // The loads are the group's entry now, jumps to it must reach them
+                if (start == first)
+                {
+                    load->setLabel(first->getLabel());
+                    first->setLabel(NULL);
+                    start = load;
+                }
+
+                first->addBefore(load);
+            }
+
+            if (written)
+                last->addAfter(new Tac(ILOC_STOREAI, new_register, rfp, slot)); // storeAI new => rfp, slot
+        }
+
+        // Skip the stores just added
+        while (last != code.getLast() && last->getNext()->getOpcode() == ILOC_STOREAI && last->getNext()->getArgument(1) == rfp &&
+               last->getNext()->getArgument(0)->getValue() >= ASM::spill_start)
+            last = last->getNext();
 
-    // Return generated end code
-    return function_end.str();
+        first = last;
+    }
+
+    TacArena::setActive(previous_arena);
 }
 
-void ASM::allocateRegisters(Tac *first)
+Graph *ASM::createRegisterInterferenceGraph(CFG *cfg, Liveness *liveness, std::vector<Operand *> temps, std::vector<double> &costs)
 {
-    // List of temporary variables
-    std::vector<std::string *> temps;
+    // Create empty graph
+    Graph *g = new Graph(temps.size());
+
+    // Temporary variable for each register id
+    std::vector<Operand *> temp_ids(ASM::current_function->getArena()->getRegisterCount(), NULL);
 
-    // Last use for each variable
-    std::map<std::string *, Tac *> last_usage;
+    // Iterate temporary variable list creating vertexes
+    for (auto i = temps.begin(); i != temps.end(); ++i)
+    {
+        g->addVertex(*i, costs[(*i)->getValue()]);
+        temp_ids[(*i)->getValue()] = *i;
+    }
 
-    // Iterate function code adding live variables, registering their last use
-    for (Tac *current = first; !ASM::startsNewFunction(current); current = current->getNext())
+    // Iterate each block backwards, from its live-out variables
+    for (int block = 0; block < cfg->getBlockCount(); ++block)
     {
-        // Get the temporary variables used in this instruction
-        std::list<std::string *> used_variables = current->getVariables();
+        BasicBlock *current_block = cfg->getBlock(block);
+        Bitset live = liveness->getLiveOut(block);
 
-        // For each used variable
-        for (auto var = used_variables.begin(); var != used_variables.end(); ++var)
+        for (Tac *current = current_block->getLast(); current != current_block->getFirst()->getPrev(); current = current->getPrev())
         {
-            // Check if exists in the map
-            try
-            {
-                last_usage.at(*var);
+            Operand *definition = current->getDefinition();
+            std::vector<std::pair<Operand *, Operand *>> copies = ASM::getCopies(current);
 
-                // If so, update last usage
-                last_usage[*var] = current;
-            }
-            catch (const std::out_of_range &e)
-            {
-                // If not, add it
-                last_usage.insert(std::make_pair(*var, current));
-                temps.push_back(*var);
+            // A copied variable does not interfere with its copy, since they hold the same value
+            Operand *source = current->getOpcode() == ILOC_I2I && !copies.empty() ? copies.front().first : NULL;
 
-                // Insert it as live out in the current instruction
-                current->addLiveOut(*var);
-            }
+            // A written variable interferes with every other variable live after it
+            if (definition != NULL)
+                for (int i = live.next(0); i < live.getSize(); i = live.next(i + 1))
+                    if (i != definition->getValue() && (source == NULL || i != source->getValue()))
+                        g->addEdge(definition, temp_ids[i]);
+
+            // Registers that should rather be the same
+            for (auto i = copies.begin(); i != copies.end(); ++i)
+                g->addMove(i->first, i->second);
+
+            // Get the variables live before the instruction
+            Liveness::transfer(current, live);
         }
     }
 
-    // Iterate the last usage map, removing variable from live-out of last instruction
-    for (auto var = last_usage.begin(); var != last_usage.end(); ++var)
+    // Variables read before being written are all live at the function start, together
+    if (cfg->getBlockCount() > 0)
     {
-        // Remove from subsequent instructions
-        var->second->removeLiveOut(var->first);
+        Bitset &entry = liveness->getLiveIn(0);
+
+        for (int i = entry.next(0); i < entry.getSize(); i = entry.next(i + 1))
+            for (int j = entry.next(i + 1); j < entry.getSize(); j = entry.next(j + 1))
+                g->addEdge(temp_ids[i], temp_ids[j]);
     }
 
-    // Generate the register interference graph
-    Graph *G = ASM::createRegisterInterferenceGraph(first, temps);
+    // Return created graph
+    return g;
+}
 
-    // Try to minimize the amount of registers used
-    if (G->minimizeRegisterUsage(X86_64_REGCOUNT))
-    {
-        // Number of used registers was minimized, get temp->register mapping
-        ASM::registers = G->getColorMapping();
-    }
-    else
+std::vector<std::pair<Operand *, Operand *>> ASM::getCopies(Tac *instruction)
+{
+    std::vector<std::pair<Operand *, Operand *>> copies;
+    Operand *arg1 = instruction->getArgument(0);
+    Operand *arg2 = instruction->getArgument(1);
+    Operand *arg3 = instruction->getArgument(2);
+
+    switch (instruction->getOpcode())
     {
-        // Was not able to fit entire code in X86_64_REGCOUNT registers, must spill
-        // TODO
+    case ILOC_I2I: // movq r1, r2
+        if (arg1 != NULL && arg1->isRegister() && arg2 != NULL && arg2->isRegister())
+            copies.push_back(std::make_pair(arg1, arg2));
+        break;
+    case ILOC_ADD: // addq r1, r2 works for r3 = r2 as well
+    case ILOC_MULT:
+    case ILOC_AND:
+    case ILOC_OR:
+    case ILOC_XOR:
+        if (arg2 != NULL && arg2->isRegister() && arg3 != NULL && arg3->isRegister())
+            copies.push_back(std::make_pair(arg2, arg3));
+        // fall through
+    case ILOC_ADDI: // movq r1, r3 / addq r2, r3
+    case ILOC_SUB:
+    case ILOC_SUBI:
+    case ILOC_ANDI:
+    case ILOC_ORI:
+    case ILOC_XORI:
+    case ILOC_LSHIFT:
+    case ILOC_LSHIFTI:
+    case ILOC_RSHIFT:
+    case ILOC_RSHIFTI:
+        if (arg1 != NULL && arg1->isRegister() && arg3 != NULL && arg3->isRegister())
+            copies.insert(copies.begin(), std::make_pair(arg1, arg3));
+        break;
+    default:
+        break;
     }
 
-    // DEBUG
-    //std::cout << G->outputInfo() << std::endl;
-
-    // Free memory used in the register interference graph
-    delete G;
-
-    return;
+    return copies;
 }
 
-Graph *ASM::createRegisterInterferenceGraph(Tac *first, std::vector<std::string *> temps)
+LinearScan *ASM::createLiveIntervals(CFG *cfg, Liveness *liveness, std::vector<Operand *> temps, std::vector<double> &costs)
 {
-    // Create empty graph
-    Graph *g = new Graph();
+    LinearScan *l = new LinearScan(ASM::current_function->getArena()->getRegisterCount());
+    int position = 0; // Number of the current instruction
+
+    // Temporary variable for each register id
+    std::vector<Operand *> temp_ids(ASM::current_function->getArena()->getRegisterCount(), NULL);
 
-    // Iterate temporary variable list creating vertexes
     for (auto i = temps.begin(); i != temps.end(); ++i)
-        g->addVertex(*i);
+    {
+        l->addInterval(*i, costs[(*i)->getValue()]);
+        temp_ids[(*i)->getValue()] = *i;
+    }
 
-    // Iterate code
-    for (Tac *current = first; current != NULL && !ASM::startsNewFunction(current); current = current->getNext())
+    for (int block = 0; block < cfg->getBlockCount(); ++block)
     {
-        // Get current instruction's live_in list
-        std::vector<std::string *> live_vars = current->getLive();
+        BasicBlock *current_block = cfg->getBlock(block);
+        Bitset &live_in = liveness->getLiveIn(block);
+        Bitset &live_out = liveness->getLiveOut(block);
+
+        // Variables live at the start of the block
+        for (int i = live_in.next(0); i < live_in.getSize(); i = live_in.next(i + 1))
+            l->extend(temp_ids[i], position);
+
+        // And wherever they are referenced
+        for (Tac *current = current_block->getFirst(); current != current_block->getLast()->getNext(); current = current->getNext(), ++position)
+        {
+            std::list<Operand *> variables = current->getVariables();
+            std::vector<std::pair<Operand *, Operand *>> copies = ASM::getCopies(current);
+
+            for (auto i = variables.begin(); i != variables.end(); ++i)
+                l->extend(*i, position);
 
-        // Add an edge for each pair of live variables in the current instruction
-        for (auto i = live_vars.begin(); i != live_vars.end(); ++i)
-            for (auto j = i + 1; j != live_vars.end(); ++j)
-                g->addEdge(*i, *j);
+            // Registers that should rather be the same
+            for (auto i = copies.begin(); i != copies.end(); ++i)
+                l->addMove(i->first, i->second);
+        }
+
+        // Variables live at its end
+        for (int i = live_out.next(0); i < live_out.getSize(); i = live_out.next(i + 1))
+            l->extend(temp_ids[i], position - 1);
     }
 
-    // Return created graph
-    return g;
+    return l;
 }
 
-std::string ASM::translateArgument(std::string *arg)
+std::string ASM::translateArgument(Operand *arg)
 {
     std::stringstream result;
 
-    switch (arg->at(0))
+    switch (arg->getKind())
     {
-    case 'r': // Register
-        try
-        {
-            // Regular register
-            std::string name = ASM::registers.at(arg);
-            result << name;
-        }
-        catch (const std::out_of_range &e)
+    case OPERAND_REGISTER: // Regular register
+        if ((unsigned int)arg->getValue() < ASM::registers.size() && !ASM::registers[arg->getValue()].empty())
+            result << ASM::registers[arg->getValue()];
+        else
+            result << "?"; // Error, no register was allocated
+        break;
+    case OPERAND_BASE: // Special register
+        switch (arg->getValue())
         {
-            // Special register
-            switch (arg->at(1))
-            {
-            case 'f': // rfp
-                result << "\%rbp";
-                break;
-            case 's': // rsp
-                result << "\%rsp";
-                break;
-            case 'b': // rbss
-                result << "(\%rip)";
-                break;
-            case 'p': // rpc
-                result << "\%rip";
-                break;
-            default: // Error
-                result << "?";
-                break;
-            }
+        case BASE_RFP: // Variables are kept below the stack pointer when there is no frame
+            result << (ASM::frame_omitted ? "\%rsp" : "\%rbp");
+            break;
+        case BASE_RSP:
+            result << "\%rsp";
+            break;
+        case BASE_RBSS:
+            result << "(\%rip)";
+            break;
+        case BASE_RPC:
+            result << "\%rip";
+            break;
+        default: // Error
+            result << "?";
+            break;
         }
         break;
-    case 'l':           // Label
-        result << *arg; // TODO not sure yet
+    case OPERAND_LABEL:            // Label
+        result << arg->toString(); // TODO not sure yet
         break;
     default: // Literal
-        result << "$" << *arg;
+        result << "$" << arg->toString();
         break;
     }
 
     return result.str();
 }
 
-std::string ASM::translateTac(Tac *instruction)
+void ASM::getDivisionMagic(int divisor, long long &magic, int &shift)
+{
+    int bits = 0; // Bits needed to hold the divisor
+
+    while ((1LL << bits) < divisor)
+        bits++;
+
+    // Rounded up, the error stays below 1 / divisor for any 32 bit number
+    shift = 31 + bits;
+    magic = ((1LL << shift) + divisor - 1) / divisor;
+}
+
+void ASM::translateTac(Tac *instruction)
 {
-    std::stringstream code;
+    std::list<Instruction> &code = ASM::function_code;
+    std::string arg1 = instruction->getArgument(0) != NULL ? ASM::translateArgument(instruction->getArgument(0)) : "";
+    std::string arg2 = instruction->getArgument(1) != NULL ? ASM::translateArgument(instruction->getArgument(1)) : "";
+    std::string arg3 = instruction->getArgument(2) != NULL ? ASM::translateArgument(instruction->getArgument(2)) : "";
 
     // DEBUG
-    code << "# TAC: " << instruction->toString() << std::endl
-         << "\t";
+    if (ASM::output_tac_comments)
+        code.push_back(Instruction(INSTRUCTION_COMMENT, "TAC: " + instruction->toString()));
 
     // Based on instruction type
     switch (instruction->getOpcode())
     {
     case ILOC_NOP: // nop
-        code << "nop";
+        code.push_back(Instruction("nop"));
         break;
     case ILOC_ADD: // Addition
     case ILOC_ADDI:
     {
         // If arg1 = arg3
-        if (!ASM::translateArgument(instruction->getArgument(0)).compare(ASM::translateArgument(instruction->getArgument(2))))
+        if (arg1 == arg3)
         {
             // addq r2, r1 // r1 <- r1 + r2
-            code << "addq " << ASM::translateArgument(instruction->getArgument(1)) << ", " << ASM::translateArgument(instruction->getArgument(0));
+            code.push_back(Instruction("addq", {arg2, arg1}));
         }
         // If arg2 = arg3
-        else if (!ASM::translateArgument(instruction->getArgument(1)).compare(ASM::translateArgument(instruction->getArgument(2))))
+        else if (arg2 == arg3)
         {
             // addq r1,r2 // r2 <- r1 + r2
-            code << "addq " << ASM::translateArgument(instruction->getArgument(0)) << ", " << ASM::translateArgument(instruction->getArgument(1));
+            code.push_back(Instruction("addq", {arg1, arg2}));
         }
         // Otherwise
         else
         {
+            Tac *next = instruction->getNext();
+            std::string address;
+
+            // Whether it is the address of the load or store right after it, which is translated here
+            bool glued = next != NULL && (next->getOpcode() == ILOC_LOAD || next->getOpcode() == ILOC_STORE) && !ASM::isIndirect(next);
+
             // Check if this instruction is perparing to load or store a value
-            if (!instruction->getArgument(0)->compare("rbss"))
+            if (instruction->getArgument(0)->isBase(BASE_RBSS))
             {
                 // Get symbol associated with the address
-                Symbol *symbol = Manager::getActiveSymbolTable()->getSymbolByAddress(std::stoi(*instruction->getArgument(1)));
+                Symbol *symbol = Manager::getActiveSymbolTable()->getSymbolByAddress(instruction->getArgument(1)->getValue());
+
+                address = std::string("__") + symbol->getName() + "(\%rip)";
+            }
+            else if (instruction->getArgument(0)->isBase(BASE_RFP))
+            {
+                address = "-" + std::to_string(instruction->getArgument(1)->getValue()) + "(" + arg1 + ")";
+            }
 
+            if (!address.empty())
+            {
                 // Based on next instruction
-                if (instruction->getNext()->getOpcode() == ILOC_LOAD)
+                if (glued && next->getOpcode() == ILOC_LOAD)
                 {
                     // Add ASM to load it directly into the next instruction's register
-                    code << "movl __" << symbol->getName() << "(\%rip), " << ASM::translateArgument(instruction->getArgument(2)) << "d";
+                    code.push_back(Instruction("movl", {address, Instruction::getLowRegister(ASM::translateArgument(next->getArgument(1)))}));
                 }
-                else if (instruction->getNext()->getOpcode() == ILOC_STORE)
+                else if (glued && next->getOpcode() == ILOC_STORE)
                 {
                     // Add ASM to store directly to it
-                    code << "movl " << ASM::translateArgument(instruction->getNext()->getArgument(2)) << "d, __" << symbol->getName() << "(\%rip)";
-                }
-            }
-            else if (!instruction->getArgument(0)->compare("rfp"))
-            {
-
-                if (instruction->getNext()->getOpcode() == ILOC_LOAD)
-                {
-                    code << "movl -" << *instruction->getArgument(1) << "(\%rbp), " << ASM::translateArgument(instruction->getArgument(2)) << "d";
+                    code.push_back(Instruction("movl", {Instruction::getLowRegister(ASM::translateArgument(next->getArgument(0))), address}));
                 }
-                else if (instruction->getNext()->getOpcode() == ILOC_STORE)
+                else
                 {
-                    // Add ASM to store directly to it
-                    code << "movl " << ASM::translateArgument(instruction->getNext()->getArgument(0)) << "d, -" << *instruction->getArgument(1) << "(\%rbp)";
+                    // Loaded from or stored to later on (Such as by a shift), so the address is kept
+                    code.push_back(Instruction("leaq", {address, arg3}));
                 }
             }
-            else if (!instruction->getArgument(0)->compare("rpc"))
-            {
-                code << "# Ignore";
-            }
-            else
+            else if (!instruction->getArgument(0)->isBase(BASE_RPC)) // Return addresses are not needed
             {
-
                 // movq r1 r3 // r3 <- r1
-                code << "movq " << ASM::translateArgument(instruction->getArgument(0)) << ", " << ASM::translateArgument(instruction->getArgument(2)) << std::endl;
+                code.push_back(Instruction("movq", {arg1, arg3}));
 
                 // addq r2, r3 // r3 <- r2 + r3
-                code << "\taddq " << ASM::translateArgument(instruction->getArgument(1)) << ", " << ASM::translateArgument(instruction->getArgument(2));
+                code.push_back(Instruction("addq", {arg2, arg3}));
             }
         }
     }
@@ -484,102 +1362,275 @@ std::string ASM::translateTac(Tac *instruction)
     case ILOC_SUBI:
     {
         // If arg1 = arg3
-        if (!ASM::translateArgument(instruction->getArgument(0)).compare(ASM::translateArgument(instruction->getArgument(2))))
+        if (arg1 == arg3)
         {
             // subq r2, r1
-            code << "subq " << ASM::translateArgument(instruction->getArgument(1)) << ", " << ASM::translateArgument(instruction->getArgument(0));
+            code.push_back(Instruction("subq", {arg2, arg1}));
+        }
+        // If arg2 = arg3, negate it and add arg1
+        else if (arg2 == arg3)
+        {
+            // negq r2 / addq r1, r2
+            code.push_back(Instruction("negq", {arg2}));
+            code.push_back(Instruction("addq", {arg1, arg2}));
         }
         // Otherwise
         else
         {
             // movq r1 r3
-            code << "movq " << ASM::translateArgument(instruction->getArgument(0)) << ", " << ASM::translateArgument(instruction->getArgument(2)) << std::endl;
+            code.push_back(Instruction("movq", {arg1, arg3}));
 
             // subq r2 r3
-            code << "\tsubq " << ASM::translateArgument(instruction->getArgument(1)) << ", " << ASM::translateArgument(instruction->getArgument(2));
+            code.push_back(Instruction("subq", {arg2, arg3}));
         }
     }
     break;
     case ILOC_RSUBI: // Subtraction (Backwards)
     {
+        // If arg1 = arg3, negate it in place
+        if (arg1 == arg3)
+        {
+            // negq r3 / addq c2, r3
+            code.push_back(Instruction("negq", {arg3}));
+            code.push_back(Instruction("addq", {arg2, arg3}));
+        }
+        else
+        {
+            // movq c2 r3
+            code.push_back(Instruction("movq", {arg2, arg3}));
 
-        // movq c2 r3
-        code << "movq " << ASM::translateArgument(instruction->getArgument(1)) << ", " << ASM::translateArgument(instruction->getArgument(2)) << std::endl;
-
-        // subq r1 r3
-        code << "\tsubq " << ASM::translateArgument(instruction->getArgument(0)) << ", " << ASM::translateArgument(instruction->getArgument(2));
+            // subq r1 r3
+            code.push_back(Instruction("subq", {arg1, arg3}));
+        }
     }
     break;
     case ILOC_MULT: // Multiplication
+    {
+        // imulq r2, r1 if arg1 = arg3, imulq r1, r2 if arg2 = arg3
+        if (arg1 == arg3)
+            code.push_back(Instruction("imulq", {arg2, arg1}));
+        else if (arg2 == arg3)
+            code.push_back(Instruction("imulq", {arg1, arg2}));
+        else
+        {
+            // movq r1, r3 / imulq r2, r3
+            code.push_back(Instruction("movq", {arg1, arg3}));
+            code.push_back(Instruction("imulq", {arg2, arg3}));
+        }
+    }
+    break;
     case ILOC_MULTI:
     {
-        code << "movq " << ASM::translateArgument(instruction->getArgument(0)) << ", \%eax " << std::endl;
-        code << "\timulq " << ASM::translateArgument(instruction->getArgument(1)) << ", \%eax" << std::endl;
-        code << "\tmovq \%eax, " << ASM::translateArgument(instruction->getArgument(2));
+        // imulq $c2, r1, r3
+        code.push_back(Instruction("imulq", {arg2, arg1, arg3}));
+    }
+    break;
+    case ILOC_DIV: // Division (32 bits wide, the upper half of the registers is not kept)
+    {
+        // movl r1, %eax / cltd / idivl r2 / movl %eax, r3
+        code.push_back(Instruction("movl", {Instruction::getLowRegister(arg1), "\%eax"}));
+        code.push_back(Instruction("cltd"));
+        code.push_back(Instruction("idivl", {Instruction::getLowRegister(arg2)}));
+        code.push_back(Instruction("movl", {"\%eax", Instruction::getLowRegister(arg3)}));
     }
     break;
-    case ILOC_DIV: // Division
     case ILOC_DIVI:
     {
-        code << "movq " << ASM::translateArgument(instruction->getArgument(0)) << ", \%eax" << std::endl;
-        code << "\tidivq " << ASM::translateArgument(instruction->getArgument(1)) << std::endl;
-        code << "\tmovq \%eax " << ASM::translateArgument(instruction->getArgument(2));
+        int divisor = instruction->getArgument(1)->getValue();
+        int magnitude = divisor < 0 ? -divisor : divisor;
+
+        // Multiply by the reciprocal instead (Powers of two are shifts already, see StrengthReduction)
+        if (divisor != INT_MIN && magnitude > 2 && (magnitude & (magnitude - 1)) != 0)
+        {
+            long long magic = 0;
+            int shift = 0;
+
+            ASM::getDivisionMagic(magnitude, magic, shift);
+
+            // movslq r1, %rax / imulq $magic, %rax / sarq $shift, %rax (Rounded down)
+            code.push_back(Instruction("movslq", {Instruction::getLowRegister(arg1), "\%rax"}));
+
+            if (magic <= INT_MAX)
+                code.push_back(Instruction("imulq", {"$" + std::to_string(magic), "\%rax"}));
+            else
+            {
+                // Too wide for an immediate
+                code.push_back(Instruction("movabsq", {"$" + std::to_string(magic), "\%rdx"}));
+                code.push_back(Instruction("imulq", {"\%rdx", "\%rax"}));
+            }
+
+            code.push_back(Instruction("sarq", {"$" + std::to_string(shift), "\%rax"}));
+
+            // movl r1, %edx / sarl $31, %edx / subl %edx, %eax (Rounded towards zero, adding 1 if negative)
+            code.push_back(Instruction("movl", {Instruction::getLowRegister(arg1), "\%edx"}));
+            code.push_back(Instruction("sarl", {"$31", "\%edx"}));
+            code.push_back(Instruction("subl", {"\%edx", "\%eax"}));
+
+            if (divisor < 0)
+                code.push_back(Instruction("negl", {"\%eax"}));
+        }
+        else
+        {
+            // movl r1, %eax / movl $c2, %ecx / cltd / idivl %ecx (idiv takes no immediates)
+            code.push_back(Instruction("movl", {Instruction::getLowRegister(arg1), "\%eax"}));
+            code.push_back(Instruction("movl", {arg2, "\%ecx"}));
+            code.push_back(Instruction("cltd"));
+            code.push_back(Instruction("idivl", {"\%ecx"}));
+        }
+
+        // movl %eax, r3
+        code.push_back(Instruction("movl", {"\%eax", Instruction::getLowRegister(arg3)}));
+    }
+    break;
+    case ILOC_RDIVI: // Division (Backwards)
+    {
+        // movl $c2, %eax / cltd / idivl r1 / movl %eax, r3
+        code.push_back(Instruction("movl", {arg2, "\%eax"}));
+        code.push_back(Instruction("cltd"));
+        code.push_back(Instruction("idivl", {Instruction::getLowRegister(arg1)}));
+        code.push_back(Instruction("movl", {"\%eax", Instruction::getLowRegister(arg3)}));
     }
     break;
-    case ILOC_STORE: // Simple store
+    case ILOC_LSHIFT: // Shifts (32 bits wide, so that the sign comes from bit 31)
+    case ILOC_LSHIFTI:
+    case ILOC_RSHIFT:
+    case ILOC_RSHIFTI:
     {
-        // movq r1, (r2)
-        //code << "movq " << ASM::translateArgument(instruction->getArgument(0)) << ", (" << ASM::translateArgument(instruction->getArgument(1)) << ")";
+        bool left = instruction->getOpcode() == ILOC_LSHIFT || instruction->getOpcode() == ILOC_LSHIFTI;
+        std::string amount = arg2;
+
+        // Amounts in a register must be in %cl (Before r3 is written, it may be r2)
+        if (instruction->getArgument(1)->isRegister())
+        {
+            code.push_back(Instruction("movl", {Instruction::getLowRegister(arg2), "\%ecx"}));
+            amount = "\%cl";
+        }
+
+        // movq r1, r3 / sall amount, r3 (Or sarl)
+        if (arg1 != arg3)
+            code.push_back(Instruction("movq", {arg1, arg3}));
+
+        code.push_back(Instruction(left ? "sall" : "sarl", {amount, Instruction::getLowRegister(arg3)}));
     }
     break;
-    case ILOC_STOREAI: // Composite store
+    case ILOC_AND: // Bitwise operations
+    case ILOC_ANDI:
+    case ILOC_OR:
+    case ILOC_ORI:
+    case ILOC_XOR:
+    case ILOC_XORI:
+    {
+        std::string opcode = "xorq";
+
+        if (instruction->getOpcode() == ILOC_AND || instruction->getOpcode() == ILOC_ANDI)
+            opcode = "andq";
+        else if (instruction->getOpcode() == ILOC_OR || instruction->getOpcode() == ILOC_ORI)
+            opcode = "orq";
+
+        // op r2, r1 if arg1 = arg3, op r1, r2 if arg2 = arg3 (Never for an immediate)
+        if (arg1 == arg3)
+            code.push_back(Instruction(opcode, {arg2, arg1}));
+        else if (arg2 == arg3)
+            code.push_back(Instruction(opcode, {arg1, arg2}));
+        else
+        {
+            // movq r1, r3 / op r2, r3
+            code.push_back(Instruction("movq", {arg1, arg3}));
+            code.push_back(Instruction(opcode, {arg2, arg3}));
+        }
+    }
+    break;
+    case ILOC_STORE: // Simple store
+    case ILOC_LOAD:  // Simple memory load
     {
-        // movq r1 -val(r2)
-        code << "movq " << ASM::translateArgument(instruction->getArgument(0)) << ", -" << *instruction->getArgument(2) << "(" << ASM::translateArgument(instruction->getArgument(1)) << ")";
+        // Through an address calculated elsewhere, which is in a register
+        if (ASM::isIndirect(instruction) && instruction->getOpcode() == ILOC_LOAD)
+            code.push_back(Instruction("movl", {"(" + arg1 + ")", Instruction::getLowRegister(arg2)})); // movl (r1), r2
+        else if (ASM::isIndirect(instruction))
+            code.push_back(Instruction("movl", {Instruction::getLowRegister(arg1), "(" + arg2 + ")"})); // movl r1, (r2)
+
+        // Otherwise translated with the address calculation before them
     }
     break;
-    case ILOC_LOAD: // Simple memory load
+    case ILOC_STOREAI: // Composite store
     {
-        // movq (r1), r2
-        //code << "movq (" << ASM::translateArgument(instruction->getArgument(0)) << "), " << ASM::translateArgument(instruction->getArgument(1));
+        Operand *base = instruction->getArgument(1);
+        int offset = instruction->getArgument(2)->getValue();
+        unsigned int index = (offset - 3 * getSize(TYPE_INT)) / getSize(TYPE_INT); // Of the argument, if passing one
+
+        if (base->isBase(BASE_RSP))
+        {
+            // The return address, rsp and rfp are kept by the call instruction itself
+            if (offset < 3 * getSize(TYPE_INT))
+                break;
+
+            if (index >= ASM::call_arguments.size())
+                ASM::call_arguments.resize(index + 1, NULL);
+
+            ASM::call_arguments[index] = instruction->getArgument(0);
+
+            // movq r1, off(%rsp) (The ones that do not fit in registers go above the return address, in order)
+            if (index >= x86_64_argument_registers.size())
+                code.push_back(Instruction("movq", {arg1, std::to_string(8 * (index - x86_64_argument_registers.size())) + "(\%rsp)"}));
+        }
+        else if (base->isBase(BASE_RFP) && index == ASM::current_function->getParams().size())
+        {
+            // Returns the value in %eax
+            code.push_back(Instruction("movl", {Instruction::getLowRegister(arg1), "\%eax"}));
+        }
+        else if (base->isBase(BASE_RFP) && offset > ASM::locals_size)
+        {
+            // movq r1, -val(r2) (Spilled registers may hold addresses, 8 bytes wide)
+            code.push_back(Instruction("movq", {arg1, "-" + std::to_string(offset) + "(" + arg2 + ")"}));
+        }
+        else
+        {
+            // movl r1, -val(r2)
+            code.push_back(Instruction("movl", {Instruction::getLowRegister(arg1), "-" + std::to_string(offset) + "(" + arg2 + ")"}));
+        }
     }
     break;
     case ILOC_LOADI: // Constant load
     {
         // movq $lit, r2
-        code << "movq " << ASM::translateArgument(instruction->getArgument(0)) << ", " << ASM::translateArgument(instruction->getArgument(1));
+        code.push_back(Instruction("movq", {arg1, arg2}));
     }
     break;
     case ILOC_LOADAI: // Composite memory load
     {
+        Operand *base = instruction->getArgument(0);
+        int offset = instruction->getArgument(1)->getValue();
+
         // If returning for a function
-        if (instruction->getPrev()->getOpcode() == ILOC_JUMPI)
+        if (base->isBase(BASE_RSP))
         {
-            try
-            {
-                // Check if jump to function
-                Symbol *function = functions.at(instruction->getPrev()->getArgument(0));
-
-                // Load from eax instead
-                code << "movl \%eax,  " << ASM::translateArgument(instruction->getArgument(2)) << "d";
-            }
-            catch (const std::out_of_range &e)
-            {
-                // movq -lit(r1), r2
-                code << "movq -" << *instruction->getArgument(1) << "(" << ASM::translateArgument(instruction->getArgument(0)) << "), " << ASM::translateArgument(instruction->getArgument(2));
-            }
+            // Load from eax instead
+            code.push_back(Instruction("movl", {"\%eax", Instruction::getLowRegister(arg3)}));
+        }
+        else if (base->isBase(BASE_RFP) && offset < 3 * getSize(TYPE_INT))
+        {
+            // The return address, rsp and rfp are restored by the return instruction itself
+        }
+        else if (base->isBase(BASE_RFP) && offset <= ASM::locals_size)
+        {
+            // movl -lit(r1), r2
+            code.push_back(Instruction("movl", {"-" + std::to_string(offset) + "(" + arg1 + ")", Instruction::getLowRegister(arg3)}));
         }
         else
         {
             // movq -lit(r1), r2
-            code << "movq -" << *instruction->getArgument(1) << "(" << ASM::translateArgument(instruction->getArgument(0)) << "), " << ASM::translateArgument(instruction->getArgument(2));
+            code.push_back(Instruction("movq", {"-" + std::to_string(offset) + "(" + arg1 + ")", arg3}));
         }
     }
     break;
     case ILOC_I2I: // Register copy
     {
-        // movq r1, r2
-        code << "movq " << ASM::translateArgument(instruction->getArgument(0)) << ", " << ASM::translateArgument(instruction->getArgument(1));
+        // Frames are set up and freed by the call and return instructions
+        if (instruction->getArgument(1)->isBase(BASE_RSP) || instruction->getArgument(1)->isBase(BASE_RFP))
+            break;
+
+        // movq r1, r2 (Removed later if both were given the same register)
+        code.push_back(Instruction("movq", {arg1, arg2}));
     }
     break;
     case ILOC_CMP_EQ: // Compares
@@ -589,98 +1640,127 @@ std::string ASM::translateTac(Tac *instruction)
     case ILOC_CMP_LT:
     case ILOC_CMP_NE:
     {
-        // cmp r1, r2
-        code << "cmp " << ASM::translateArgument(instruction->getArgument(0)) << ", " << ASM::translateArgument(instruction->getArgument(1));
+        // cmpl r2, r1 (Sets the flags for r1 - r2, values are 32 bits wide)
+        code.push_back(Instruction("cmpl", {Instruction::getLowRegister(arg2), Instruction::getLowRegister(arg1)}));
+
+        // Results used as values are 1 or 0 (Branches read the flags instead, see fuseComparisons)
+        if (!instruction->getArgument(2)->isBase(BASE_CC))
+        {
+            // setcc r3b / movzbl r3b, r3d
+            code.push_back(Instruction("set" + x86_64_condition_codes.at(instruction->getOpcode()), {Instruction::getByteRegister(arg3)}));
+            code.push_back(Instruction("movzbl", {Instruction::getByteRegister(arg3), Instruction::getLowRegister(arg3)}));
+        }
     }
     break;
     case ILOC_CBR: // Conditional branch
     {
-        // Check last instruction (branch condition)
-        switch (instruction->getPrev()->getOpcode())
-        {
-        case ILOC_CMP_EQ:
-            code << "je  " << *instruction->getArgument(0);
-            break;
-        case ILOC_CMP_GE:
-            code << "jg  " << *instruction->getArgument(0);
-            break;
-        case ILOC_CMP_GT:
-            code << "jge " << *instruction->getArgument(0);
-            break;
-        case ILOC_CMP_LE:
-            code << "jle " << *instruction->getArgument(0);
-            break;
-        case ILOC_CMP_LT:
-            code << "jl  " << *instruction->getArgument(0);
-            break;
-        case ILOC_CMP_NE:
-            code << "jne " << *instruction->getArgument(0);
-            break;
-        default: // Error
-            break;
-        }
+        std::string jump = "jne"; // Jump if true, when the condition is a value
+
+        // Jump on the flags of the compare right before, or test the value itself
+        if (instruction->getArgument(0)->isBase(BASE_CC))
+            jump = "j" + x86_64_condition_codes.at(instruction->getPrev()->getOpcode());
+        else
+            code.push_back(Instruction("testl", {Instruction::getLowRegister(arg1), Instruction::getLowRegister(arg1)}));
+
+        // jcc l1 / jmp l2
+        code.push_back(Instruction(jump, {instruction->getArgument(1)->toString()}));
+        code.push_back(Instruction("jmp", {instruction->getArgument(2)->toString()}));
     }
     break;
+    case ILOC_CMOV: // Conditional move
+        // cmovcc r2, r3 (On the flags of the compare right before, the whole registers as an i2i would)
+        code.push_back(Instruction("cmov" + x86_64_condition_codes.at(instruction->getPrev()->getOpcode()), {arg2, arg3}));
+        break;
     case ILOC_JUMPI: // Unconditional branch to label
     {
-        try
+        // Check if jump to function
+        Symbol *function = ASM::getFunction(instruction->getArgument(0));
+
+        if (function != NULL && instruction->isTailCall())
+        {
+            // The arguments replaced this function's, they go where its caller passed them
+            for (unsigned int i = 0; i < function->getParams().size(); ++i)
+            {
+                std::string slot = ASM::getSlot(3 * getSize(TYPE_INT) + i * getSize(TYPE_INT));
+
+                if (i < x86_64_argument_registers.size())
+                    code.push_back(Instruction("movl", {slot, Instruction::getLowRegister(x86_64_argument_registers[i])}));
+                else
+                {
+                    code.push_back(Instruction("movl", {slot, "\%eax"}));
+                    code.push_back(Instruction("movl", {"\%eax", std::to_string(16 + 8 * (i - x86_64_argument_registers.size())) + "(\%rbp)"}));
+                }
+            }
+
+            for (auto i = ASM::callee_saved.begin(); i != ASM::callee_saved.end(); ++i)
+                code.push_back(Instruction("movq", {ASM::getSlot(ASM::save_slots[*i]), *i}));
+
+            // movq %rbp, %rsp / popq %rbp / jmp function (It returns to this function's caller)
+            code.push_back(Instruction("movq", {"\%rbp", "\%rsp"}));
+            code.push_back(Instruction("popq", {"\%rbp"}));
+            code.push_back(Instruction("jmp", {function->getName()}));
+        }
+        else if (function != NULL)
         {
-            // Check if jump to function
-            Symbol *function = functions.at(instruction->getArgument(0));
+            std::vector<std::string> &saved = ASM::caller_saved[instruction];
+            std::vector<std::pair<std::string, std::string>> moves;
+
+            // The registers still needed after the call may be overwritten by it
+            for (auto i = saved.begin(); i != saved.end(); ++i)
+                code.push_back(Instruction("movq", {*i, ASM::getSlot(ASM::save_slots[*i])}));
+
+            for (unsigned int i = 0; i < ASM::call_arguments.size() && i < x86_64_argument_registers.size(); ++i)
+                if (ASM::call_arguments[i] != NULL)
+                    moves.push_back(std::make_pair(ASM::translateArgument(ASM::call_arguments[i]), x86_64_argument_registers[i]));
+
+            ASM::moveInParallel(moves);
+            ASM::call_arguments.clear();
+
+            // call function
+            code.push_back(Instruction("call", {function->getName()}));
 
-            // call
-            code << "call " << function->getName();
+            for (auto i = saved.begin(); i != saved.end(); ++i)
+                code.push_back(Instruction("movq", {ASM::getSlot(ASM::save_slots[*i]), *i}));
         }
-        catch (const std::out_of_range &e)
+        else
         {
             // Regular jump to label
-            code << "jmp " << *instruction->getArgument(0);
+            code.push_back(Instruction("jmp", {instruction->getArgument(0)->toString()}));
         }
     }
     break;
     case ILOC_JUMP: // Unconditional branch to register value
     {
-        code << "popq \%rbp" << std::endl
-             << "\tret ";
+        for (auto i = ASM::callee_saved.begin(); i != ASM::callee_saved.end(); ++i)
+            code.push_back(Instruction("movq", {ASM::getSlot(ASM::save_slots[*i]), *i}));
+
+        // Free the stack frame, if one was reserved
+        if (ASM::frame_size > 0 && !ASM::frame_omitted)
+            code.push_back(Instruction("movq", {"\%rbp", "\%rsp"}));
+
+        if (!ASM::frame_omitted)
+            code.push_back(Instruction("popq", {"\%rbp"}));
+
+        // ret (The value returned is in %eax already)
+        code.push_back(Instruction("ret"));
     }
     break;
     default:
     {
-        code << "nop # No translation for " << opname.at(instruction->getOpcode());
+        code.push_back(Instruction(INSTRUCTION_COMMENT, "No translation for " + opname.at(instruction->getOpcode())));
     }
     break;
     }
-
-    // Return generated code string
-    return code.str();
 }
 
-//
 
-bool ASM::startsNewFunction(Tac *instruction)
+Symbol *ASM::getFunction(Operand *label)
 {
-    bool status = false;
-
-    if (instruction == NULL)
-    {
-        status = true;
-    }
-    else if (instruction->getLabel() != NULL)
-    {
-        try
-        {
-            Symbol *function = ASM::functions.at(instruction->getLabel());
+    Symbol *function = NULL;
 
-            // If starting not this function
-            if (strcmp(function->getName(), current_function->getName()) != 0)
-                status = true;
-        }
-        catch (const std::out_of_range &e)
-        {
-            // Does not start a function
-            status = false;
-        }
-    }
+    // Only labels can start a function
+    if (label != NULL && label->isLabel() && (unsigned int)label->getValue() < ASM::functions.size())
+        function = ASM::functions[label->getValue()];
 
-    return status;
+    return function;
 }
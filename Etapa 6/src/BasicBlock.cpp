@@ -0,0 +1,78 @@
+#include "BasicBlock.h"
+#include "Tac.h"
+
+#include <sstream>
+#include <algorithm>
+
+BasicBlock::BasicBlock(int id_, Tac *first_)
+{
+    this->id = id_;
+    this->first = first_;
+    this->last = first_;
+    this->size = 1;
+}
+
+BasicBlock::~BasicBlock()
+{
+    // nil
+}
+
+int BasicBlock::getId()
+{
+    return this->id;
+}
+
+Tac *BasicBlock::getFirst()
+{
+    return this->first;
+}
+
+Tac *BasicBlock::getLast()
+{
+    return this->last;
+}
+
+int BasicBlock::getSize()
+{
+    return this->size;
+}
+
+std::vector<int> &BasicBlock::getSuccessors()
+{
+    return this->successors;
+}
+
+std::vector<int> &BasicBlock::getPredecessors()
+{
+    return this->predecessors;
+}
+
+void BasicBlock::extend()
+{
+    this->last = this->last->getNext();
+    this->size++;
+}
+
+void BasicBlock::addSuccessor(int block_id)
+{
+    // Both targets of a branch can be the same block
+    if (std::find(this->successors.begin(), this->successors.end(), block_id) == this->successors.end())
+        this->successors.push_back(block_id);
+}
+
+void BasicBlock::addPredecessor(int block_id)
+{
+    if (std::find(this->predecessors.begin(), this->predecessors.end(), block_id) == this->predecessors.end())
+        this->predecessors.push_back(block_id);
+}
+
+std::string BasicBlock::getCodeString()
+{
+    std::stringstream code;
+
+    // Export every instruction from the first to the last
+    for (Tac *i = this->first; i != this->last->getNext(); i = i->getNext())
+        code << i->toString() << std::endl;
+
+    return code.str();
+}
@@ -0,0 +1,111 @@
+#include "Bitset.h"
+
+#include <algorithm>
+
+Bitset::Bitset(int size_)
+{
+    this->size = size_;
+    this->words.assign((size_ + 63) / 64, 0);
+}
+
+Bitset::~Bitset()
+{
+    // nil
+}
+
+int Bitset::getSize()
+{
+    return this->size;
+}
+
+int Bitset::count()
+{
+    int total = 0;
+
+    for (auto i = this->words.begin(); i != this->words.end(); ++i)
+        total += __builtin_popcountll(*i);
+
+    return total;
+}
+
+int Bitset::next(int element)
+{
+    unsigned int word = element / 64;
+    uint64_t bits = 0;
+    int found = this->size;
+
+    if (element < this->size)
+    {
+        // Ignore the elements before the given one in its word
+        bits = this->words[word] & (~0ULL << (element % 64));
+
+        // Skip empty words
+        while (bits == 0 && ++word < this->words.size())
+            bits = this->words[word];
+
+        if (bits != 0)
+            found = word * 64 + __builtin_ctzll(bits);
+    }
+
+    return found;
+}
+
+bool Bitset::test(int element)
+{
+    return (this->words[element / 64] >> (element % 64)) & 1;
+}
+
+bool Bitset::isEmpty()
+{
+    bool empty = true;
+
+    for (auto i = this->words.begin(); empty && i != this->words.end(); ++i)
+        if (*i != 0)
+            empty = false;
+
+    return empty;
+}
+
+bool Bitset::operator==(const Bitset &set) const
+{
+    return this->words == set.words;
+}
+
+bool Bitset::operator!=(const Bitset &set) const
+{
+    return this->words != set.words;
+}
+
+void Bitset::set(int element)
+{
+    this->words[element / 64] |= 1ULL << (element % 64);
+}
+
+void Bitset::reset(int element)
+{
+    this->words[element / 64] &= ~(1ULL << (element % 64));
+}
+
+void Bitset::clear()
+{
+    std::fill(this->words.begin(), this->words.end(), 0);
+}
+
+bool Bitset::unite(const Bitset &set)
+{
+    uint64_t changed = 0;
+
+    for (unsigned int i = 0; i < this->words.size(); ++i)
+    {
+        changed |= set.words[i] & ~this->words[i];
+        this->words[i] |= set.words[i];
+    }
+
+    return changed != 0;
+}
+
+void Bitset::subtract(const Bitset &set)
+{
+    for (unsigned int i = 0; i < this->words.size(); ++i)
+        this->words[i] &= ~set.words[i];
+}
@@ -0,0 +1,339 @@
+#include "CFG.h"
+#include "Tac.h"
+
+#include <sstream>
+
+CFG::CFG(TacList code)
+{
+    std::unordered_map<int, int> labels = this->split(code);
+
+    this->link(labels);
+    this->computeOrder();
+    this->computeDominators();
+    this->computeLoops();
+}
+
+CFG::~CFG()
+{
+    // nil
+}
+
+std::unordered_map<int, int> CFG::split(TacList code)
+{
+    std::unordered_map<int, int> labels;
+    bool ends_block = true; // If the previous instruction ended a block
+
+    for (Tac *i = code.getFirst(); i != NULL && i != code.getLast()->getNext(); i = i->getNext())
+    {
+        // Labeled instructions can be jumped to, and start a block
+        if (ends_block || i->getLabel() != NULL)
+            this->blocks.push_back(BasicBlock(this->blocks.size(), i));
+        else
+            this->blocks.back().extend();
+
+        // Keep track of where each label is
+        if (i->getLabel() != NULL)
+            labels[i->getLabel()->getValue()] = this->blocks.size() - 1;
+
+        // Branches end their block
+        switch (i->getOpcode())
+        {
+        case ILOC_CBR:
+        case ILOC_JUMPI:
+        case ILOC_JUMP:
+        case ILOC_HALT:
+            ends_block = true;
+            break;
+        default:
+            ends_block = false;
+            break;
+        }
+    }
+
+    return labels;
+}
+
+void CFG::link(std::unordered_map<int, int> &labels)
+{
+    std::vector<int> targets; // Blocks the current one goes to
+    Tac *last = NULL;
+
+    this->calls.assign(this->blocks.size(), false);
+
+    for (unsigned int i = 0; i < this->blocks.size(); ++i)
+    {
+        last = this->blocks[i].getLast();
+        targets.clear();
+
+        switch (last->getOpcode())
+        {
+        case ILOC_CBR: // Both labels
+            for (int j = 1; j <= 2; ++j)
+                if (last->getArgument(j)->isLabel() && labels.count(last->getArgument(j)->getValue()))
+                    targets.push_back(labels[last->getArgument(j)->getValue()]);
+            break;
+        case ILOC_JUMPI: // The label, or the next block when calling a function (Another one, or this one's entry)
+            if (last->isTailCall())
+                // Returns through the function it calls
+                this->calls[i] = true;
+            else if (last->getArgument(0)->isLabel() && labels.count(last->getArgument(0)->getValue()) &&
+                labels[last->getArgument(0)->getValue()] != 0)
+                targets.push_back(labels[last->getArgument(0)->getValue()]);
+            else
+            {
+                this->calls[i] = true;
+
+                if (i + 1 < this->blocks.size())
+                    targets.push_back(i + 1);
+            }
+            break;
+        case ILOC_JUMP: // Returns from the function
+        case ILOC_HALT:
+            break;
+        default: // Falls through to the next block
+            if (i + 1 < this->blocks.size())
+                targets.push_back(i + 1);
+            break;
+        }
+
+        // Add edges
+        for (auto j = targets.begin(); j != targets.end(); ++j)
+        {
+            this->blocks[i].addSuccessor(*j);
+            this->blocks[*j].addPredecessor(i);
+        }
+    }
+}
+
+void CFG::computeOrder()
+{
+    std::vector<int> post_order;
+    std::vector<std::pair<int, unsigned int>> pending; // Blocks being visited, with the next successor to visit
+    std::vector<bool> visited(this->blocks.size(), false);
+    int block = 0;
+
+    this->rpo_index.assign(this->blocks.size(), -1);
+
+    if (!this->blocks.empty())
+    {
+        // Depth first search from the entry
+        pending.push_back(std::make_pair(0, 0));
+        visited[0] = true;
+
+        while (!pending.empty())
+        {
+            block = pending.back().first;
+            std::vector<int> &successors = this->blocks[block].getSuccessors();
+
+            // Visit the next successor, if there are any left
+            if (pending.back().second < successors.size())
+            {
+                int next = successors[pending.back().second++];
+
+                if (!visited[next])
+                {
+                    visited[next] = true;
+                    pending.push_back(std::make_pair(next, 0));
+                }
+            }
+            // Otherwise the block is done
+            else
+            {
+                post_order.push_back(block);
+                pending.pop_back();
+            }
+        }
+    }
+
+    // Reverse it
+    this->order.assign(post_order.rbegin(), post_order.rend());
+
+    for (unsigned int i = 0; i < this->order.size(); ++i)
+        this->rpo_index[this->order[i]] = i;
+}
+
+void CFG::computeDominators()
+{
+    bool changed = !this->order.empty();
+    int new_idom = -1;
+
+    this->idom.assign(this->blocks.size(), -1);
+
+    // The entry dominates itself
+    if (!this->order.empty())
+        this->idom[this->order[0]] = this->order[0];
+
+    // Iterate until nothing changes (Cooper, Harvey and Kennedy)
+    while (changed)
+    {
+        changed = false;
+
+        for (unsigned int i = 1; i < this->order.size(); ++i)
+        {
+            std::vector<int> &predecessors = this->blocks[this->order[i]].getPredecessors();
+            new_idom = -1;
+
+            // Intersect the dominators of every predecessor processed so far
+            for (auto p = predecessors.begin(); p != predecessors.end(); ++p)
+                if (this->idom[*p] != -1)
+                    new_idom = (new_idom == -1) ? *p : this->intersect(*p, new_idom);
+
+            if (this->idom[this->order[i]] != new_idom)
+            {
+                this->idom[this->order[i]] = new_idom;
+                changed = true;
+            }
+        }
+    }
+}
+
+void CFG::computeLoops()
+{
+    std::vector<int> pending; // Blocks found in the loop whose predecessors were not visited
+    std::vector<int> header(this->blocks.size(), -1); // Header of the last loop each block was found in
+
+    this->loop_depth.assign(this->blocks.size(), 0);
+    this->loops.assign(this->blocks.size(), std::vector<int>());
+
+    for (auto h = this->order.begin(); h != this->order.end(); ++h)
+    {
+        std::vector<int> &predecessors = this->blocks[*h].getPredecessors();
+
+        // Edges back to the block close a loop
+        for (auto p = predecessors.begin(); p != predecessors.end(); ++p)
+            if (this->dominates(*h, *p))
+                pending.push_back(*p);
+
+        if (!pending.empty())
+        {
+            header[*h] = *h;
+            this->loop_depth[*h]++;
+            this->loops[*h].push_back(*h);
+        }
+
+        // Walk backwards from them up to the header
+        while (!pending.empty())
+        {
+            int block = pending.back();
+            pending.pop_back();
+
+            if (header[block] != *h)
+            {
+                header[block] = *h;
+                this->loop_depth[block]++;
+                this->loops[*h].push_back(block);
+
+                for (auto p = this->blocks[block].getPredecessors().begin(); p != this->blocks[block].getPredecessors().end(); ++p)
+                    if (this->isReachable(*p))
+                        pending.push_back(*p);
+            }
+        }
+    }
+}
+
+int CFG::intersect(int block_1, int block_2)
+{
+    // Walk up the dominator tree from the block further down in the order
+    while (block_1 != block_2)
+    {
+        while (this->rpo_index[block_1] > this->rpo_index[block_2])
+            block_1 = this->idom[block_1];
+
+        while (this->rpo_index[block_2] > this->rpo_index[block_1])
+            block_2 = this->idom[block_2];
+    }
+
+    return block_1;
+}
+
+int CFG::getBlockCount()
+{
+    return this->blocks.size();
+}
+
+BasicBlock *CFG::getBlock(int block_id)
+{
+    return &this->blocks[block_id];
+}
+
+std::vector<int> &CFG::getReversePostOrder()
+{
+    return this->order;
+}
+
+int CFG::getImmediateDominator(int block_id)
+{
+    return this->idom[block_id];
+}
+
+int CFG::getLoopDepth(int block_id)
+{
+    return this->loop_depth[block_id];
+}
+
+std::vector<int> &CFG::getLoop(int block_id)
+{
+    return this->loops[block_id];
+}
+
+bool CFG::isReachable(int block_id)
+{
+    return this->rpo_index[block_id] != -1;
+}
+
+bool CFG::isCall(int block_id)
+{
+    return this->calls[block_id];
+}
+
+bool CFG::dominates(int dominator, int block_id)
+{
+    bool status = false;
+
+    // Walk up the dominator tree until reaching the dominator or the entry
+    if (this->isReachable(block_id) && this->isReachable(dominator))
+    {
+        while (block_id != dominator && this->idom[block_id] != block_id)
+            block_id = this->idom[block_id];
+
+        status = (block_id == dominator);
+    }
+
+    return status;
+}
+
+std::string CFG::toString()
+{
+    std::stringstream output;
+
+    for (auto i = this->blocks.begin(); i != this->blocks.end(); ++i)
+    {
+        output << "B" << i->getId() << ":";
+
+        // Edges
+        output << " predecessors [";
+        for (auto j = i->getPredecessors().begin(); j != i->getPredecessors().end(); ++j)
+            output << (j != i->getPredecessors().begin() ? " " : "") << "B" << *j;
+
+        output << "] successors [";
+        for (auto j = i->getSuccessors().begin(); j != i->getSuccessors().end(); ++j)
+            output << (j != i->getSuccessors().begin() ? " " : "") << "B" << *j;
+
+        output << "]";
+
+        // Dominator
+        if (this->isReachable(i->getId()))
+            output << " idom B" << this->idom[i->getId()];
+        else
+            output << " unreachable";
+
+        // Loops
+        if (this->loop_depth[i->getId()] > 0)
+            output << " loop depth " << this->loop_depth[i->getId()];
+
+        output << std::endl
+               << i->getCodeString();
+    }
+
+    return output.str();
+}
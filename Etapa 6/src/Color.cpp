@@ -15,7 +15,7 @@ unsigned int Color::getId()
     return this->id;
 }
 
-std::vector<unsigned int> Color::getUsers()
+std::vector<unsigned int> &Color::getUsers()
 {
     return this->used_by;
 }
@@ -0,0 +1,582 @@
+#include "CopyPropagation.h"
+#include "Tac.h"
+#include "ASM.h"
+
+#include <climits>
+
+CopyPropagation::CopyPropagation(TacList &code_, int register_count_)
+{
+    this->code = &code_;
+    this->propagated = 0;
+    this->forwarded = 0;
+
+    CFG cfg(code_);
+    std::vector<int> &order = cfg.getReversePostOrder();
+    bool changed = true;
+
+    // Registers some block reads before writing them, the only ones that may be live where a block ends
+    Bitset global(register_count_);
+    std::vector<int> written(register_count_, -1); // Last block that wrote each register
+
+    for (int block = 0; block < cfg.getBlockCount(); ++block)
+    {
+        BasicBlock *current_block = cfg.getBlock(block);
+        Tac *end = current_block->getLast()->getNext();
+
+        for (Tac *i = current_block->getFirst(); i != end; i = i->getNext())
+        {
+            std::list<Operand *> uses = i->getUses();
+
+            for (auto j = uses.begin(); j != uses.end(); ++j)
+                if (written[(*j)->getValue()] != block)
+                    global.set((*j)->getValue());
+
+            if (i->getDefinition() != NULL)
+                written[i->getDefinition()->getValue()] = block;
+        }
+    }
+
+    this->copies_out.resize(cfg.getBlockCount());
+    this->slots_out.resize(cfg.getBlockCount());
+    this->visited.assign(cfg.getBlockCount(), false);
+
+    // Find the copies that hold at the end of each block (Blocks before their successors)
+    while (changed)
+    {
+        changed = false;
+
+        for (auto block = order.begin(); block != order.end(); ++block)
+        {
+            BasicBlock *current_block = cfg.getBlock(*block);
+            Tac *end = current_block->getLast()->getNext();
+
+            this->enter(current_block);
+
+            for (Tac *i = current_block->getFirst(); i != end; i = i->getNext())
+                this->transfer(i, false);
+
+            // Forget the local variables when calling a function, as value numbering does
+            if (cfg.isCall(*block))
+                this->killSlots();
+
+            // Copies in registers no other block reads are not needed anymore (Unless loaded back from a local variable)
+            for (auto i = this->copies.begin(); i != this->copies.end();)
+            {
+                if (!global.test(i->first->getValue()) && !this->isStored(i->first))
+                    i = this->copies.erase(i);
+                else
+                    ++i;
+            }
+
+            if (!this->visited[*block] || this->copies != this->copies_out[*block] || this->slots != this->slots_out[*block])
+            {
+                this->copies_out[*block] = this->copies;
+                this->slots_out[*block] = this->slots;
+                this->visited[*block] = true;
+                changed = true;
+            }
+        }
+    }
+
+    // And read the original values instead of the copies
+    for (auto block = order.begin(); block != order.end(); ++block)
+    {
+        BasicBlock *current_block = cfg.getBlock(*block);
+        Tac *end = current_block->getLast()->getNext();
+
+        this->enter(current_block);
+
+        for (Tac *i = current_block->getFirst(); i != end; i = i->getNext())
+            this->transfer(i, true);
+    }
+}
+
+CopyPropagation::~CopyPropagation()
+{
+    // nil
+}
+
+int CopyPropagation::getRewrittenCount()
+{
+    return this->propagated + this->forwarded;
+}
+
+bool CopyPropagation::isSame(Operand *operand_1, Operand *operand_2)
+{
+    // Constants may come from different arenas
+    return operand_1 == operand_2 ||
+           (operand_1->isImmediate() && operand_2->isImmediate() && operand_1->getValue() == operand_2->getValue());
+}
+
+ILOCop CopyPropagation::getImmediateForm(ILOCop opcode)
+{
+    ILOCop immediate = opcode;
+
+    switch (opcode)
+    {
+    case ILOC_ADD:
+        immediate = ILOC_ADDI;
+        break;
+    case ILOC_SUB:
+        immediate = ILOC_SUBI;
+        break;
+    case ILOC_MULT:
+        immediate = ILOC_MULTI;
+        break;
+    case ILOC_DIV:
+        immediate = ILOC_DIVI;
+        break;
+    case ILOC_LSHIFT:
+        immediate = ILOC_LSHIFTI;
+        break;
+    case ILOC_RSHIFT:
+        immediate = ILOC_RSHIFTI;
+        break;
+    case ILOC_AND:
+        immediate = ILOC_ANDI;
+        break;
+    case ILOC_OR:
+        immediate = ILOC_ORI;
+        break;
+    case ILOC_XOR:
+        immediate = ILOC_XORI;
+        break;
+    default:
+        break;
+    }
+
+    return immediate;
+}
+
+bool CopyPropagation::fold(ILOCop opcode, int value_1, int value_2, int &result)
+{
+    unsigned int a = value_1;
+    unsigned int b = value_2;
+    bool known = true;
+
+    // Division overflows for the smallest integer over -1
+    bool divisible = value_2 != 0 && !(value_1 == INT_MIN && value_2 == -1);
+    bool reverse_divisible = value_1 != 0 && !(value_2 == INT_MIN && value_1 == -1);
+
+    // Wrapping around, like the generated code would (And the folding in the AST)
+    switch (opcode)
+    {
+    case ILOC_ADD:
+    case ILOC_ADDI:
+        result = (int)(a + b);
+        break;
+    case ILOC_SUB:
+    case ILOC_SUBI:
+        result = (int)(a - b);
+        break;
+    case ILOC_RSUBI:
+        result = (int)(b - a);
+        break;
+    case ILOC_MULT:
+    case ILOC_MULTI:
+        result = (int)(a * b);
+        break;
+    case ILOC_DIV:
+    case ILOC_DIVI:
+        known = divisible;
+        result = known ? value_1 / value_2 : 0;
+        break;
+    case ILOC_RDIVI:
+        known = reverse_divisible;
+        result = known ? value_2 / value_1 : 0;
+        break;
+    case ILOC_LSHIFT: // Only by the amounts the machine shifts by
+    case ILOC_LSHIFTI:
+        known = value_2 >= 0 && value_2 < 32;
+        result = known ? (int)(a << value_2) : 0;
+        break;
+    case ILOC_RSHIFT:
+    case ILOC_RSHIFTI:
+        known = value_2 >= 0 && value_2 < 32;
+        result = known ? value_1 >> value_2 : 0;
+        break;
+    case ILOC_AND:
+    case ILOC_ANDI:
+        result = value_1 & value_2;
+        break;
+    case ILOC_OR:
+    case ILOC_ORI:
+        result = value_1 | value_2;
+        break;
+    case ILOC_XOR:
+    case ILOC_XORI:
+        result = value_1 ^ value_2;
+        break;
+    default:
+        known = false;
+        break;
+    }
+
+    return known;
+}
+
+Operand *CopyPropagation::resolve(Operand *operand, bool registers_only)
+{
+    auto copy = this->copies.find(operand);
+
+    // Copies of copies go back to the first one
+    while (copy != this->copies.end() && (!registers_only || copy->second->isRegister()))
+    {
+        operand = copy->second;
+        copy = this->copies.find(operand);
+    }
+
+    return operand;
+}
+
+bool CopyPropagation::isStored(Operand *source)
+{
+    auto stored = this->stored.find(source);
+
+    if (stored == this->stored.end())
+        return false;
+
+    // Some of them may hold another value by now
+    for (auto slot = stored->second.begin(); slot != stored->second.end(); ++slot)
+    {
+        auto held = this->slots.find(*slot);
+
+        if (held != this->slots.end() && held->second == source)
+            return true;
+    }
+
+    return false;
+}
+
+void CopyPropagation::setCopy(Operand *target, Operand *source)
+{
+    this->copies[target] = source;
+
+    if (source->isRegister())
+        this->from[source].push_back(target);
+}
+
+void CopyPropagation::setSlot(int slot, Operand *source)
+{
+    this->slots[slot] = source;
+    this->stored[source].push_back(slot);
+}
+
+void CopyPropagation::kill(Operand *target)
+{
+    auto copied = this->from.find(target);
+    auto slot = this->stored.find(target);
+
+    this->copies.erase(target);
+
+    // Copies made from its old value
+    if (copied != this->from.end())
+    {
+        for (auto i = copied->second.begin(); i != copied->second.end(); ++i)
+        {
+            auto copy = this->copies.find(*i);
+
+            if (copy != this->copies.end() && copy->second == target)
+                this->copies.erase(copy);
+        }
+
+        this->from.erase(copied);
+    }
+
+    if (slot != this->stored.end())
+    {
+        for (auto i = slot->second.begin(); i != slot->second.end(); ++i)
+        {
+            auto copy = this->slots.find(*i);
+
+            if (copy != this->slots.end() && copy->second == target)
+                this->slots.erase(copy);
+        }
+
+        this->stored.erase(slot);
+    }
+}
+
+void CopyPropagation::killSlots()
+{
+    this->slots.clear();
+    this->stored.clear();
+}
+
+void CopyPropagation::enter(BasicBlock *block)
+{
+    std::vector<int> &predecessors = block->getPredecessors();
+    bool first = true;
+
+    this->copies.clear();
+    this->slots.clear();
+    this->from.clear();
+    this->stored.clear();
+
+    for (auto p = predecessors.begin(); p != predecessors.end(); ++p)
+    {
+        // Blocks not walked yet (Loops) are taken as holding every copy
+        if (!this->visited[*p])
+            continue;
+
+        if (first)
+        {
+            this->copies = this->copies_out[*p];
+            this->slots = this->slots_out[*p];
+            first = false;
+            continue;
+        }
+
+        // Only the copies held on every path
+        for (auto i = this->copies.begin(); i != this->copies.end();)
+        {
+            auto other = this->copies_out[*p].find(i->first);
+
+            if (other == this->copies_out[*p].end() || !CopyPropagation::isSame(i->second, other->second))
+                i = this->copies.erase(i);
+            else
+                ++i;
+        }
+
+        for (auto i = this->slots.begin(); i != this->slots.end();)
+        {
+            auto other = this->slots_out[*p].find(i->first);
+
+            if (other == this->slots_out[*p].end() || other->second != i->second)
+                i = this->slots.erase(i);
+            else
+                ++i;
+        }
+    }
+
+    for (auto i = this->copies.begin(); i != this->copies.end(); ++i)
+        if (i->second->isRegister())
+            this->from[i->second].push_back(i->first);
+
+    for (auto i = this->slots.begin(); i != this->slots.end(); ++i)
+        this->stored[i->second].push_back(i->first);
+}
+
+Operand *CopyPropagation::evaluate(Tac *instruction)
+{
+    ILOCop opcode = instruction->getOpcode();
+    Operand *source_1 = NULL;
+    Operand *source_2 = NULL;
+    int result = 0;
+
+    switch (opcode)
+    {
+    case ILOC_ADD: // Both registers
+    case ILOC_SUB:
+    case ILOC_MULT:
+    case ILOC_DIV:
+    case ILOC_LSHIFT:
+    case ILOC_RSHIFT:
+    case ILOC_AND:
+    case ILOC_OR:
+    case ILOC_XOR:
+        source_1 = this->resolve(instruction->getArgument(0), false);
+        source_2 = this->resolve(instruction->getArgument(1), false);
+        break;
+    case ILOC_ADDI: // The register and the immediate
+    case ILOC_SUBI:
+    case ILOC_RSUBI:
+    case ILOC_MULTI:
+    case ILOC_DIVI:
+    case ILOC_RDIVI:
+    case ILOC_LSHIFTI:
+    case ILOC_RSHIFTI:
+    case ILOC_ANDI:
+    case ILOC_ORI:
+    case ILOC_XORI:
+        source_1 = this->resolve(instruction->getArgument(0), false);
+        source_2 = instruction->getArgument(1);
+        break;
+    default:
+        return NULL;
+    }
+
+    if (!source_1->isImmediate() || !source_2->isImmediate() ||
+        !CopyPropagation::fold(opcode, source_1->getValue(), source_2->getValue(), result))
+        return NULL;
+
+    return Tac::getImmediate(result);
+}
+
+bool CopyPropagation::propagate(Tac *instruction)
+{
+    ILOCop opcode = instruction->getOpcode();
+    Operand *args[3] = {instruction->getArgument(0), instruction->getArgument(1), instruction->getArgument(2)};
+    int reads = 0; // Arguments read as registers, from the first one
+    Operand *constant = this->evaluate(instruction);
+
+    // Arithmetic on constants only loads the result
+    if (constant != NULL)
+    {
+        instruction->rewrite(ILOC_LOADI, constant, instruction->getDefinition());
+        return true;
+    }
+
+    switch (opcode)
+    {
+    case ILOC_I2I: // Copies of a constant load it instead
+    {
+        Operand *source = this->resolve(args[0], false);
+
+        if (source == args[0])
+            return false;
+
+        instruction->rewrite(source->isImmediate() ? ILOC_LOADI : ILOC_I2I, source, args[1]);
+        return true;
+    }
+    case ILOC_ADD: // Constants go into the form with an immediate, if there is one
+    case ILOC_SUB:
+    case ILOC_MULT:
+    case ILOC_DIV:
+    case ILOC_LSHIFT:
+    case ILOC_RSHIFT:
+    case ILOC_AND:
+    case ILOC_OR:
+    case ILOC_XOR:
+    {
+        Operand *source_1 = this->resolve(args[0], false);
+        Operand *source_2 = this->resolve(args[1], false);
+        bool commutative = opcode == ILOC_ADD || opcode == ILOC_MULT || opcode == ILOC_AND || opcode == ILOC_OR || opcode == ILOC_XOR;
+        bool reversible = opcode == ILOC_SUB || opcode == ILOC_DIV; // Into rsubI and rdivI
+
+        if (!source_1->isImmediate() && source_2->isImmediate())
+        {
+            instruction->rewrite(CopyPropagation::getImmediateForm(opcode), source_1, source_2, args[2]);
+            return true;
+        }
+        else if (source_1->isImmediate() && !source_2->isImmediate() && (commutative || reversible))
+        {
+            ILOCop reverse = opcode == ILOC_SUB ? ILOC_RSUBI : ILOC_RDIVI;
+
+            instruction->rewrite(commutative ? CopyPropagation::getImmediateForm(opcode) : reverse, source_2, source_1, args[2]);
+            return true;
+        }
+
+        reads = 2;
+    }
+    break;
+    case ILOC_CMP_LT: // Registers only
+    case ILOC_CMP_LE:
+    case ILOC_CMP_EQ:
+    case ILOC_CMP_GE:
+    case ILOC_CMP_GT:
+    case ILOC_CMP_NE:
+        reads = 2;
+        break;
+    case ILOC_ADDI: // The register, not the immediate
+    case ILOC_SUBI:
+    case ILOC_RSUBI:
+    case ILOC_MULTI:
+    case ILOC_DIVI:
+    case ILOC_RDIVI:
+    case ILOC_LSHIFTI:
+    case ILOC_RSHIFTI:
+    case ILOC_ANDI:
+    case ILOC_ORI:
+    case ILOC_XORI:
+    case ILOC_STORE: // The value, not the address
+    case ILOC_STOREAI:
+    case ILOC_CBR:
+    case ILOC_JUMP:
+        reads = 1;
+        break;
+    default:
+        break;
+    }
+
+    bool rewritten = false;
+
+    for (int i = 0; i < reads; ++i)
+    {
+        Operand *source = this->resolve(args[i], true);
+
+        if (source != args[i])
+        {
+            args[i] = source;
+            rewritten = true;
+        }
+    }
+
+    if (rewritten)
+        instruction->rewrite(opcode, args[0], args[1], args[2]);
+
+    return rewritten;
+}
+
+void CopyPropagation::transfer(Tac *instruction, bool rewrite)
+{
+    int slot = DeadCode::getSlot(instruction);
+
+    if (rewrite && this->propagate(instruction))
+        this->propagated++;
+
+    ILOCop opcode = instruction->getOpcode();
+
+    switch (opcode)
+    {
+    case ILOC_LOAD: // A copy of what was stored to the variable
+    {
+        auto stored = this->slots.find(slot);
+        Operand *source = stored != this->slots.end() ? stored->second : NULL;
+        Operand *target = instruction->getArgument(1);
+
+        this->kill(target);
+
+        if (source != NULL && source != target)
+        {
+            if (rewrite)
+            {
+                // The address calculation before it is left dead
+                instruction->rewrite(ILOC_I2I, source, target);
+                this->propagate(instruction);
+                this->forwarded++;
+            }
+
+            this->setCopy(target, source);
+        }
+    }
+    break;
+    case ILOC_STORE: // The variable holds a copy of the value
+    case ILOC_STOREAI:
+        // Through an address from elsewhere, which may be any of them
+        if (ASM::isIndirect(instruction))
+            this->killSlots();
+        else if (slot >= 0)
+        {
+            this->slots.erase(slot);
+
+            if (instruction->getArgument(0)->isRegister())
+                this->setSlot(slot, instruction->getArgument(0));
+        }
+        break;
+    default:
+    {
+        Operand *target = instruction->getDefinition();
+        Operand *source = instruction->getArgument(0);
+
+        // Rewritten into a constant load already, when rewriting
+        Operand *constant = rewrite ? NULL : this->evaluate(instruction);
+
+        if (target != NULL)
+        {
+            this->kill(target);
+
+            // Copies of a register or a constant
+            if (constant != NULL)
+                this->setCopy(target, constant);
+            else if (((opcode == ILOC_I2I && source->isRegister()) || (opcode == ILOC_LOADI && source->isImmediate())) && source != target)
+                this->setCopy(target, source);
+        }
+
+        // Another frame, with other variables
+        if ((opcode == ILOC_I2I || opcode == ILOC_LOADI) && instruction->getArgument(1)->isBase(BASE_RFP))
+            this->killSlots();
+    }
+    break;
+    }
+}
@@ -0,0 +1,434 @@
+#include "DeadCode.h"
+#include "Tac.h"
+#include "ASM.h"
+
+DeadCode::DeadCode(TacList &code_, int register_count_, int locals_start_)
+{
+    this->code = &code_;
+    this->register_count = register_count_;
+    this->locals_start = locals_start_;
+    this->unreachable = 0;
+    this->nops = 0;
+    this->dead_stores = 0;
+    this->dead = 0;
+
+    // Dead stores leave their address calculation dead, so they go before dead instructions
+    this->removeUnreachable();
+    this->removeNops();
+    this->removeDeadStores();
+    this->removeDeadInstructions();
+}
+
+DeadCode::~DeadCode()
+{
+    // nil
+}
+
+int DeadCode::getRemovedCount()
+{
+    return this->unreachable + this->nops + this->dead_stores + this->dead;
+}
+
+std::string DeadCode::getStats()
+{
+    return "unreachable " + std::to_string(this->unreachable) + ", nops " + std::to_string(this->nops) +
+           ", dead stores " + std::to_string(this->dead_stores) + ", dead " + std::to_string(this->dead);
+}
+
+int DeadCode::getSlot(Tac *instruction)
+{
+    Tac *prev = instruction->getPrev();
+    int slot = -1;
+
+    switch (instruction->getOpcode())
+    {
+    case ILOC_LOAD: // Through the address calculated right before them
+    case ILOC_STORE:
+    {
+        Operand *address = instruction->getOpcode() == ILOC_LOAD ? instruction->getArgument(0) : instruction->getArgument(1);
+
+        if (ASM::isGlued(instruction) && prev->getArgument(0)->isBase(BASE_RFP) && prev->getArgument(2) == address)
+            slot = prev->getArgument(1)->getValue();
+    }
+    break;
+    case ILOC_LOADAI: // Such as parameters
+        if (instruction->getArgument(0)->isBase(BASE_RFP))
+            slot = instruction->getArgument(1)->getValue();
+        break;
+    case ILOC_STOREAI: // Such as parameters copied to their variable
+        if (instruction->getArgument(1)->isBase(BASE_RFP))
+            slot = instruction->getArgument(2)->getValue();
+        break;
+    default:
+        break;
+    }
+
+    return slot;
+}
+
+void DeadCode::transferSlots(Tac *instruction, Bitset &live)
+{
+    auto slot = this->slots.find(DeadCode::getSlot(instruction));
+
+    // Any of them may be read through an address from elsewhere
+    if (instruction->getOpcode() == ILOC_LOAD && ASM::isIndirect(instruction))
+    {
+        for (int i = 0; i < live.getSize(); ++i)
+            live.set(i);
+
+        return;
+    }
+
+    // Other addresses are Vector positions (Always global) or the rest of the frame
+    if (slot == this->slots.end())
+        return;
+
+    if (instruction->getOpcode() == ILOC_STORE || instruction->getOpcode() == ILOC_STOREAI)
+        live.reset(slot->second);
+    else
+        live.set(slot->second);
+}
+
+bool DeadCode::isPure(Tac *instruction)
+{
+    bool pure = false;
+
+    if (instruction->getDefinition() == NULL)
+        return false;
+
+    switch (instruction->getOpcode())
+    {
+    case ILOC_ADD: // Only write their register
+    case ILOC_SUB:
+    case ILOC_MULT:
+    case ILOC_DIV:
+    case ILOC_ADDI:
+    case ILOC_SUBI:
+    case ILOC_RSUBI:
+    case ILOC_MULTI:
+    case ILOC_DIVI:
+    case ILOC_RDIVI:
+    case ILOC_LSHIFT:
+    case ILOC_LSHIFTI:
+    case ILOC_RSHIFT:
+    case ILOC_RSHIFTI:
+    case ILOC_AND:
+    case ILOC_ANDI:
+    case ILOC_OR:
+    case ILOC_ORI:
+    case ILOC_XOR:
+    case ILOC_XORI:
+    case ILOC_LOAD:
+    case ILOC_LOADI:
+    case ILOC_LOADAI:
+    case ILOC_LOADA0:
+    case ILOC_I2I:
+    case ILOC_CMP_LT:
+    case ILOC_CMP_LE:
+    case ILOC_CMP_EQ:
+    case ILOC_CMP_GE:
+    case ILOC_CMP_GT:
+    case ILOC_CMP_NE:
+        pure = true;
+        break;
+    default:
+        break;
+    }
+
+    return pure;
+}
+
+bool DeadCode::remove(Tac *instruction)
+{
+    if (instruction->getLabel() != NULL)
+    {
+        // The label must go somewhere
+        if (instruction == this->code->getLast() || instruction->getNext()->getLabel() != NULL)
+            return false;
+
+        instruction->getNext()->setLabel(instruction->getLabel());
+    }
+
+    this->code->remove(instruction);
+
+    return true;
+}
+
+void DeadCode::removeUnreachable()
+{
+    CFG cfg(*this->code);
+
+    for (int block = 0; block < cfg.getBlockCount(); ++block)
+    {
+        BasicBlock *current_block = cfg.getBlock(block);
+
+        if (cfg.isReachable(block))
+            continue;
+
+        // Nothing that runs jumps to its labels either
+        Tac *end = current_block->getLast()->getNext();
+        Tac *next = NULL;
+
+        for (Tac *i = current_block->getFirst(); i != end; i = next)
+        {
+            next = i->getNext();
+
+            this->code->remove(i);
+            this->unreachable++;
+        }
+    }
+}
+
+void DeadCode::removeNops()
+{
+    Tac *next = NULL;
+
+    for (Tac *i = this->code->getFirst(); i != this->code->getLast(); i = next)
+    {
+        next = i->getNext();
+
+        if (i->getOpcode() == ILOC_NOP && this->remove(i))
+            this->nops++;
+    }
+}
+
+void DeadCode::removeDeadStores()
+{
+    Tac *end = this->code->getLast()->getNext();
+
+    // Number the local variables
+    for (Tac *i = this->code->getFirst(); i != end; i = i->getNext())
+    {
+        int slot = DeadCode::getSlot(i);
+
+        if (slot >= this->locals_start && !this->slots.count(slot))
+        {
+            int index = this->slots.size();
+            this->slots[slot] = index;
+        }
+    }
+
+    if (this->slots.empty())
+        return;
+
+    CFG cfg(*this->code);
+    std::vector<std::vector<int>> gen(cfg.getBlockCount());  // Variables each block loads before storing to them
+    std::vector<std::vector<int>> kill(cfg.getBlockCount()); // Variables each block stores to
+    std::vector<int> global(this->slots.size(), -1);         // Index among the variables loaded before being stored in some block
+    int global_count = 0;
+    Bitset seen(this->slots.size());
+
+    // Only the variables some block loads before storing to them can be live where a block starts
+    for (int block = 0; block < cfg.getBlockCount(); ++block)
+    {
+        BasicBlock *current_block = cfg.getBlock(block);
+
+        seen.clear();
+
+        for (Tac *i = current_block->getFirst(); i != current_block->getLast()->getNext(); i = i->getNext())
+        {
+            auto slot = this->slots.find(DeadCode::getSlot(i));
+
+            // Any of them may be read through an address from elsewhere
+            if (i->getOpcode() == ILOC_LOAD && ASM::isIndirect(i))
+            {
+                for (unsigned int j = 0; j < this->slots.size(); ++j)
+                    if (!seen.test(j))
+                    {
+                        seen.set(j);
+
+                        if (global[j] < 0)
+                            global[j] = global_count++;
+
+                        gen[block].push_back(j);
+                    }
+
+                continue;
+            }
+
+            if (slot == this->slots.end() || seen.test(slot->second))
+                continue;
+
+            seen.set(slot->second);
+
+            if (i->getOpcode() == ILOC_STORE || i->getOpcode() == ILOC_STOREAI)
+                kill[block].push_back(slot->second);
+            else
+            {
+                if (global[slot->second] < 0)
+                    global[slot->second] = global_count++;
+
+                gen[block].push_back(slot->second);
+            }
+        }
+    }
+
+    // Find the ones that may be loaded at the start of each block, revisiting the predecessors of those that change
+    std::vector<Bitset> live_in(cfg.getBlockCount(), Bitset(global_count));
+    std::vector<int> worklist(cfg.getReversePostOrder().begin(), cfg.getReversePostOrder().end());
+    std::vector<bool> queued(cfg.getBlockCount(), true);
+
+    while (!worklist.empty())
+    {
+        int block = worklist.back();
+        BasicBlock *current_block = cfg.getBlock(block);
+        Bitset live(global_count);
+
+        worklist.pop_back();
+        queued[block] = false;
+
+        for (auto s = current_block->getSuccessors().begin(); s != current_block->getSuccessors().end(); ++s)
+            live.unite(live_in[*s]);
+
+        for (auto i = kill[block].begin(); i != kill[block].end(); ++i)
+            if (global[*i] >= 0)
+                live.reset(global[*i]);
+
+        for (auto i = gen[block].begin(); i != gen[block].end(); ++i)
+            live.set(global[*i]);
+
+        if (live == live_in[block])
+            continue;
+
+        live_in[block] = live;
+
+        for (auto p = current_block->getPredecessors().begin(); p != current_block->getPredecessors().end(); ++p)
+            if (!queued[*p])
+            {
+                queued[*p] = true;
+                worklist.push_back(*p);
+            }
+    }
+
+    // And remove the stores to the ones that are not loaded after them
+    std::vector<int> local(global_count); // Local variable of each global index
+    Bitset live(this->slots.size());
+
+    for (unsigned int i = 0; i < global.size(); ++i)
+        if (global[i] >= 0)
+            local[global[i]] = i;
+
+    // (From the last block, so the instruction before each one is still in the code)
+    for (int block = cfg.getBlockCount() - 1; block >= 0; --block)
+    {
+        BasicBlock *current_block = cfg.getBlock(block);
+        Tac *stop = current_block->getFirst()->getPrev();
+        Tac *prev = NULL;
+
+        live.clear();
+
+        for (auto s = current_block->getSuccessors().begin(); s != current_block->getSuccessors().end(); ++s)
+            for (int i = live_in[*s].next(0); i < global_count; i = live_in[*s].next(i + 1))
+                live.set(local[i]);
+
+        for (Tac *i = current_block->getLast(); i != stop; i = prev)
+        {
+            auto slot = this->slots.find(DeadCode::getSlot(i));
+            bool store = i->getOpcode() == ILOC_STORE || i->getOpcode() == ILOC_STOREAI;
+
+            prev = i->getPrev();
+
+            if (store && slot != this->slots.end() && !live.test(slot->second) && this->remove(i))
+                this->dead_stores++;
+            else
+                this->transferSlots(i, live);
+        }
+    }
+}
+
+void DeadCode::removeDeadInstructions()
+{
+    std::vector<int> uses(this->register_count, 0);                    // Instructions reading each register, by the times they do
+    std::vector<std::vector<Tac *>> definitions(this->register_count); // Instructions writing each register
+    std::vector<int> worklist;                                         // Registers whose uses went down
+    std::unordered_set<Tac *> removed;
+    Tac *end = this->code->getLast()->getNext();
+
+    for (Tac *i = this->code->getFirst(); i != end; i = i->getNext())
+    {
+        std::list<Operand *> read = i->getUses();
+
+        for (auto j = read.begin(); j != read.end(); ++j)
+            uses[(*j)->getValue()]++;
+
+        if (i->getDefinition() != NULL)
+            definitions[i->getDefinition()->getValue()].push_back(i);
+    }
+
+    // Writes that another one overwrites in the same block, before any instruction reads them
+    CFG cfg(*this->code);
+    std::unordered_set<int> overwritten;
+
+    for (int block = cfg.getBlockCount() - 1; block >= 0; --block)
+    {
+        BasicBlock *current_block = cfg.getBlock(block);
+        Tac *stop = current_block->getFirst()->getPrev();
+        Tac *prev = NULL;
+
+        overwritten.clear();
+
+        for (Tac *i = current_block->getLast(); i != stop; i = prev)
+        {
+            prev = i->getPrev();
+
+            if (this->isPure(i) && overwritten.count(i->getDefinition()->getValue()) && this->remove(i))
+            {
+                this->dead++;
+                this->removeUses(i, uses, worklist);
+                removed.insert(i);
+                continue;
+            }
+
+            if (i->getDefinition() != NULL)
+                overwritten.insert(i->getDefinition()->getValue());
+
+            std::list<Operand *> read = i->getUses();
+
+            for (auto j = read.begin(); j != read.end(); ++j)
+                overwritten.erase((*j)->getValue());
+        }
+    }
+
+    // And the ones nothing else reads, which may leave the registers they read unused too
+    for (int i = 0; i < this->register_count; ++i)
+        worklist.push_back(i);
+
+    while (!worklist.empty())
+    {
+        int reg = worklist.back();
+
+        worklist.pop_back();
+
+        for (auto i = definitions[reg].begin(); i != definitions[reg].end(); ++i)
+        {
+            if (removed.count(*i) || !this->isPure(*i))
+                continue;
+
+            // (An instruction may read the register it writes, such as a counter)
+            std::list<Operand *> read = (*i)->getUses();
+            int own = 0;
+
+            for (auto j = read.begin(); j != read.end(); ++j)
+                if ((*j)->getValue() == reg)
+                    own++;
+
+            if (uses[reg] > own || !this->remove(*i))
+                continue;
+
+            this->dead++;
+            this->removeUses(*i, uses, worklist);
+            removed.insert(*i);
+        }
+    }
+}
+
+void DeadCode::removeUses(Tac *instruction, std::vector<int> &uses, std::vector<int> &worklist)
+{
+    std::list<Operand *> read = instruction->getUses();
+
+    for (auto i = read.begin(); i != read.end(); ++i)
+    {
+        uses[(*i)->getValue()]--;
+        worklist.push_back((*i)->getValue());
+    }
+}
@@ -1,17 +1,34 @@
 #include "Graph.h"
 
-Graph::Graph()
+#include <algorithm>
+
+Graph::Graph(unsigned int max_vertexes)
 {
     this->edge_count = 0;
     this->vertex_count = 0;
     this->used_colors_counter = 0;
+
+    // One bit for each pair of different vertexes
+    this->use_matrix = max_vertexes <= GRAPH_MATRIX_MAX_VERTEXES;
+
+    if (this->use_matrix)
+        this->matrix = Bitset(max_vertexes * (max_vertexes - 1) / 2);
+
+    this->V.reserve(max_vertexes);
+    this->C.reserve(max_vertexes);
 }
 
 Graph::Graph(Graph &graph)
 {
     this->V = graph.V;
-    this->E = graph.E;
+    this->vertex_ids = graph.vertex_ids;
     this->C = graph.C;
+    this->matrix = graph.matrix;
+    this->pairs = graph.pairs;
+    this->use_matrix = graph.use_matrix;
+    this->moves = graph.moves;
+    this->alias = graph.alias;
+    this->spilled = graph.spilled;
 
     this->edge_count = graph.edge_count;
     this->vertex_count = graph.vertex_count;
@@ -23,16 +40,31 @@ Graph::~Graph()
     // nil
 }
 
-void Graph::addVertex(std::string *name)
+uint64_t Graph::getPairIndex(unsigned int vertex_1, unsigned int vertex_2)
+{
+    uint64_t high = std::max(vertex_1, vertex_2);
+    uint64_t low = std::min(vertex_1, vertex_2);
+
+    // Row of the bigger vertex, column of the smaller
+    return high * (high - 1) / 2 + low;
+}
+
+void Graph::addVertex(Operand *reg, double cost)
 {
     // Create new vertex
-    Vertex v(name, this->vertex_count);
+    Vertex v(reg, this->vertex_count, -1, cost);
 
     // Create a new color
     Color c(this->vertex_count);
 
     // Add to vertex map
-    this->vertex_ids.insert(std::make_pair(name, this->vertex_count));
+    if ((unsigned int)reg->getValue() >= this->vertex_ids.size())
+        this->vertex_ids.resize(reg->getValue() + 1, -1);
+
+    this->vertex_ids[reg->getValue()] = this->vertex_count;
+
+    // Not merged into any other vertex
+    this->alias.push_back(this->vertex_count);
 
     // Increase vertex count
     this->vertex_count++;
@@ -44,24 +76,60 @@ void Graph::addVertex(std::string *name)
     this->C.push_back(c);
 }
 
-void Graph::addEdge(std::string *end_1, std::string *end_2)
+void Graph::addEdge(Operand *end_1, Operand *end_2)
 {
     // Get id for both vertexes
-    int v1 = this->vertex_ids[end_1];
-    int v2 = this->vertex_ids[end_2];
+    int v1 = this->vertex_ids[end_1->getValue()];
+    int v2 = this->vertex_ids[end_2->getValue()];
+
+    // Ignore loops and edges that already exist
+    if (v1 != v2 && !this->isAdjacent(v1, v2))
+        this->connect(v1, v2);
+}
+
+void Graph::connect(unsigned int vertex_1, unsigned int vertex_2)
+{
+    uint64_t index = this->getPairIndex(vertex_1, vertex_2);
 
-    // Create edge with both vertexes
-    Edge e(this->edge_count, 0, &this->V[v1], &this->V[v2]);
+    if (this->use_matrix)
+        this->matrix.set(index);
+    else
+        this->pairs.insert(index);
 
     // Increase edge counter
     this->edge_count++;
 
     // Add as adjacent to each other
-    this->V[v1].setAdjacent(v2);
-    this->V[v2].setAdjacent(v1);
+    this->V[vertex_1].setAdjacent(vertex_2);
+    this->V[vertex_2].setAdjacent(vertex_1);
+}
+
+void Graph::addMove(Operand *end_1, Operand *end_2)
+{
+    // Get id for both vertexes
+    int v1 = this->vertex_ids[end_1->getValue()];
+    int v2 = this->vertex_ids[end_2->getValue()];
 
-    // Add edge to list
-    this->E.push_back(e);
+    if (v1 != v2)
+        this->moves.push_back(std::make_pair(v1, v2));
+}
+
+void Graph::removeEdge(unsigned int vertex_1, unsigned int vertex_2)
+{
+    uint64_t index = this->getPairIndex(vertex_1, vertex_2);
+    std::vector<unsigned int> &adjacent_1 = this->V[vertex_1].getAdjacent();
+    std::vector<unsigned int> &adjacent_2 = this->V[vertex_2].getAdjacent();
+
+    if (this->use_matrix)
+        this->matrix.reset(index);
+    else
+        this->pairs.erase(index);
+
+    this->edge_count--;
+
+    // From the back, where coalescing takes the edges from (See coalesce)
+    adjacent_1.erase(std::next(std::find(adjacent_1.rbegin(), adjacent_1.rend(), vertex_2)).base());
+    adjacent_2.erase(std::next(std::find(adjacent_2.rbegin(), adjacent_2.rend(), vertex_1)).base());
 }
 
 uint Graph::getVertexCount()
@@ -79,12 +147,12 @@ uint Graph::getUsedColorCount()
     return this->used_colors_counter;
 }
 
-std::vector<Vertex> Graph::getVertexes()
+std::vector<Vertex> &Graph::getVertexes()
 {
     return this->V;
 }
 
-std::vector<Color> Graph::getColors()
+std::vector<Color> &Graph::getColors()
 {
     return this->C;
 }
@@ -102,11 +170,6 @@ std::vector<Color> Graph::getUsedColors()
     return new_vector;
 }
 
-std::vector<Edge> Graph::getEdges()
-{
-    return this->E;
-}
-
 Vertex *Graph::getVertex(unsigned int vertex_id)
 {
     return &this->V[vertex_id];
@@ -139,11 +202,26 @@ void Graph::cleanVertex(unsigned int vertex_id)
         this->used_colors_counter--;
 }
 
+bool Graph::isAdjacent(unsigned int vertex_1, unsigned int vertex_2)
+{
+    bool is_adjacent = false;
+
+    if (vertex_1 != vertex_2)
+    {
+        if (this->use_matrix)
+            is_adjacent = this->matrix.test(this->getPairIndex(vertex_1, vertex_2));
+        else
+            is_adjacent = this->pairs.count(this->getPairIndex(vertex_1, vertex_2)) > 0;
+    }
+
+    return is_adjacent;
+}
+
 bool Graph::canUse(unsigned int vertex_id, unsigned int color_id)
 {
     bool can_use = true;
 
-    std::vector<unsigned int> adjacent = this->V[vertex_id].getAdjacent();
+    std::vector<unsigned int> &adjacent = this->V[vertex_id].getAdjacent();
 
     for (auto i = adjacent.begin(); can_use && i != adjacent.end(); ++i)
         if (this->V[*i].getColor() == color_id)
@@ -162,7 +240,7 @@ std::string Graph::outputInfo()
 
     for (auto i = this->V.begin(); i != this->V.end(); ++i)
     {
-        info << "Vertex " << *i->getName() << " given color " << this->C[i->getColor()].getId() << std::endl;
+        info << "Vertex " << i->getRegister()->toString() << " given color " << this->C[i->getColor()].getId() << std::endl;
     }
 
     info << std::endl;
@@ -172,52 +250,241 @@ std::string Graph::outputInfo()
 
 bool Graph::minimizeRegisterUsage(int k)
 {
-    if (this->getVertexCount() > 0)
+    // Merge the vertexes of copies first, so they get the same color
+    this->coalesceMoves(k);
+
+    // Remove the vertexes from the graph
+    std::vector<unsigned int> removed = this->simplify(k);
+
+    // And put them back, coloring each one
+    this->select(removed, k);
+
+    return this->spilled.empty();
+}
+
+std::vector<Operand *> Graph::getSpilled()
+{
+    std::vector<Operand *> registers;
+
+    // Registers of the spilled vertexes, and of the ones merged into them
+    for (unsigned int i = 0; i < this->vertex_count; ++i)
+        if (this->V[this->getAlias(i)].getColor() >= this->vertex_count)
+            registers.push_back(this->V[i].getRegister());
+
+    return registers;
+}
+
+unsigned int Graph::getAlias(unsigned int vertex_id)
+{
+    while (this->alias[vertex_id] != vertex_id)
+        vertex_id = this->alias[vertex_id];
+
+    return vertex_id;
+}
+
+bool Graph::canCoalesce(unsigned int vertex_1, unsigned int vertex_2, unsigned int k)
+{
+    std::vector<unsigned int> &adjacent_1 = this->V[vertex_1].getAdjacent();
+    std::vector<unsigned int> &adjacent_2 = this->V[vertex_2].getAdjacent();
+    unsigned int significant = 0;
+
+    // The vertex with less neighbours can go into the other one if each of its neighbours
+    // already is the other one's, or has less than k (George's test, which is cheaper when
+    // the other one has many neighbours, such as a value kept for the whole function)
+    std::vector<unsigned int> &fewer = adjacent_1.size() <= adjacent_2.size() ? adjacent_1 : adjacent_2;
+    unsigned int other = adjacent_1.size() <= adjacent_2.size() ? vertex_2 : vertex_1;
+    bool safe = true;
+
+    for (auto i = fewer.begin(); i != fewer.end() && safe; ++i)
+        safe = this->isAdjacent(*i, other) || this->V[*i].getAdjacent().size() < k;
+
+    if (safe)
+        return true;
+
+    // Neighbours of the first vertex (The ones shared by both lose an edge when merging)
+    for (auto i = adjacent_1.begin(); i != adjacent_1.end(); ++i)
     {
-        // Set with every vertex id
-        std::vector<unsigned int> vertex_ids;
-        for (unsigned int i = 0; i < this->getVertexCount(); ++i)
-            vertex_ids.push_back(i);
+        unsigned int degree = this->V[*i].getAdjacent().size();
 
-        // Randomize a vertex
-        unsigned int v_i = random() % vertex_ids.size();
+        if (this->isAdjacent(*i, vertex_2))
+            degree--;
 
-        // Give color 0 to vertex
-        this->colorVertex(v_i, 0);
+        if (degree >= k)
+            significant++;
+    }
 
-        // Remove vertex from list
-        vertex_ids.erase(vertex_ids.begin() + v_i);
+    // Neighbours of the second vertex alone
+    for (auto i = adjacent_2.begin(); i != adjacent_2.end(); ++i)
+        if (!this->isAdjacent(*i, vertex_1) && this->V[*i].getAdjacent().size() >= k)
+            significant++;
 
-        // Iterate remaining vertexes
-        for (unsigned int i = 0; i < this->getVertexCount() - 1; ++i)
+    return significant < k;
+}
+
+void Graph::coalesce(unsigned int vertex_1, unsigned int vertex_2)
+{
+    // Move the second vertex's edges to the first
+    while (!this->V[vertex_2].getAdjacent().empty())
+    {
+        unsigned int neighbour = this->V[vertex_2].getAdjacent().back();
+
+        this->removeEdge(vertex_2, neighbour);
+
+        if (!this->isAdjacent(vertex_1, neighbour))
+            this->connect(vertex_1, neighbour);
+    }
+
+    this->alias[vertex_2] = vertex_1;
+}
+
+void Graph::coalesceMoves(unsigned int k)
+{
+    bool changed = true;
+
+    // Merging some vertexes may let others pass the test, so repeat until none do
+    while (changed)
+    {
+        changed = false;
+
+        for (auto i = this->moves.begin(); i != this->moves.end(); ++i)
         {
-            // Sample random vertex
-            v_i = random() % vertex_ids.size();
+            unsigned int v1 = this->getAlias(i->first);
+            unsigned int v2 = this->getAlias(i->second);
 
-            // Iterate colors
-            for (unsigned int j = 0; j < this->getVertexCount(); ++j)
+            // Keep the vertex with the most neighbours (The other one's edges are moved
+            // to it), then the one with the smallest id
+            if (this->V[v2].getAdjacent().size() > this->V[v1].getAdjacent().size() ||
+                (this->V[v2].getAdjacent().size() == this->V[v1].getAdjacent().size() && v2 < v1))
+                std::swap(v1, v2);
+
+            if (v1 != v2 && !this->isAdjacent(v1, v2) && this->canCoalesce(v1, v2, k))
             {
-                // If vertex can use color
-                if (this->canUse(vertex_ids[v_i], j))
-                {
-                    // Give color to vertex
-                    this->colorVertex(vertex_ids[v_i], j);
-
-                    // Exit color looping
-                    j = this->getVertexCount();
-                }
+                this->coalesce(v1, v2);
+                this->V[v1].setCost(this->V[v1].getCost() + this->V[v2].getCost());
+                changed = true;
             }
+        }
+    }
+}
+
+std::vector<unsigned int> Graph::simplify(unsigned int k)
+{
+    std::vector<unsigned int> removed;
+    std::vector<unsigned int> degree(this->vertex_count);
+    std::vector<bool> present(this->vertex_count, false);
+
+    std::vector<unsigned int> low; // Vertexes with less than k neighbours
 
-            // Remove vertex from list
-            vertex_ids.erase(vertex_ids.begin() + v_i);
+    // The others, cheapest to spill (Cost per neighbour) first, then by id
+    std::priority_queue<std::pair<double, unsigned int>, std::vector<std::pair<double, unsigned int>>,
+                        std::greater<std::pair<double, unsigned int>>>
+        high;
+
+    // Find the degree of every vertex that was not merged into another
+    for (unsigned int i = this->vertex_count; i-- > 0;)
+    {
+        if (this->alias[i] == i)
+        {
+            degree[i] = this->V[i].getAdjacent().size();
+            present[i] = true;
+
+            if (degree[i] < k)
+                low.push_back(i);
+            else
+                high.push(std::make_pair(this->V[i].getCost() / degree[i], i));
         }
     }
-    return this->getUsedColorCount() <= (unsigned int)k;
+
+    while (!low.empty() || !high.empty())
+    {
+        unsigned int vertex;
+
+        // Remove a vertex that is sure to get a color, if there is one
+        if (!low.empty())
+        {
+            vertex = low.back();
+            low.pop_back();
+        }
+        // Otherwise the cheapest one to spill, hoping it still gets a color
+        else
+        {
+            vertex = high.top().second;
+            double queued_cost = high.top().first;
+            high.pop();
+
+            // Skip vertexes already removed
+            if (!present[vertex])
+                continue;
+
+            // Degrees only go down (And costs per neighbour up), requeue it if it
+            // lost neighbours since queued
+            if (queued_cost != this->V[vertex].getCost() / degree[vertex])
+            {
+                high.push(std::make_pair(this->V[vertex].getCost() / degree[vertex], vertex));
+                continue;
+            }
+        }
+
+        present[vertex] = false;
+        removed.push_back(vertex);
+
+        // Its neighbours lose an edge
+        std::vector<unsigned int> &adjacent = this->V[vertex].getAdjacent();
+
+        for (auto i = adjacent.begin(); i != adjacent.end(); ++i)
+        {
+            if (present[*i])
+            {
+                degree[*i]--;
+
+                if (degree[*i] == k - 1)
+                    low.push_back(*i);
+            }
+        }
+    }
+
+    return removed;
+}
+
+void Graph::select(std::vector<unsigned int> &removed, unsigned int k)
+{
+    // Colors taken by the neighbours of the vertex being colored
+    std::vector<bool> taken(this->vertex_count + 1, false);
+
+    for (auto i = removed.rbegin(); i != removed.rend(); ++i)
+    {
+        std::vector<unsigned int> &adjacent = this->V[*i].getAdjacent();
+        unsigned int color = 0;
+
+        // Mark the colors of its neighbours
+        for (auto j = adjacent.begin(); j != adjacent.end(); ++j)
+            if (this->V[*j].getColor() < this->vertex_count)
+                taken[this->V[*j].getColor()] = true;
+
+        // Give it the first color none of them uses, if there is one
+        while (color < k && taken[color])
+            color++;
+
+        if (color < k)
+            this->colorVertex(*i, color);
+        else
+            this->spilled.push_back(*i);
+
+        // Unmark them for the next vertex
+        for (auto j = adjacent.begin(); j != adjacent.end(); ++j)
+            if (this->V[*j].getColor() < this->vertex_count)
+                taken[this->V[*j].getColor()] = false;
+    }
+
+    // Merged vertexes take the color of the vertex they were merged into
+    for (unsigned int i = 0; i < this->vertex_count; ++i)
+        if (this->alias[i] != i && this->V[this->getAlias(i)].getColor() < k)
+            this->colorVertex(i, this->V[this->getAlias(i)].getColor());
 }
 
-std::map<std::string *, std::string> Graph::getColorMapping()
+std::vector<std::string> Graph::getColorMapping()
 {
-    std::map<std::string *, std::string> translation;
+    std::vector<std::string> translation(this->vertex_ids.size());
 
     for (auto i = this->V.begin(); i != this->V.end(); ++i)
     {
@@ -226,7 +493,7 @@ std::map<std::string *, std::string> Graph::getColorMapping()
         regname << "\%r" << X86_64_REGCOUNT + i->getColor();
 
         // Add to translation map
-        translation.insert(std::make_pair(i->getName(), regname.str()));
+        translation[i->getRegister()->getValue()] = regname.str();
     }
 
     return translation;
@@ -0,0 +1,337 @@
+#include "Inliner.h"
+#include "Tac.h"
+#include "TacArena.h"
+
+int Inliner::threshold = 24;
+std::unordered_map<int, Symbol *> Inliner::functions;
+
+Inliner::Inliner(Symbol *function_, TacList &code_)
+{
+    this->function = function_;
+    this->code = &code_;
+    this->inlined = 0;
+    this->extra_size = 0;
+
+    Tac *end = code_.getLast()->getNext();
+    Tac *allocate_frame = code_.getFirst()->getNext(); // addI rsp, frame_size => rsp
+    std::vector<Tac *> calls;
+
+    this->frame_size = allocate_frame->getArgument(1)->getValue();
+
+    if (Inliner::threshold <= 0)
+        return;
+
+    for (Tac *i = code_.getFirst()->getNext(); i != end; i = i->getNext())
+        if (i->getLabel() != NULL)
+            this->labels.insert(i->getLabel()->getValue());
+
+    // The calls are found before any is inlined, the inlined code's own calls were already considered
+    for (Tac *i = code_.getFirst(); i != end; i = i->getNext())
+        if (i->getOpcode() == ILOC_ADDI && i->getArgument(0)->isBase(BASE_RPC))
+            calls.push_back(i);
+
+    for (auto i = calls.begin(); i != calls.end(); ++i)
+        this->inlineCall(*i);
+
+    // Make room for the local variables of the inlined functions
+    if (this->extra_size > 0)
+        allocate_frame->rewrite(ILOC_ADDI, allocate_frame->getArgument(0), Tac::getImmediate(this->frame_size + this->extra_size),
+                                allocate_frame->getArgument(2));
+}
+
+Inliner::~Inliner()
+{
+    // nil
+}
+
+int Inliner::getInlinedCount()
+{
+    return this->inlined;
+}
+
+std::vector<std::string> Inliner::getLog()
+{
+    return this->log;
+}
+
+void Inliner::setThreshold(int threshold_)
+{
+    Inliner::threshold = threshold_;
+}
+
+void Inliner::addFunction(Symbol *function)
+{
+    Inliner::functions[function->getLabel()->getValue()] = function;
+}
+
+void Inliner::discard(Tac *instruction)
+{
+    if (instruction->getLabel() != NULL)
+        instruction->rewrite(ILOC_NOP, NULL);
+    else
+        this->code->remove(instruction);
+}
+
+int Inliner::getInlinedSize(Symbol *callee)
+{
+    TacList callee_code = callee->getCode();
+    int return_offset = 3 * getSize(TYPE_INT) + callee->getParams().size() * getSize(TYPE_INT);
+    int locals_start = return_offset + getSize(TYPE_INT);
+    int size = 0;
+
+    std::unordered_set<int> callee_labels; // Labels in the called function, other than its own
+    Tac *first = callee_code.getFirst()->getNext()->getNext();
+    Tac *end = callee_code.getLast()->getNext();
+
+    for (Tac *i = first; i != end; i = i->getNext())
+        if (i->getLabel() != NULL)
+            callee_labels.insert(i->getLabel()->getValue());
+
+    for (Tac *i = first; i != end; i = i->getNext())
+    {
+        ILOCop opcode = i->getOpcode();
+
+        for (int j = 0; j < 3; ++j)
+        {
+            Operand *argument = i->getArgument(j);
+            int offset = j == 0 && i->getArgument(1) != NULL ? i->getArgument(1)->getValue() : -1;
+            bool valid = true;
+
+            if (argument == NULL)
+                continue;
+
+            if (argument->isLabel())
+                // Jumps within the function, or calls to other functions
+                valid = callee_labels.count(argument->getValue()) ||
+                        (argument->getValue() != callee->getLabel()->getValue() && Inliner::functions.count(argument->getValue()));
+            else if (argument->isBase(BASE_RPC))
+                // Return address of a call
+                valid = opcode == ILOC_ADDI && j == 0;
+            else if (argument->isBase(BASE_RSP))
+                // Frame of a function it calls, or restoring the caller's on return
+                valid = (opcode == ILOC_STOREAI && (j == 1 || i->getArgument(1)->isBase(BASE_RSP))) ||
+                        (opcode == ILOC_LOADAI && j == 0) || (opcode == ILOC_I2I && j == 1);
+            else if (argument->isBase(BASE_RFP))
+            {
+                if (opcode == ILOC_LOADAI && j == 0)
+                    // Return address, old rsp and rfp, arguments and local variables
+                    valid = offset != return_offset;
+                else if (opcode == ILOC_STOREAI && j == 1)
+                    // Return value and local variables
+                    valid = i->getArgument(2)->getValue() >= return_offset;
+                else if (opcode == ILOC_ADDI && j == 0)
+                    // Address of a local variable
+                    valid = offset >= locals_start;
+                else
+                    // Restoring the caller's frame on return, or saving its own before a call
+                    valid = (opcode == ILOC_I2I && j == 1) || (opcode == ILOC_STOREAI && j == 0 && i->getArgument(1)->isBase(BASE_RSP));
+            }
+
+            if (!valid)
+                return -1;
+        }
+
+        // The return sequence is not copied, other than the returned value
+        if (opcode == ILOC_LOADAI && i->getArgument(0)->isBase(BASE_RFP) && i->getArgument(1)->getValue() < 3 * getSize(TYPE_INT))
+            continue;
+        if ((opcode == ILOC_I2I && !i->getArgument(1)->isRegister()) || (opcode == ILOC_JUMP && i == callee_code.getLast()))
+            continue;
+
+        size++;
+    }
+
+    return size;
+}
+
+void Inliner::inlineCall(Tac *start)
+{
+    Tac *end = this->code->getLast()->getNext();
+    Tac *call = start;         // Jump to the called function
+    std::vector<Tac *> header; // Stores of the return address, rsp and rfp
+    std::vector<Tac *> stores; // Stores of the arguments, in the order they are stored
+    int pending = 1;           // Calls not reached yet, the arguments may call functions too
+
+    while (pending > 0 && call->getNext() != end)
+    {
+        call = call->getNext();
+
+        if (call->getOpcode() == ILOC_ADDI && call->getArgument(0)->isBase(BASE_RPC))
+            pending++;
+        else if (call->getOpcode() == ILOC_JUMPI && !this->labels.count(call->getArgument(0)->getValue()))
+            pending--;
+        else if (pending == 1 && call->getOpcode() == ILOC_STOREAI && call->getArgument(1)->isBase(BASE_RSP))
+        {
+            if (call->getArgument(2)->getValue() < 3 * getSize(TYPE_INT))
+                header.push_back(call);
+            else
+                stores.push_back(call);
+        }
+    }
+
+    if (pending > 0)
+        return;
+
+    // Calls to itself are not in the table yet, as it is only added once optimized
+    if (call->getArgument(0)->getValue() == this->function->getLabel()->getValue())
+    {
+        this->log.push_back("kept call to " + std::string(this->function->getName()) + " (recursive)");
+        return;
+    }
+
+    if (!Inliner::functions.count(call->getArgument(0)->getValue()))
+        return;
+
+    Symbol *callee = Inliner::functions[call->getArgument(0)->getValue()];
+    Tac *result_load = call->getNext(); // loadAI rsp, return_offset => result
+    std::string name = callee->getName();
+
+    if (stores.size() != callee->getParams().size())
+        return;
+
+    int size = this->getInlinedSize(callee);
+
+    if (size < 0)
+    {
+        this->log.push_back("kept call to " + name + " (recursive, or uses its frame)");
+        return;
+    }
+
+    if (size > Inliner::threshold)
+    {
+        this->log.push_back("kept call to " + name + " (" + std::to_string(size) + " instructions, over the threshold of " +
+                            std::to_string(Inliner::threshold) + ")");
+        return;
+    }
+
+    //
+
+    TacList callee_code = callee->getCode();
+    Tac *allocate_frame = callee_code.getFirst()->getNext(); // addI rsp, frame_size => rsp
+    Tac *first = allocate_frame->getNext();
+    Tac *callee_end = callee_code.getLast()->getNext();
+
+    int return_offset = 3 * getSize(TYPE_INT) + callee->getParams().size() * getSize(TYPE_INT);
+    int locals_start = return_offset + getSize(TYPE_INT);
+    int relocation = this->frame_size - locals_start; // Added to the offset of each of its local variables
+
+    Operand *rfp = Operand::getBase(BASE_RFP);
+    Operand *result = result_load->getArgument(2);
+    Operand *join = NULL; // Label after the call, where returns go
+
+    std::vector<Operand *> registers(callee->getArena()->getRegisterCount(), NULL); // Copy of each register
+    std::unordered_map<int, Operand *> labels;                                      // Copy of each label
+    std::vector<Operand *> arguments(callee->getParams().size(), NULL);             // Register with each argument
+
+    // The arguments go to registers instead of the new frame
+    for (auto i = stores.begin(); i != stores.end(); ++i)
+    {
+        Operand *argument = Tac::newRegister();
+
+        arguments[((*i)->getArgument(2)->getValue() - 3 * getSize(TYPE_INT)) / getSize(TYPE_INT)] = argument;
+        (*i)->rewrite(ILOC_I2I, (*i)->getArgument(0), argument); // i2i t2 => argument
+    }
+
+    for (Tac *i = first; i != callee_end; i = i->getNext())
+        if (i->getLabel() != NULL)
+        {
+            labels[i->getLabel()->getValue()] = Tac::newLabel();
+            this->labels.insert(labels[i->getLabel()->getValue()]->getValue());
+        }
+
+    for (Tac *i = first; i != callee_end; i = i->getNext())
+    {
+        Tac *copy = NULL;
+        Operand *copies[3] = {NULL, NULL, NULL};
+        ILOCop opcode = i->getOpcode();
+
+        for (int j = 0; j < 3; ++j)
+        {
+            Operand *argument = i->getArgument(j);
+
+            if (argument == NULL)
+                continue;
+
+            if (argument->isRegister())
+            {
+                if (registers[argument->getValue()] == NULL)
+                    registers[argument->getValue()] = Tac::newRegister();
+
+                copies[j] = registers[argument->getValue()];
+            }
+            else if (argument->isImmediate())
+                copies[j] = Tac::getImmediate(argument->getValue());
+            else if (argument->isLabel())
+                copies[j] = labels.count(argument->getValue()) ? labels[argument->getValue()] : Inliner::functions[argument->getValue()]->getLabel();
+            else
+                copies[j] = argument;
+        }
+
+        if (opcode == ILOC_LOADAI && i->getArgument(0)->isBase(BASE_RFP))
+        {
+            int offset = i->getArgument(1)->getValue();
+
+            if (offset >= locals_start)
+                copy = new Tac(ILOC_LOADAI, rfp, Tac::getImmediate(offset + relocation), copies[2]); // Local variable
+            else if (offset >= 3 * getSize(TYPE_INT))
+                copy = new Tac(ILOC_I2I, arguments[(offset - 3 * getSize(TYPE_INT)) / getSize(TYPE_INT)], copies[2]); // Argument
+        }
+        else if (opcode == ILOC_STOREAI && i->getArgument(1)->isBase(BASE_RFP))
+        {
+            int offset = i->getArgument(2)->getValue();
+
+            if (offset >= locals_start)
+                copy = new Tac(ILOC_STOREAI, copies[0], rfp, Tac::getImmediate(offset + relocation)); // Local variable
+            else
+                copy = new Tac(ILOC_I2I, copies[0], result); // Returned value
+        }
+        else if (opcode == ILOC_ADDI && i->getArgument(0)->isBase(BASE_RFP))
+            copy = new Tac(ILOC_ADDI, rfp, Tac::getImmediate(i->getArgument(1)->getValue() + relocation), copies[2]);
+        else if (opcode == ILOC_JUMP)
+        {
+            // Returns go to the instruction after the call, the last one gets there by itself
+            if (i != callee_code.getLast())
+            {
+                if (join == NULL)
+                    join = Tac::newLabel();
+
+                copy = new Tac(ILOC_JUMPI, join);
+            }
+        }
+        else if (opcode != ILOC_I2I || copies[1]->isRegister())
+            copy = new Tac(opcode, copies[0], copies[1], copies[2]);
+
+        // Restoring the caller's frame is left out, but not the labels on it
+        if (i->getLabel() != NULL)
+        {
+            if (copy == NULL)
+                copy = new Tac(ILOC_NOP);
+
+            copy->setLabel(labels[i->getLabel()->getValue()]);
+        }
+
+        if (copy != NULL)
+            this->code->insertBefore(result_load, copy);
+    }
+
+    // The calling sequence is no longer needed
+    for (auto i = header.begin(); i != header.end(); ++i)
+        this->discard(*i);
+
+    this->discard(start);
+    this->discard(call);
+
+    if (join != NULL)
+    {
+        result_load->rewrite(ILOC_NOP, NULL);
+        result_load->setLabel(join);
+        this->labels.insert(join->getValue());
+    }
+    else
+        this->code->remove(result_load);
+
+    if (allocate_frame->getArgument(1)->getValue() - locals_start > this->extra_size)
+        this->extra_size = allocate_frame->getArgument(1)->getValue() - locals_start;
+
+    this->inlined++;
+    this->log.push_back("inlined call to " + name + " (" + std::to_string(size) + " instructions)");
+}
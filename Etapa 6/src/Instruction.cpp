@@ -0,0 +1,172 @@
+#include "Instruction.h"
+
+std::string Instruction::getLowRegister(std::string reg)
+{
+    // Numbered registers get a suffix (%r8 => %r8d)
+    if (reg.size() > 2 && isdigit(reg[2]))
+        return reg.back() == 'd' ? reg : reg + "d";
+
+    // Named ones a prefix (%rax => %eax)
+    if (reg.size() > 1 && reg[1] == 'r')
+        return "%e" + reg.substr(2);
+
+    return reg;
+}
+
+std::string Instruction::getByteRegister(std::string reg)
+{
+    // Numbered registers get a suffix (%r8 => %r8b)
+    if (reg.size() > 2 && isdigit(reg[2]))
+        return reg + "b";
+
+    // The first four named ones replace it (%rax => %al)
+    if (reg.back() == 'x')
+        return "%" + reg.substr(2, 1) + "l";
+
+    // And the others add to it (%rdi => %dil)
+    return "%" + reg.substr(2) + "l";
+}
+
+Instruction::Instruction(std::string opcode_, std::vector<std::string> operands_)
+{
+    this->kind = INSTRUCTION_OPERATION;
+    this->text = opcode_;
+    this->operands = operands_;
+}
+
+Instruction::Instruction(InstructionKind kind_, std::string text_)
+{
+    this->kind = kind_;
+    this->text = text_;
+}
+
+Instruction::~Instruction()
+{
+    // nil
+}
+
+InstructionKind Instruction::getKind()
+{
+    return this->kind;
+}
+
+bool Instruction::isOperation(std::string opcode_)
+{
+    return this->kind == INSTRUCTION_OPERATION && (opcode_.empty() || this->text == opcode_);
+}
+
+bool Instruction::isLabel()
+{
+    return this->kind == INSTRUCTION_LABEL;
+}
+
+bool Instruction::isComment()
+{
+    return this->kind == INSTRUCTION_COMMENT;
+}
+
+std::string Instruction::getText()
+{
+    return this->text;
+}
+
+int Instruction::getOperandCount()
+{
+    return this->operands.size();
+}
+
+std::string Instruction::getOperand(int index)
+{
+    return this->operands[index];
+}
+
+bool Instruction::isRegister(int index)
+{
+    return this->operands[index][0] == '%';
+}
+
+bool Instruction::isImmediate(int index)
+{
+    return this->operands[index][0] == '$';
+}
+
+bool Instruction::isMemory(int index)
+{
+    return this->operands[index].find('(') != std::string::npos;
+}
+
+bool Instruction::isJump()
+{
+    return this->isOperation() && this->text[0] == 'j';
+}
+
+bool Instruction::readsFlags()
+{
+    // Conditional jumps, sets and moves
+    return this->isOperation() && ((this->isJump() && this->text != "jmp") ||
+                                   !this->text.compare(0, 3, "set") || !this->text.compare(0, 4, "cmov"));
+}
+
+bool Instruction::writesFlags()
+{
+    // Arithmetic, logic and comparisons (mov, lea, push, pop and jumps keep them)
+    static const std::vector<std::string> prefixes = {"add", "sub", "imul", "idiv", "cmp", "test", "xor", "and", "or", "neg", "inc", "dec", "sa", "sh"};
+
+    for (auto i = prefixes.begin(); this->isOperation() && i != prefixes.end(); ++i)
+        if (!this->text.compare(0, i->size(), *i))
+            return true;
+
+    return false;
+}
+
+std::string Instruction::toString()
+{
+    std::string line;
+    Writer out(line);
+
+    this->write(out);
+
+    return line;
+}
+
+void Instruction::write(Writer &out)
+{
+    switch (this->kind)
+    {
+    case INSTRUCTION_OPERATION:
+        out << '\t' << this->text;
+
+        for (unsigned int i = 0; i < this->operands.size(); ++i)
+            out << (i == 0 ? " " : ", ") << this->operands[i];
+        break;
+    case INSTRUCTION_LABEL:
+        out << this->text << ": ";
+        break;
+    case INSTRUCTION_COMMENT:
+    {
+        // Comment out every line of the text
+        size_t start = 0;
+
+        for (size_t end = this->text.find('\n'); start < this->text.size(); end = this->text.find('\n', start))
+        {
+            if (end == std::string::npos)
+                end = this->text.size();
+
+            out << (start == 0 ? "" : "\n") << "\t# ";
+            out.write(this->text.data() + start, end - start);
+            start = end + 1;
+        }
+    }
+    break;
+    }
+}
+
+void Instruction::setText(std::string text_)
+{
+    this->text = text_;
+}
+
+void Instruction::setOperand(int index, std::string operand)
+{
+    this->operands[index] = operand;
+}
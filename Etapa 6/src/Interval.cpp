@@ -0,0 +1,54 @@
+#include "Interval.h"
+
+Interval::Interval(Operand *reg_, double cost_)
+{
+    this->reg = reg_;
+    this->start = -1;
+    this->end = -1;
+    this->cost = cost_;
+    this->color = -1;
+}
+
+Interval::~Interval()
+{
+    // nil
+}
+
+Operand *Interval::getRegister()
+{
+    return this->reg;
+}
+
+int Interval::getStart()
+{
+    return this->start;
+}
+
+int Interval::getEnd()
+{
+    return this->end;
+}
+
+double Interval::getCost()
+{
+    return this->cost;
+}
+
+int Interval::getColor()
+{
+    return this->color;
+}
+
+void Interval::extend(int position)
+{
+    if (this->start == -1 || position < this->start)
+        this->start = position;
+
+    if (position > this->end)
+        this->end = position;
+}
+
+void Interval::setColor(int color_)
+{
+    this->color = color_;
+}
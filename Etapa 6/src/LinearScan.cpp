@@ -0,0 +1,153 @@
+#include "LinearScan.h"
+
+#include <algorithm>
+
+LinearScan::LinearScan(int register_count)
+{
+    this->interval_ids.assign(register_count, -1);
+    this->used_colors_counter = 0;
+}
+
+LinearScan::~LinearScan()
+{
+    // nil
+}
+
+void LinearScan::addInterval(Operand *reg, double cost)
+{
+    this->interval_ids[reg->getValue()] = this->intervals.size();
+    this->intervals.push_back(Interval(reg, cost));
+    this->hints.push_back(-1);
+}
+
+void LinearScan::extend(Operand *reg, int position)
+{
+    this->intervals[this->interval_ids[reg->getValue()]].extend(position);
+}
+
+void LinearScan::addMove(Operand *source, Operand *destination)
+{
+    int interval = this->interval_ids[destination->getValue()];
+
+    // The first copy found is the one followed
+    if (this->hints[interval] == -1)
+        this->hints[interval] = this->interval_ids[source->getValue()];
+}
+
+unsigned int LinearScan::getIntervalCount()
+{
+    return this->intervals.size();
+}
+
+unsigned int LinearScan::getUsedColorCount()
+{
+    return this->used_colors_counter;
+}
+
+std::vector<Operand *> LinearScan::getSpilled()
+{
+    std::vector<Operand *> registers;
+
+    for (auto i = this->spilled.begin(); i != this->spilled.end(); ++i)
+        registers.push_back(this->intervals[*i].getRegister());
+
+    return registers;
+}
+
+std::vector<std::string> LinearScan::getColorMapping()
+{
+    std::vector<std::string> translation(this->interval_ids.size());
+
+    for (auto i = this->intervals.begin(); i != this->intervals.end(); ++i)
+    {
+        if (i->getColor() != -1)
+        {
+            // Make register name
+            std::stringstream regname;
+            regname << "\%r" << X86_64_REGCOUNT + i->getColor();
+
+            // Add to translation map
+            translation[i->getRegister()->getValue()] = regname.str();
+        }
+    }
+
+    return translation;
+}
+
+bool LinearScan::allocateRegisters(int k)
+{
+    std::vector<unsigned int> order;               // Intervals, in the order they start
+    std::set<std::pair<int, unsigned int>> active; // Intervals holding a register, in the order they end
+    std::vector<bool> free(k, true);               // Registers not held by any interval
+    std::vector<bool> used(k, false);              // Registers given to some interval
+
+    for (unsigned int i = 0; i < this->intervals.size(); ++i)
+        if (this->intervals[i].getStart() != -1)
+            order.push_back(i);
+
+    std::sort(order.begin(), order.end(), [this](unsigned int i1, unsigned int i2) {
+        return std::make_pair(this->intervals[i1].getStart(), i1) < std::make_pair(this->intervals[i2].getStart(), i2);
+    });
+
+    for (auto i = order.begin(); i != order.end(); ++i)
+    {
+        Interval &current = this->intervals[*i];
+        int hint = this->hints[*i];
+        int color = -1;
+
+        // Give back the registers of intervals that are over
+        while (!active.empty() && active.begin()->first < current.getStart())
+        {
+            free[this->intervals[active.begin()->second].getColor()] = true;
+            active.erase(active.begin());
+        }
+
+        // Take the register of the copy's source, if it ends here
+        if (hint != -1 && this->intervals[hint].getColor() != -1 && this->intervals[hint].getEnd() == current.getStart() &&
+            active.count(std::make_pair(this->intervals[hint].getEnd(), (unsigned int)hint)))
+        {
+            color = this->intervals[hint].getColor();
+            active.erase(std::make_pair(this->intervals[hint].getEnd(), (unsigned int)hint));
+        }
+
+        // Or the first free one
+        for (int j = 0; color == -1 && j < k; ++j)
+            if (free[j])
+                color = j;
+
+        // Or the one of the active interval that ends last, if that is after the current one
+        if (color == -1)
+        {
+            auto victim = active.rbegin();
+
+            // Skipping the ones that cannot be spilled
+            while (victim != active.rend() && std::isinf(this->intervals[victim->second].getCost()))
+                ++victim;
+
+            if (victim != active.rend() && (victim->first > current.getEnd() || std::isinf(current.getCost())))
+            {
+                color = this->intervals[victim->second].getColor();
+                this->intervals[victim->second].setColor(-1);
+                this->spilled.push_back(victim->second);
+                active.erase(*victim);
+            }
+            else
+            {
+                this->spilled.push_back(*i);
+                continue;
+            }
+        }
+
+        current.setColor(color);
+        free[color] = false;
+        active.insert(std::make_pair(current.getEnd(), *i));
+
+        if (!used[color])
+        {
+            used[color] = true;
+            this->used_colors_counter++;
+        }
+    }
+
+    return this->spilled.empty();
+}
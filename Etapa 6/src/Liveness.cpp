@@ -0,0 +1,118 @@
+#include "Liveness.h"
+#include "Tac.h"
+
+void Liveness::transfer(Tac *instruction, Bitset &live)
+{
+    Operand *definition = instruction->getDefinition();
+
+    // The written register is dead before the instruction
+    if (definition != NULL)
+        live.reset(definition->getValue());
+
+    // And the ones read are live
+    std::list<Operand *> uses = instruction->getUses();
+
+    for (auto i = uses.begin(); i != uses.end(); ++i)
+        live.set((*i)->getValue());
+}
+
+//
+
+Liveness::Liveness(CFG *cfg_, int register_count)
+{
+    std::vector<int> order; // Blocks in the order they are visited
+    bool changed = true;
+
+    this->cfg = cfg_;
+
+    this->used.assign(cfg_->getBlockCount(), Bitset(register_count));
+    this->defined.assign(cfg_->getBlockCount(), Bitset(register_count));
+    this->live_in.assign(cfg_->getBlockCount(), Bitset(register_count));
+    this->live_out.assign(cfg_->getBlockCount(), Bitset(register_count));
+
+    // Find what each block reads and writes
+    for (int block = 0; block < cfg_->getBlockCount(); ++block)
+    {
+        BasicBlock *current_block = cfg_->getBlock(block);
+
+        for (Tac *i = current_block->getFirst(); i != current_block->getLast()->getNext(); i = i->getNext())
+        {
+            // Registers read before being written in the block
+            std::list<Operand *> uses = i->getUses();
+
+            for (auto j = uses.begin(); j != uses.end(); ++j)
+                if (!this->defined[block].test((*j)->getValue()))
+                    this->used[block].set((*j)->getValue());
+
+            // Registers written
+            if (i->getDefinition() != NULL)
+                this->defined[block].set(i->getDefinition()->getValue());
+        }
+    }
+
+    // Visit successors before their predecessors (Post-order), so that most sets are
+    // final after the first pass. Unreachable blocks go at the end
+    order.assign(cfg_->getReversePostOrder().rbegin(), cfg_->getReversePostOrder().rend());
+
+    for (int block = 0; block < cfg_->getBlockCount(); ++block)
+        if (!cfg_->isReachable(block))
+            order.push_back(block);
+
+    // Iterate until nothing changes
+    while (changed)
+    {
+        changed = false;
+
+        for (auto block = order.begin(); block != order.end(); ++block)
+        {
+            std::vector<int> &successors = cfg_->getBlock(*block)->getSuccessors();
+
+            // LiveOut(b) = Union of LiveIn(s)
+            for (auto s = successors.begin(); s != successors.end(); ++s)
+                this->live_out[*block].unite(this->live_in[*s]);
+
+            // LiveIn(b) = UsedBeforeDefined(b) + (LiveOut(b) - Defined(b))
+            Bitset live = this->live_out[*block];
+            live.subtract(this->defined[*block]);
+            live.unite(this->used[*block]);
+
+            if (live != this->live_in[*block])
+            {
+                this->live_in[*block] = live;
+                changed = true;
+            }
+        }
+    }
+}
+
+Liveness::~Liveness()
+{
+    // nil
+}
+
+Bitset &Liveness::getLiveIn(int block_id)
+{
+    return this->live_in[block_id];
+}
+
+Bitset &Liveness::getLiveOut(int block_id)
+{
+    return this->live_out[block_id];
+}
+
+std::vector<Bitset> Liveness::getInstructionLiveOut(int block_id)
+{
+    BasicBlock *block = this->cfg->getBlock(block_id);
+    std::vector<Bitset> sets(block->getSize());
+    Bitset live = this->live_out[block_id];
+    int index = block->getSize() - 1;
+
+    // Walk the block backwards, from its live out set
+    for (Tac *i = block->getLast(); index >= 0; i = i->getPrev(), --index)
+    {
+        sets[index] = live;
+        Liveness::transfer(i, live);
+    }
+
+    return sets;
+}
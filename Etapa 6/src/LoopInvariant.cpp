@@ -0,0 +1,393 @@
+#include "LoopInvariant.h"
+#include "Tac.h"
+#include "ASM.h"
+
+#include <algorithm>
+
+LoopInvariant::LoopInvariant(TacList &code_, int register_count)
+{
+    this->code = &code_;
+    this->hoisted = 0;
+    this->definitions.assign(register_count, 0);
+    this->writers.assign(register_count, NULL);
+    this->addresses.assign(register_count, false);
+
+    Tac *end = code_.getLast()->getNext();
+
+    for (Tac *i = code_.getFirst(); i != end; i = i->getNext())
+    {
+        if (i->getDefinition() != NULL)
+        {
+            this->definitions[i->getDefinition()->getValue()]++;
+            this->writers[i->getDefinition()->getValue()] = i;
+        }
+
+        if (i->getOpcode() == ILOC_LOAD && i->getArgument(0)->isRegister())
+            this->addresses[i->getArgument(0)->getValue()] = true;
+        else if (i->getOpcode() == ILOC_STORE && i->getArgument(1)->isRegister())
+            this->addresses[i->getArgument(1)->getValue()] = true;
+    }
+
+    // Loop headers, the innermost ones first
+    CFG cfg(code_);
+    std::vector<std::pair<int, Operand *>> headers;
+    std::vector<int> &order = cfg.getReversePostOrder();
+
+    for (auto block = order.begin(); block != order.end(); ++block)
+        if (!cfg.getLoop(*block).empty() && cfg.getBlock(*block)->getFirst()->getLabel() != NULL)
+            headers.push_back(std::make_pair(cfg.getLoopDepth(*block), cfg.getBlock(*block)->getFirst()->getLabel()));
+
+    std::stable_sort(headers.begin(), headers.end(),
+                     [](const std::pair<int, Operand *> &a, const std::pair<int, Operand *> &b) { return a.first > b.first; });
+
+    for (auto header = headers.begin(); header != headers.end(); ++header)
+        this->hoistLoop(header->second);
+}
+
+LoopInvariant::~LoopInvariant()
+{
+    // nil
+}
+
+int LoopInvariant::getHoistedCount()
+{
+    return this->hoisted;
+}
+
+void LoopInvariant::hoistLoop(Operand *label)
+{
+    // Hoisting from inner loops changed the code, so the graph is built again
+    CFG cfg(*this->code);
+    int header = -1;
+
+    for (int block = 0; block < cfg.getBlockCount(); ++block)
+        if (cfg.getBlock(block)->getFirst()->getLabel() == label)
+            header = block;
+
+    // The function's entry has nothing before it
+    if (header <= 0 || cfg.getLoop(header).empty())
+        return;
+
+    std::vector<int> blocks = cfg.getLoop(header);
+    std::vector<bool> in_loop(cfg.getBlockCount(), false);
+    Tac *entry = cfg.getBlock(header)->getFirst();
+    Tac *before = cfg.getBlock(header - 1)->getLast();
+
+    // In the order of the code
+    std::sort(blocks.begin(), blocks.end());
+
+    for (auto block = blocks.begin(); block != blocks.end(); ++block)
+        in_loop[*block] = true;
+
+    // The preheader goes between the header and the block before it, which must not fall into it from inside the loop
+    bool falls = before->getOpcode() != ILOC_CBR && before->getOpcode() != ILOC_JUMP && before->getOpcode() != ILOC_HALT &&
+                 (before->getOpcode() != ILOC_JUMPI || cfg.isCall(header - 1));
+
+    if (in_loop[header - 1] && falls)
+        return;
+
+    // Nor can the header start with an instruction translated along with the one before it (See ASM::isGlued)
+    switch (entry->getOpcode())
+    {
+    case ILOC_LOAD:
+    case ILOC_STORE:
+    case ILOC_LOADAI:
+    case ILOC_CBR:
+        return;
+    default:
+        break;
+    }
+
+    this->scanLoop(cfg, blocks);
+
+    // Choose invariant instructions until no more are found, each may make others invariant
+    std::vector<Tac *> hoisting;
+    bool changed = true;
+
+    while (changed)
+    {
+        changed = false;
+
+        for (auto block = blocks.begin(); block != blocks.end(); ++block)
+        {
+            Tac *end = cfg.getBlock(*block)->getLast()->getNext();
+
+            for (Tac *i = cfg.getBlock(*block)->getFirst(); i != end; i = i->getNext())
+            {
+                if (this->chosen.count(i))
+                    continue;
+
+                if (this->isInvariantLoad(i))
+                {
+                    hoisting.push_back(i);
+                    hoisting.push_back(i->getNext());
+                }
+                else if (this->isInvariant(i))
+                    hoisting.push_back(i);
+                else
+                    continue;
+
+                // Its registers are no longer written in the loop
+                for (auto j = hoisting.rbegin(); j != hoisting.rend() && !this->chosen.count(*j); ++j)
+                {
+                    this->chosen.insert(*j);
+                    this->varying[(*j)->getDefinition()->getValue()] = false;
+                }
+
+                changed = true;
+            }
+        }
+    }
+
+    // Constants stay, unless a hoisted instruction reads them
+    std::vector<bool> read(this->definitions.size(), false);
+    std::vector<Tac *> moving;
+
+    for (auto i = hoisting.begin(); i != hoisting.end(); ++i)
+    {
+        std::list<Operand *> uses = (*i)->getUses();
+
+        if ((*i)->getOpcode() != ILOC_LOADI)
+            for (auto use = uses.begin(); use != uses.end(); ++use)
+                read[(*use)->getValue()] = true;
+    }
+
+    this->chosen.clear();
+
+    for (auto i = hoisting.begin(); i != hoisting.end(); ++i)
+        if ((*i)->getOpcode() != ILOC_LOADI || read[(*i)->getDefinition()->getValue()])
+        {
+            moving.push_back(*i);
+            this->chosen.insert(*i);
+        }
+
+    // Left in place, every instruction would still be translated the same way
+    bool separating = false;
+
+    for (auto i = moving.begin(); i != moving.end(); ++i)
+        separating = separating || this->isSeparating(*i);
+
+    if (separating)
+        moving.clear();
+
+    // Move them before the header, in the same order
+    for (auto i = moving.begin(); i != moving.end(); ++i)
+    {
+        // Its label stays in the loop, on a nop
+        if ((*i)->getLabel() != NULL)
+        {
+            Tac *nop = new Tac(ILOC_NOP);
+
+            nop->setLabel((*i)->getLabel());
+            (*i)->setLabel(NULL);
+            this->code->insertBefore(*i, nop);
+
+            if (*i == entry)
+                entry = nop;
+        }
+
+        this->code->remove(*i);
+        this->code->insertBefore(entry, *i);
+        this->hoisted++;
+    }
+
+    // Branches into the loop from outside of it go to the preheader
+    std::vector<int> &predecessors = cfg.getBlock(header)->getPredecessors();
+    Operand *preheader = NULL;
+
+    for (auto p = predecessors.begin(); p != predecessors.end() && !moving.empty(); ++p)
+    {
+        Tac *branch = cfg.getBlock(*p)->getLast();
+
+        if (in_loop[*p] || (branch->getOpcode() != ILOC_CBR && branch->getOpcode() != ILOC_JUMPI))
+            continue;
+
+        for (int j = 0; j < 3; ++j)
+        {
+            Operand *target = branch->getArgument(j);
+
+            if (target != NULL && target->isLabel() && target->getValue() == label->getValue())
+            {
+                if (preheader == NULL)
+                {
+                    preheader = Tac::newLabel();
+                    moving.front()->setLabel(preheader);
+                }
+
+                branch->replace(target, preheader);
+            }
+        }
+    }
+
+    this->chosen.clear();
+}
+
+void LoopInvariant::scanLoop(CFG &cfg, std::vector<int> &blocks)
+{
+    this->varying.assign(this->definitions.size(), false);
+    this->stored.clear();
+    this->calls = false;
+    this->unknown = false;
+
+    for (auto block = blocks.begin(); block != blocks.end(); ++block)
+    {
+        Tac *end = cfg.getBlock(*block)->getLast()->getNext();
+
+        if (cfg.isCall(*block))
+            this->calls = true;
+
+        for (Tac *i = cfg.getBlock(*block)->getFirst(); i != end; i = i->getNext())
+        {
+            if (i->getDefinition() != NULL)
+                this->varying[i->getDefinition()->getValue()] = true;
+
+            switch (i->getOpcode())
+            {
+            case ILOC_STORE: // Through the address calculated right before it, or elsewhere
+            {
+                Tac *address = ASM::isIndirect(i) ? this->getWriter(i->getArgument(1)) : i->getPrev();
+
+                if (address == NULL)
+                    this->unknown = true;
+                else if (address->getArgument(0)->isBase(BASE_RFP) || address->getArgument(0)->isBase(BASE_RBSS))
+                    this->stored.insert(std::make_pair(address->getArgument(0), address->getArgument(1)->getValue()));
+                else if (address->getOpcode() != ILOC_ADD && address->getOpcode() != ILOC_ADDI)
+                    this->unknown = true;
+
+                // Otherwise an element of a vector, at an offset from its start
+            }
+            break;
+            case ILOC_STOREAI: // Return values and arguments go to the frame, outside of the variables
+                if (i->getArgument(1)->isBase(BASE_RFP) || i->getArgument(1)->isBase(BASE_RBSS))
+                    this->stored.insert(std::make_pair(i->getArgument(1), i->getArgument(2)->getValue()));
+                else if (!i->getArgument(1)->isBase(BASE_RSP))
+                    this->unknown = true;
+                break;
+            case ILOC_STOREAO:
+                this->unknown = true;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+bool LoopInvariant::isInvariant(Tac *instruction)
+{
+    Operand *definition = instruction->getDefinition();
+    Tac *next = instruction->getNext();
+
+    if (definition == NULL || this->definitions[definition->getValue()] != 1)
+        return false;
+
+    switch (instruction->getOpcode())
+    {
+    case ILOC_ADDI: // Unless it is a variable's address, which the load or store folds in (Kept in a register, it would take one)
+        if ((instruction->getArgument(0)->isBase(BASE_RFP) || instruction->getArgument(0)->isBase(BASE_RBSS)) &&
+            this->addresses[definition->getValue()])
+            return false;
+        break;
+    case ILOC_DIVI: // Dividing INT_MIN by -1 overflows
+        if (instruction->getArgument(1)->getValue() == 0 || instruction->getArgument(1)->getValue() == -1)
+            return false;
+        break;
+    case ILOC_CMP_LT: // Unless the branch after it reads its flags
+    case ILOC_CMP_LE:
+    case ILOC_CMP_EQ:
+    case ILOC_CMP_GE:
+    case ILOC_CMP_GT:
+    case ILOC_CMP_NE:
+        if (next != NULL && ASM::isGlued(next))
+            return false;
+        break;
+    case ILOC_ADD:
+    case ILOC_SUB:
+    case ILOC_MULT:
+    case ILOC_SUBI:
+    case ILOC_RSUBI:
+    case ILOC_MULTI:
+    case ILOC_LSHIFT:
+    case ILOC_LSHIFTI:
+    case ILOC_RSHIFT:
+    case ILOC_RSHIFTI:
+    case ILOC_AND:
+    case ILOC_ANDI:
+    case ILOC_OR:
+    case ILOC_ORI:
+    case ILOC_XOR:
+    case ILOC_XORI:
+    case ILOC_LOADI:
+    case ILOC_I2I:
+        break;
+    default:
+        return false;
+    }
+
+    // The stack pointer and program counter change, rfp and rbss do not
+    for (int i = 0; i < 3; ++i)
+    {
+        Operand *argument = instruction->getArgument(i);
+
+        if (argument != NULL && (argument->isBase(BASE_RSP) || argument->isBase(BASE_RPC)))
+            return false;
+    }
+
+    std::list<Operand *> uses = instruction->getUses();
+
+    for (auto use = uses.begin(); use != uses.end(); ++use)
+        if (this->varying[(*use)->getValue()])
+            return false;
+
+    return true;
+}
+
+bool LoopInvariant::isInvariantLoad(Tac *address)
+{
+    Tac *load = address->getNext();
+
+    if (address->getOpcode() != ILOC_ADDI || load == NULL || load->getOpcode() != ILOC_LOAD || ASM::isIndirect(load))
+        return false;
+
+    // Something else may write the variable
+    if (this->calls || this->unknown || this->stored.count(std::make_pair(address->getArgument(0), address->getArgument(1)->getValue())))
+        return false;
+
+    Operand *location = address->getArgument(2);
+    Operand *value = load->getArgument(1);
+
+    // The load usually overwrites its address
+    if (location == value ? this->definitions[location->getValue()] != 2
+                          : this->definitions[location->getValue()] != 1 || this->definitions[value->getValue()] != 1)
+        return false;
+
+    return true;
+}
+
+Tac *LoopInvariant::getWriter(Operand *address)
+{
+    Tac *writer = this->definitions[address->getValue()] == 1 ? this->writers[address->getValue()] : NULL;
+
+    // Variables have their address added to rfp or rbss, vector elements to the vector's start
+    if (writer != NULL && writer->getOpcode() != ILOC_ADD && writer->getOpcode() != ILOC_ADDI)
+        writer = NULL;
+
+    return writer;
+}
+
+bool LoopInvariant::isSeparating(Tac *instruction)
+{
+    Tac *prev = instruction->getPrev();
+    Tac *next = instruction->getNext();
+
+    // Skipping the ones that are moving as well
+    while (prev != NULL && this->chosen.count(prev))
+        prev = prev->getPrev();
+
+    while (next != NULL && this->chosen.count(next))
+        next = next->getNext();
+
+    return prev != NULL && next != NULL && prev->getOpcode() == ILOC_ADDI &&
+           (prev->getArgument(0)->isBase(BASE_RFP) || prev->getArgument(0)->isBase(BASE_RBSS)) &&
+           (next->getOpcode() == ILOC_LOAD || next->getOpcode() == ILOC_STORE);
+}
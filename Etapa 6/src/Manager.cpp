@@ -26,20 +26,93 @@ extern void libera(void *arvore)
 
 extern void export_code(void *arvore)
 {
-    std::cout << ((Node *)arvore)->exportCode() << std::endl;
+    if (arvore != NULL)
+    {
+        Writer out(STDOUT_FILENO);
+
+        ((Node *)arvore)->exportCode(out);
+        out << '\n';
+    }
 }
 
-extern void generate_ASM(void *arvore)
+extern void export_cfg(void *arvore)
 {
-    // Get intermediate ILOC code
-    Tac *code = ((Node *)arvore)->getCode();
+    std::vector<Symbol *> functions;
+
+    if (arvore != NULL)
+    {
+        // Get every function with generated code
+        std::unordered_map<std::string, Symbol *> symbols = Manager::getActiveSymbolTable()->getHashTable();
+
+        for (auto i = symbols.begin(); i != symbols.end(); ++i)
+            if (i->second->getNature() == NAT_FUNCTION && !i->second->getCode().isEmpty())
+                functions.push_back(i->second);
+
+        // Order by label (Declaration order)
+        std::sort(functions.begin(), functions.end(),
+                  [](Symbol *f1, Symbol *f2) { return (f1->getLabel()->getValue() < f2->getLabel()->getValue()); });
+
+        // Export the control flow graph of each function
+        for (auto i = functions.begin(); i != functions.end(); ++i)
+        {
+            CFG cfg((*i)->getCode());
 
-    // Output generated ASM code
+            std::cout << "# Function \"" << (*i)->getName() << "\"" << std::endl
+                      << cfg.toString() << std::endl;
+        }
+    }
+}
+
+extern void generate_ASM(void *arvore)
+{
+    // Output generated ASM code (The ILOC code is still owned by the tree)
     if (arvore != NULL)
-        std::cout << ASM::generateASM(code) << std::endl;
+    {
+        Writer out(STDOUT_FILENO);
+
+        ASM::generateASM(((Node *)arvore)->getCode().getFirst(), out);
+        out << '\n';
+    }
+}
 
-    // Free ILOC code
-    delete code;
+extern void enable_regalloc_stats()
+{
+    ASM::setOutputStats(true);
+}
+
+extern void enable_linear_scan()
+{
+    ASM::setLinearScan(true);
+}
+
+extern void enable_peephole_stats()
+{
+    ASM::setOutputPeepholeStats(true);
+}
+
+extern void disable_tac_comments()
+{
+    ASM::setOutputTacComments(false);
+}
+
+extern void force_frame_pointer()
+{
+    ASM::setForceFramePointer(true);
+}
+
+extern void enable_optimizer_stats()
+{
+    Optimizer::setOutputStats(true);
+}
+
+extern void set_inline_threshold(int threshold)
+{
+    Inliner::setThreshold(threshold);
+}
+
+extern void set_cmov_threshold(int threshold)
+{
+    ASM::setCmovThreshold(threshold);
 }
 
 // CONSTRUCTOR AND DESTRUCTOR
@@ -64,8 +137,8 @@ Manager::~Manager()
     // Leave global scope
     Manager::leaveScope();
 
-    // Free memory used for labels and registers during code generation
-    Tac::freeNames();
+    // Free memory used for the code, labels and registers during code generation
+    TacArena::releaseAll();
 }
 
 // SCOPE MANAGEMENT
@@ -149,6 +222,9 @@ void Manager::leaveFunction()
     // Reser function pointer
     function = NULL;
 
+    // Code outside of functions goes to the global arena
+    TacArena::setActive(TacArena::getGlobal());
+
     // Top symbol table (Current scope)
     SymbolTable *top = Manager::stack.top();
 
@@ -327,6 +403,13 @@ void Manager::declareFunction(Node *function, Type type)
 
     // Sets current function
     this->function = symbol;
+
+    // Place the function's code in its own arena
+    symbol->giveArena(new TacArena());
+    TacArena::setActive(symbol->getArena());
+
+    // Label it before its body, which may call it
+    symbol->giveLabel(Tac::newLabel());
 }
 
 Symbol *Manager::getSymbol(Token *lexval)
@@ -416,22 +499,25 @@ Node *Manager::createId(Token *lexval, Statement statement, bool lval)
 
 Node *Manager::createLiteral(Token *lexval, Type type)
 {
-    // Check if literal is already in the symbol table
     Symbol *lit = NULL;
 
-    // Search for symbol
-    if ((lit = Manager::getSymbol(lexval)) != NULL)
+    // Only strings are kept in the data segment, other literals are loaded into registers directly
+    if (type == TYPE_STRING)
     {
-        // Symbol already exists, update line only
-        lit->setLine(lexval->getLine());
-    }
-    else
-    {
-        // If symbol does not exist, create it
-        lit = new Symbol(lexval, NAT_NONE, type, type == TYPE_STRING ? 0 : 1, true);
+        // Search for symbol
+        if ((lit = Manager::getSymbol(lexval)) != NULL)
+        {
+            // Symbol already exists, update line only
+            lit->setLine(lexval->getLine());
+        }
+        else
+        {
+            // If symbol does not exist, create it
+            lit = new Symbol(lexval, NAT_NONE, type, 0, true);
 
-        // And declare it in global scope
-        Manager::declareSymbol(lit, true);
+            // And declare it in global scope
+            Manager::declareSymbol(lit, true);
+        }
     }
 
     // Create node
@@ -481,8 +567,18 @@ Node *Manager::createIf(Node *condition, Node *then_node, Node *else_node)
     // Check if types are compatible for the condition
     checkCompatibility(TYPE_BOOL, condition->getType(), if_node);
 
-    // Generate intermediate code for the node
-    if_node->generateCode();
+    // If the condition is known, only the branch taken is kept, without any test
+    if (condition->isConstant())
+    {
+        Node *taken = getConstantValue(condition) != 0 ? then_node : else_node;
+
+        if_node->setCode(taken != NULL ? taken->takeCode() : TacList());
+    }
+    else
+    {
+        // Generate intermediate code for the node
+        if_node->generateCode();
+    }
 
     return if_node;
 }
@@ -514,8 +610,20 @@ Node *Manager::createFor(Node *init_attrib, Node *condition, Node *loop_attrib,
     // Check if types are compatible for condition
     checkCompatibility(TYPE_BOOL, condition->getType(), for_node);
 
-    // Generate intermediate code for the node
-    for_node->generateCode();
+    // If the condition is always false, only the initial attribution is kept
+    if (condition->isConstant() && getConstantValue(condition) == 0)
+    {
+        for_node->setCode(init_attrib->takeCode());
+    }
+    else
+    {
+        // If it is always true, it is never tested
+        if (condition->isConstant())
+            condition->takeCode();
+
+        // Generate intermediate code for the node
+        for_node->generateCode();
+    }
 
     return for_node;
 }
@@ -541,8 +649,16 @@ Node *Manager::createWhile(Node *condition, Node *body)
     // Check if types are compatible for condition
     checkCompatibility(TYPE_BOOL, condition->getType(), while_node);
 
-    // Generate intermediate code for the node
-    while_node->generateCode();
+    // If the condition is always false, the loop has no code at all
+    if (!condition->isConstant() || getConstantValue(condition) != 0)
+    {
+        // If it is always true, it is never tested
+        if (condition->isConstant())
+            condition->takeCode();
+
+        // Generate intermediate code for the node
+        while_node->generateCode();
+    }
 
     return while_node;
 }
@@ -796,10 +912,14 @@ Node *Manager::createUnop(Node *operation, Node *operand)
     // Update type
     operation->setType(inferType(operation->getType(), operand->getType()));
 
-    // Generate intermediate code for this node
-    operation->generateCode();
+    // Fold the operation before generating any code for it
+    Node *simplified = simplifyUnop(operation);
 
-    return operation;
+    // Generate intermediate code for this node, if it is still there
+    if (simplified == operation)
+        operation->generateCode();
+
+    return simplified;
 }
 
 Node *Manager::createBinop(Node *l_operand, Node *operation, Node *r_operand)
@@ -841,10 +961,14 @@ Node *Manager::createBinop(Node *l_operand, Node *operation, Node *r_operand)
             operation->setType(inferType(l_operand->getType(), r_operand->getType()));
     }
 
-    // Generate intermediate code for this node
-    operation->generateCode();
+    // Fold and simplify the operation before generating any code for it
+    Node *simplified = simplifyBinop(operation);
+
+    // Generate intermediate code for this node, if it is still there
+    if (simplified == operation)
+        operation->generateCode();
 
-    return operation;
+    return simplified;
 }
 
 Node *Manager::createTernop(Node *then_node)
@@ -873,6 +997,12 @@ Node *Manager::createFunctionDeclaration(Node *id, Node *body)
     // Generate intermediate code for this node
     id->generateCode();
 
+    // Optimize it on its own
+    id->setCode(Optimizer::optimizeFunction(Manager::function, id->getCode()));
+
+    // Keep track of the function's code (Before it is linked to the rest of the program)
+    Manager::function->giveCode(id->getCode());
+
     // Return function node
     return id;
 }
@@ -1095,3 +1225,302 @@ int Manager::getStringSize(Node *node)
     // Return calculated size
     return size;
 }
+
+// AST SIMPLIFICATION
+
+Node *Manager::simplifyUnop(Node *operation)
+{
+    Node *operand = operation->getChild(0);
+    Node *folded = NULL; // Constant computed for the operation, if any
+    Value v;
+
+    // Explicit positivity does nothing
+    if (!strcmp(operation->getName(), "+"))
+        return replaceByChild(operation, 0);
+
+    // Only constants are folded from here on
+    if (!operand->isConstant())
+        return operation;
+
+    // Signal inversion
+    if (!strcmp(operation->getName(), "-"))
+    {
+        if (operand->getValue()->getField() == 2)
+        {
+            v.floating = -operand->getValue()->getFloating();
+            folded = createConstant(v, 2, operation->getType(), operation->getLine());
+        }
+        else
+        {
+            // Wraps around, like the generated code would
+            v.integer = (int)(0u - (unsigned int)operand->getValue()->getInteger());
+            folded = createConstant(v, 1, operation->getType(), operation->getLine());
+        }
+    }
+
+    // Logic negation
+    if (!strcmp(operation->getName(), "!"))
+    {
+        v.boolean = getConstantValue(operand) == 0;
+        folded = createConstant(v, 4, operation->getType(), operation->getLine());
+    }
+
+    // The operation (And its operand) is not needed anymore if it was folded
+    if (folded == NULL)
+        return operation;
+
+    delete operation;
+
+    return folded;
+}
+
+Node *Manager::simplifyBinop(Node *operation)
+{
+    Node *l_operand = operation->getChild(0);
+    Node *r_operand = operation->getChild(1);
+    std::string op = operation->getName();
+    Node *folded = NULL; // Constant computed for the operation, if any
+    Value v;
+
+    // A ternary operation with a constant condition (Its second child) is just one of its branches
+    if (operation->getKind() == ST_TERNOP)
+    {
+        if (r_operand->isConstant())
+            return replaceByChild(operation, getConstantValue(r_operand) != 0 ? 0 : 2);
+
+        return operation;
+    }
+
+    // Logic operations are short-circuited, so constants decide which operand is the result
+    if (logic_binop_code.count(op) && (logic_binop_code.at(op) == ILOC_AND || logic_binop_code.at(op) == ILOC_OR))
+    {
+        // Value that decides the result on its own (False for AND, true for OR)
+        bool decisive = logic_binop_code.at(op) == ILOC_OR;
+
+        // Either the left operand is the result and the right one is never evaluated, or the other way around
+        if (l_operand->isConstant())
+            return replaceByLogicChild(operation, (getConstantValue(l_operand) != 0) == decisive ? 0 : 1);
+
+        if (r_operand->isConstant())
+        {
+            // A right operand that does not decide the result changes nothing
+            if ((getConstantValue(r_operand) != 0) != decisive)
+                return replaceByLogicChild(operation, 0);
+
+            // One that does is the result, if the left one has nothing else to do
+            if (!hasSideEffects(l_operand))
+                return replaceByLogicChild(operation, 1);
+        }
+
+        return operation;
+    }
+
+    // With a single constant operand, look for identities and annihilators
+    if (l_operand->isConstant() != r_operand->isConstant())
+    {
+        int constant = l_operand->isConstant() ? 0 : 1; // Index of the constant operand
+        double value = getConstantValue(operation->getChild(constant));
+
+        // x + 0, 0 + x, x - 0
+        if (value == 0 && (op == "+" || (op == "-" && constant == 1)))
+            return replaceByChild(operation, 1 - constant);
+
+        // x * 1, 1 * x, x / 1
+        if (value == 1 && (op == "*" || (op == "/" && constant == 1)))
+            return replaceByChild(operation, 1 - constant);
+
+        // x * 0, 0 * x
+        if (value == 0 && op == "*" && !hasSideEffects(operation->getChild(1 - constant)))
+            return replaceByChild(operation, constant);
+
+        return operation;
+    }
+
+    // Only constants are folded from here on
+    if (!l_operand->isConstant())
+        return operation;
+
+    double a = getConstantValue(l_operand);
+    double b = getConstantValue(r_operand);
+
+    // Comparisons
+    if (logic_binop_code.count(op))
+    {
+        switch (logic_binop_code.at(op))
+        {
+        case ILOC_CMP_LT:
+            v.boolean = a < b;
+            break;
+        case ILOC_CMP_LE:
+            v.boolean = a <= b;
+            break;
+        case ILOC_CMP_EQ:
+            v.boolean = a == b;
+            break;
+        case ILOC_CMP_GE:
+            v.boolean = a >= b;
+            break;
+        case ILOC_CMP_GT:
+            v.boolean = a > b;
+            break;
+        default:
+            v.boolean = a != b;
+            break;
+        }
+
+        folded = createConstant(v, 4, operation->getType(), operation->getLine());
+    }
+    // Float arithmetic
+    else if (l_operand->getValue()->getField() == 2 || r_operand->getValue()->getField() == 2)
+    {
+        float result = 0;
+        bool known = true;
+
+        if (op == "+")
+            result = a + b;
+        else if (op == "-")
+            result = a - b;
+        else if (op == "*")
+            result = a * b;
+        else if (op == "/" && b != 0)
+            result = a / b;
+        else if (op == "^")
+            result = std::pow(a, b);
+        else
+            known = false;
+
+        if (known)
+        {
+            v.floating = result;
+            folded = createConstant(v, 2, operation->getType(), operation->getLine());
+        }
+    }
+    // Integer arithmetic (Wraps around, like the generated code would)
+    else
+    {
+        int i = l_operand->getValue()->getInteger();
+        int j = r_operand->getValue()->getInteger();
+        unsigned int result = 0;
+        bool known = true;
+
+        // Division overflows for the smallest integer over -1
+        bool divisible = j != 0 && !(i == INT_MIN && j == -1);
+
+        if (op == "+")
+            result = (unsigned int)i + (unsigned int)j;
+        else if (op == "-")
+            result = (unsigned int)i - (unsigned int)j;
+        else if (op == "*")
+            result = (unsigned int)i * (unsigned int)j;
+        else if (op == "/" && divisible)
+            result = i / j;
+        else if (op == "%" && divisible)
+            result = i % j;
+        else if (op == "^" && j >= 0)
+        {
+            // Exponentiation by squaring
+            unsigned int base = i;
+
+            for (result = 1; j > 0; j >>= 1, base *= base)
+                if (j & 1)
+                    result *= base;
+        }
+        else
+            known = false;
+
+        if (known)
+        {
+            v.integer = (int)result;
+            folded = createConstant(v, 1, operation->getType(), operation->getLine());
+        }
+    }
+
+    // The operation (And its operands) is not needed anymore if it was folded
+    if (folded == NULL)
+        return operation;
+
+    delete operation;
+
+    return folded;
+}
+
+Node *Manager::replaceByChild(Node *operation, int index)
+{
+    Node *child = operation->removeChild(index);
+
+    // Keep the expression's type as it was checked
+    child->setType(operation->getType());
+
+    // Delete the operation along with its other children (Their code is never used)
+    delete operation;
+
+    return child;
+}
+
+Node *Manager::replaceByLogicChild(Node *operation, int index)
+{
+    Node *child = operation->getChild(index);
+    Value v;
+
+    // A constant becomes a boolean one (3 && x is never 3)
+    if (child->isConstant())
+    {
+        v.boolean = getConstantValue(child) != 0;
+        Node *folded = createConstant(v, 4, operation->getType(), operation->getLine());
+
+        delete operation;
+
+        return folded;
+    }
+
+    // Logic and comparison operations already compute 0 or 1, any other operand keeps the operation
+    if (!isLogicExpression(child))
+        return operation;
+
+    return replaceByChild(operation, index);
+}
+
+bool Manager::isLogicExpression(Node *node)
+{
+    if (node->getKind() == ST_UNOP)
+        return !strcmp(node->getName(), "!");
+
+    if (node->getKind() == ST_BINOP)
+        return logic_binop_code.count(node->getName()) > 0;
+
+    return false;
+}
+
+Node *Manager::createConstant(Value value, int field, Type type, int line)
+{
+    // Create token for this node, as if the scanner had found it
+    Token *tok = new Token(line, CAT_LITERAL, value, field);
+
+    // Create node
+    Node *constant_node = new Node(tok, type, ST_OPERAND, false);
+
+    // Generate intermediate code for this node
+    constant_node->generateCode();
+
+    return constant_node;
+}
+
+double Manager::getConstantValue(Node *node)
+{
+    // (Integers are exact as doubles, but not as floats)
+    if (node->getValue()->getField() == 2)
+        return node->getValue()->getFloating();
+
+    return node->getValue()->getInteger();
+}
+
+bool Manager::hasSideEffects(Node *node)
+{
+    std::vector<Node *> nodes = node->getSubtree();
+
+    for (auto i = nodes.begin(); i != nodes.end(); ++i)
+        if ((*i)->getKind() == ST_FUNCTION_CALL)
+            return true;
+
+    return false;
+}
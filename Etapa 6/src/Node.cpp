@@ -7,7 +7,6 @@ Node::Node(Token *lexval_, Type type_, Statement statement_, bool lval_)
     this->statement = statement_;
     this->next_cmd = NULL;
     this->next_elem = NULL;
-    this->code = NULL;
     this->address = false;
     this->value = false;
     this->lval = lval_;
@@ -18,21 +17,39 @@ Node::Node(Token *lexval_, Type type_, Statement statement_, bool lval_)
 
 Node::~Node()
 {
-    // Traverse children deleting them
-    for (auto i = this->children.begin(); i != this->children.end(); ++i)
-        delete (*i);
+    // Nodes waiting to be deleted (A worklist keeps stack usage bounded for long command lists)
+    std::vector<Node *> pending;
+    Node *node = this;
 
-    // Delete next element after this node, if it exists
-    if (this->next_elem != NULL)
-        delete (this->next_elem);
+    while (node != NULL)
+    {
+        // Take over the node's children, next element and next command
+        pending.insert(pending.end(), node->children.begin(), node->children.end());
+        node->children.clear();
 
-    // Delete next command after this node, if it exists
-    if (this->next_cmd != NULL)
-        delete (this->next_cmd);
+        if (node->next_elem != NULL)
+            pending.push_back(node->next_elem);
 
-    // Delete code for this command, if it exists
-    if (this->code != NULL)
-        delete (this->code);
+        if (node->next_cmd != NULL)
+            pending.push_back(node->next_cmd);
+
+        node->next_elem = NULL;
+        node->next_cmd = NULL;
+
+        // Delete it, with nothing linked to it its destructor won't go any further
+        if (node != this)
+            delete node;
+
+        // Get next node to be deleted
+        node = NULL;
+        if (!pending.empty())
+        {
+            node = pending.back();
+            pending.pop_back();
+        }
+    }
+
+    // (The code for this node is freed along with its function's code arena)
 
     // Delete lexical value
     delete (this->lexval);
@@ -60,60 +77,63 @@ std::string Node::reconstruct()
 {
     std::stringstream node_string;
 
-    // Based on node nature
-    switch (this->getKind())
+    // Reconstruct this node and the ones after it, if it is part of a list
+    for (Node *node = this; node != NULL; node = node->next_elem)
     {
-    case ST_OPERAND: // IDs and literals
-        node_string << this->getName();
-        break;
-    case ST_VECTOR_ACCESS: // Vector access nodes
-        node_string << this->getChild(0)->getName()
-                    << "[" << this->getChild(1)->reconstruct() << "]";
-        break;
-    case ST_UNOP:   // Unops
-    case ST_IO:     // IOs
-    case ST_RETURN: // Returns
-        node_string << this->getName() << " "
-                    << this->getChild(0)->reconstruct();
-        break;
-    case ST_BINOP:           // Binops
-    case ST_INIT_VARIABLE:   // Variable initialization
-    case ST_ATTRIB_VARIABLE: // Variable attributions
-        node_string << this->getChild(0)->reconstruct()
-                    << " " << this->getName() << " "
-                    << this->getChild(1)->reconstruct();
-        break;
-    case ST_TERNOP: // Ternary operations
-        node_string << this->getChild(1)->reconstruct() << " ? "
-                    << this->getChild(0)->reconstruct() << " : "
-                    << this->getChild(2)->reconstruct();
-        break;
-    case ST_FUNCTION_CALL: // Function calls
-        node_string << this->getName()
-                    << "( " << this->getChild(0)->reconstruct() << " )";
-        break;
-    case ST_IF: // If statements
-        node_string << this->getName()
-                    << "( " << this->getChild(0)->reconstruct() << " ) ...";
-        break;
-    case ST_FOR: // For statements
-        node_string << this->getName()
-                    << "( " << this->getChild(0)->reconstruct() << " : "
-                    << this->getChild(1)->reconstruct() << " : "
-                    << this->getChild(2)->reconstruct() << " ) ..";
-        break;
-    case ST_WHILE: // While statement
-        node_string << this->getName()
-                    << "( " << this->getChild(0)->reconstruct() << " ) ...";
-        break;
-    default:
-        break;
-    }
+        // Add a ',' in between list elements
+        if (node != this)
+            node_string << ", ";
 
-    // If node is part of a list
-    if (this->next_elem != NULL)
-        // Reconstruct next node, and add a ',' in between
-        node_string << ", " << this->next_elem->reconstruct();
+        // Based on node nature
+        switch (node->getKind())
+        {
+        case ST_OPERAND: // IDs and literals
+            node_string << node->getName();
+            break;
+        case ST_VECTOR_ACCESS: // Vector access nodes
+            node_string << node->getChild(0)->getName()
+                        << "[" << node->getChild(1)->reconstruct() << "]";
+            break;
+        case ST_UNOP:   // Unops
+        case ST_IO:     // IOs
+        case ST_RETURN: // Returns
+            node_string << node->getName() << " "
+                        << node->getChild(0)->reconstruct();
+            break;
+        case ST_BINOP:           // Binops
+        case ST_INIT_VARIABLE:   // Variable initialization
+        case ST_ATTRIB_VARIABLE: // Variable attributions
+            node_string << node->getChild(0)->reconstruct()
+                        << " " << node->getName() << " "
+                        << node->getChild(1)->reconstruct();
+            break;
+        case ST_TERNOP: // Ternary operations
+            node_string << node->getChild(1)->reconstruct() << " ? "
+                        << node->getChild(0)->reconstruct() << " : "
+                        << node->getChild(2)->reconstruct();
+            break;
+        case ST_FUNCTION_CALL: // Function calls
+            node_string << node->getName()
+                        << "( " << node->getChild(0)->reconstruct() << " )";
+            break;
+        case ST_IF: // If statements
+            node_string << node->getName()
+                        << "( " << node->getChild(0)->reconstruct() << " ) ...";
+            break;
+        case ST_FOR: // For statements
+            node_string << node->getName()
+                        << "( " << node->getChild(0)->reconstruct() << " : "
+                        << node->getChild(1)->reconstruct() << " : "
+                        << node->getChild(2)->reconstruct() << " ) ..";
+            break;
+        case ST_WHILE: // While statement
+            node_string << node->getName()
+                        << "( " << node->getChild(0)->reconstruct() << " ) ...";
+            break;
+        default:
+            break;
+        }
+    }
 
     // Return generated string
     return node_string.str();
@@ -122,21 +142,11 @@ std::string Node::reconstruct()
 std::string Node::exportNodes()
 {
     std::stringstream output;
+    std::vector<Node *> nodes = this->getSubtree();
 
-    // Export information about this node
-    output << this->toString() << std::endl;
-
-    // Export information about this node's children, from left to right
-    for (auto i = this->children.begin(); i != this->children.end(); ++i)
-        output << (*i)->exportNodes();
-
-    // Export information abou this node's next in the list, if it exists
-    if (this->next_elem != NULL)
-        output << this->next_elem->exportNodes();
-
-    // Export information about this node's next command, if it exists
-    if (this->next_cmd != NULL)
-        output << this->next_cmd->exportNodes();
+    // Export information about every node in the tree
+    for (auto i = nodes.begin(); i != nodes.end(); ++i)
+        output << (*i)->toString() << std::endl;
 
     // Return generated string
     return output.str();
@@ -165,35 +175,51 @@ std::string Node::exportEdges()
 std::string Node::exportAllEdges()
 {
     std::stringstream output;
+    std::vector<Node *> nodes = this->getSubtree();
 
-    // Export this node's edges
-    output << this->exportEdges();
-
-    // Export this node's children's edges
-    for (auto i = this->children.begin(); i != this->children.end(); ++i)
-        output << (*i)->exportAllEdges();
-
-    // Export next element's edges, if it exists
-    if (this->next_elem != NULL)
-        output << this->next_elem->exportAllEdges();
-
-    // Export next command's edges, if it exists
-    if (this->next_cmd != NULL)
-        output << this->next_cmd->exportAllEdges();
+    // Export the edges of every node in the tree
+    for (auto i = nodes.begin(); i != nodes.end(); ++i)
+        output << (*i)->exportEdges();
 
     // Return generated string
     return output.str();
 }
 
-std::string Node::exportCode()
+std::vector<Node *> Node::getSubtree()
 {
-    std::string code = "";
+    std::vector<Node *> nodes;
+    std::vector<Node *> pending; // Nodes still to be visited, next one at the back
+    Node *node = NULL;
 
-    // Export the code if there is any associated
-    if (this->code != NULL)
-        code = this->code->getCodeString();
+    pending.push_back(this);
 
-    return code;
+    while (!pending.empty())
+    {
+        // Visit next node
+        node = pending.back();
+        pending.pop_back();
+
+        nodes.push_back(node);
+
+        // Schedule next command, next element and children, in reverse order so that
+        // children are visited first (left to right), then next element, then next command
+        if (node->next_cmd != NULL)
+            pending.push_back(node->next_cmd);
+
+        if (node->next_elem != NULL)
+            pending.push_back(node->next_elem);
+
+        for (auto i = node->children.rbegin(); i != node->children.rend(); ++i)
+            pending.push_back(*i);
+    }
+
+    return nodes;
+}
+
+void Node::exportCode(Writer &out)
+{
+    // Export the code if there is any associated
+    this->code.writeCode(out);
 }
 
 // SETTERS
@@ -212,14 +238,8 @@ void Node::insertCommand(Node *next_cmd)
         // Update next command
         this->next_cmd = next_cmd;
 
-        // Get next command's code
-        Tac *next_code = next_cmd->getCode();
-
-        if (this->code != NULL)
-            // Link to this node's code
-            this->code->addLast(next_code);
-        else
-            this->code = next_code;
+        // Link next command's code to this node's code
+        this->code.concatenate(next_cmd->takeCode());
     }
 }
 
@@ -238,11 +258,26 @@ void Node::insertNext(Node *next)
     this->next_elem = next;
 }
 
-void Node::setTemp(std::string *temp)
+void Node::setTemp(Operand *temp)
 {
     this->temp = temp;
 }
 
+void Node::setCode(TacList code)
+{
+    this->code = code;
+}
+
+Node *Node::removeChild(int index)
+{
+    Node *child = this->children.at(index);
+
+    // Forget about it, so that it is not deleted along with this node
+    this->children.erase(this->children.begin() + index);
+
+    return child;
+}
+
 void Node::generateCode()
 {
     // DEBUG
@@ -252,7 +287,12 @@ void Node::generateCode()
     switch (this->statement)
     {
     case ST_OPERAND:
-        if (this->lval)
+        if (this->isConstant())
+        {
+            // std::cout << "Making a literal TAC sequence" << std::endl;
+            this->code = generateLiteralTAC();
+        }
+        else if (this->lval)
         {
             // std::cout << "Making an lval variable TAC sequence" << std::endl;
             this->code = generateLvalVariableTAC();
@@ -338,9 +378,9 @@ void Node::generateCode()
     }
 
     // Debug
-    if (this->code != NULL)
+    if (!this->code.isEmpty())
     {
-        //std::cout << this->code->getCodeString() << std::endl;
+        //std::cout << this->code.getCodeString() << std::endl;
     }
 }
 
@@ -373,7 +413,7 @@ void Node::setRval()
         load_actual_value = new Tac(ILOC_LOAD, this->temp, this->temp); // load t1 => t1
 
         // Link instructions together
-        this->code->addLast(load_actual_value);
+        this->code.append(load_actual_value);
 
         //  Mark this node as having a value
         this->setValue();
@@ -451,21 +491,52 @@ std::string Node::getInfo()
     return info.str();
 }
 
-std::string *Node::getTemp()
+Operand *Node::getTemp()
 {
     return this->temp;
 }
 
-Tac *Node::getCode()
+TacList Node::getCode()
 {
-    Tac *copy = NULL;
+    return this->code;
+}
 
-    if (this->code != NULL)
-        // Copy code
-        copy = new Tac(*(this->code));
+TacList Node::takeCode()
+{
+    TacList code = this->code;
 
-    // Return copy of the code
-    return copy;
+    // Hand the instruction sequence over, this node no longer owns it
+    this->code = TacList();
+
+    return code;
+}
+
+bool Node::isConstant()
+{
+    return this->statement == ST_OPERAND && this->lexval->getCategory() == CAT_LITERAL && this->lexval->getField() != 0;
+}
+
+bool Node::isComparison()
+{
+    auto op = logic_binop_code.find(this->getName());
+
+    return this->statement == ST_BINOP && op != logic_binop_code.end() && op->second >= ILOC_CMP_LT && op->second <= ILOC_CMP_NE;
+}
+
+TacList Node::takeValueCode()
+{
+    TacList code = this->takeCode();
+
+    // The compare already wrote the value, only conditions branch on it
+    if (this->isComparison())
+    {
+        code.remove(code.getLast()); // cbr t3 => H1, H2
+
+        this->clearTrueList();
+        this->clearFalseList();
+    }
+
+    return code;
 }
 
 bool Node::hasAddress()
@@ -478,12 +549,12 @@ bool Node::hasValue()
     return this->value;
 }
 
-std::list<std::string *> Node::getTrueList()
+std::list<Operand *> Node::getTrueList()
 {
     return this->true_list;
 }
 
-std::list<std::string *> Node::getFalseList()
+std::list<Operand *> Node::getFalseList()
 {
     return this->false_list;
 }
@@ -500,20 +571,34 @@ void Node::clearFalseList()
 
 // TAC GENERATION
 
-Tac *Node::generateLvalVariableTAC()
+void Node::labelInstruction(TacList &code, Tac *instruction, Operand *label)
+{
+    // Already labeled by the statement it starts (Such as a loop's condition), so a nop before it takes this label
+    if (instruction->getLabel() != NULL)
+    {
+        Tac *nop = new Tac(ILOC_NOP);
+
+        code.insertBefore(instruction, nop);
+        instruction = nop;
+    }
+
+    instruction->setLabel(label);
+}
+
+TacList Node::generateLvalVariableTAC()
 {
     // Instructions
     Tac *calculate_base_address = NULL; // 1. t1 = rfp : rbss + base
 
     // Get variable base address from symbol table
     Symbol *var = Manager::getSymbol(this->getValue());
-    std::string *base = Tac::getName(std::to_string(var->getAddress()));
+    Operand *base = Tac::getImmediate(var->getAddress());
 
     // Temporary register
-    std::string *t1 = Tac::newRegister();
+    Operand *t1 = Tac::newRegister();
 
     // Frame or data segment register
-    std::string *rb = Tac::getRegister(var->isGlobal());
+    Operand *rb = Tac::getRegister(var->isGlobal());
 
     // Generate code
     calculate_base_address = new Tac(ILOC_ADDI, rb, base, t1); // addI rb, base => t1
@@ -524,14 +609,14 @@ Tac *Node::generateLvalVariableTAC()
     // Mark it as having an address
     this->setAddress();
 
-    return calculate_base_address;
+    return TacList(calculate_base_address);
 }
 
-Tac *Node::generateRvalVariableTAC()
+TacList Node::generateRvalVariableTAC()
 {
     // Instructions
-    Tac *calculate_base_address = NULL; // 1. t1 = mem(rfp : rbss + base)
-    Tac *load_actual_value = NULL;      // 2. t1 = mem(t1)
+    TacList calculate_base_address; // 1. t1 = mem(rfp : rbss + base)
+    Tac *load_actual_value = NULL;  // 2. t1 = mem(t1)
 
     // Calculate the variable's address
     calculate_base_address = this->generateLvalVariableTAC();
@@ -540,7 +625,7 @@ Tac *Node::generateRvalVariableTAC()
     load_actual_value = new Tac(ILOC_LOAD, this->temp, this->temp); // load t1 => t1
 
     // Link instructions together
-    calculate_base_address->addLast(load_actual_value);
+    calculate_base_address.append(load_actual_value);
 
     // Mark this node as having a value
     this->setValue();
@@ -549,37 +634,54 @@ Tac *Node::generateRvalVariableTAC()
     return calculate_base_address;
 }
 
-Tac *Node::generateLvalVectorTAC()
+TacList Node::generateLiteralTAC()
+{
+    // Get the literal's value (Its data segment copy is not needed)
+    Operand *value = Tac::getImmediate(this->getValue()->getInteger());
+
+    // Temporary register
+    Operand *t1 = Tac::newRegister();
+
+    // Set node temp to t1
+    this->setTemp(t1);
+
+    // Mark it as having a value
+    this->setValue();
+
+    return TacList(new Tac(ILOC_LOADI, value, t1)); // loadI value => t1
+}
+
+TacList Node::generateLvalVectorTAC()
 {
     // Instructions
 
-    Tac *calculate_index_code = NULL;       // t1 = calculate index
+    TacList calculate_index_code;           // t1 = calculate index
     Tac *calculate_vector_base = NULL;      // t2 = rbss + base
     Tac *calculate_offset = NULL;           // t3 = t1 * w
     Tac *calculate_indexed_position = NULL; // t4 = t2 + t3
 
     // Get vector base address from symbol table
     Symbol *vec = Manager::getSymbol(this->getChild(0)->getValue());
-    std::string *base = Tac::getName(std::to_string(vec->getAddress()));
+    Operand *base = Tac::getImmediate(vec->getAddress());
 
     // Get vector type size
-    std::string *w = Tac::getName(std::to_string(getSize(vec->getType())));
+    Operand *w = Tac::getImmediate(getSize(vec->getType()));
 
     // Get index expression temp (accessed index)
-    std::string *t1 = this->getChild(1)->getTemp();
+    Operand *t1 = this->getChild(1)->getTemp();
 
     // Get rbss name (Vectores are always global)
-    std::string *rbss = Tac::getName("rbss");
+    Operand *rbss = Operand::getBase(BASE_RBSS);
 
     // Create new temporary registers
-    std::string *t2 = Tac::newRegister();
-    std::string *t3 = Tac::newRegister();
-    std::string *t4 = Tac::newRegister();
+    Operand *t2 = Tac::newRegister();
+    Operand *t3 = Tac::newRegister();
+    Operand *t4 = Tac::newRegister();
 
     //
 
     // Get index calculation code
-    calculate_index_code = this->getChild(1)->getCode();
+    calculate_index_code = this->getChild(1)->takeCode();
 
     // Generate code for acessing the vector
     calculate_vector_base = new Tac(ILOC_ADDI, rbss, base, t2); // addI rbss, base => t2
@@ -587,9 +689,9 @@ Tac *Node::generateLvalVectorTAC()
     calculate_indexed_position = new Tac(ILOC_ADD, t2, t3, t4); // add t2, t3 => t4
 
     // Link instructions together
-    calculate_index_code->addLast(calculate_vector_base);
-    calculate_vector_base->addLast(calculate_offset);
-    calculate_offset->addLast(calculate_indexed_position);
+    calculate_index_code.append(calculate_vector_base);
+    calculate_index_code.append(calculate_offset);
+    calculate_index_code.append(calculate_indexed_position);
 
     //
 
@@ -603,10 +705,10 @@ Tac *Node::generateLvalVectorTAC()
     return calculate_index_code;
 }
 
-Tac *Node::generateRvalVectorTAC()
+TacList Node::generateRvalVectorTAC()
 {
     // Instructions
-    Tac *calculate_address = NULL; // t1 = calculate indexed address
+    TacList calculate_address;     // t1 = calculate indexed address
     Tac *load_actual_value = NULL; // t1 = mem(t1)
 
     // Calculate base address for the indexed position
@@ -616,7 +718,7 @@ Tac *Node::generateRvalVectorTAC()
     load_actual_value = new Tac(ILOC_LOAD, this->temp, this->temp); // load t1 => t1
 
     // Link instructions together
-    calculate_address->addLast(load_actual_value);
+    calculate_address.append(load_actual_value);
 
     //  Mark this node as having a value
     this->setValue();
@@ -625,67 +727,68 @@ Tac *Node::generateRvalVectorTAC()
     return calculate_address;
 }
 
-Tac *Node::generateInitializationTAC()
+TacList Node::generateInitializationTAC()
 {
     // Instructions
-    Tac *calculate_lval = NULL; // t1 = lval address
-    Tac *calculate_rval = NULL; // t2 = rval value (literal)
-    Tac *store_result = NULL;   // Mem(t1) = t2
+    TacList calculate_lval;   // t1 = lval address
+    TacList calculate_rval;   // t2 = rval value (literal)
+    Tac *store_result = NULL; // Mem(t1) = t2
 
     // Generate code for lval child
     this->getChild(0)->generateCode();
 
     // Get code for lval and rval
-    calculate_lval = this->getChild(0)->getCode();
-    calculate_rval = this->getChild(1)->getCode();
+    calculate_lval = this->getChild(0)->takeCode();
+    calculate_rval = this->getChild(1)->takeValueCode();
 
     // Temporary registers
-    std::string *t1 = this->getChild(0)->getTemp();
-    std::string *t2 = this->getChild(1)->getTemp();
+    Operand *t1 = this->getChild(0)->getTemp();
+    Operand *t2 = this->getChild(1)->getTemp();
 
     // Generate code for store instruction
     store_result = new Tac(ILOC_STORE, t2, t1); // store t2 => t1
 
     // Link code together
-    calculate_rval->addLast(calculate_lval);
-    calculate_lval->addLast(store_result);
+    calculate_rval.concatenate(calculate_lval);
+    calculate_rval.append(store_result);
 
     // Return first instruction in the code block
     return calculate_rval;
 }
 
-Tac *Node::generateAttributionTAC()
+TacList Node::generateAttributionTAC()
 {
     // Common Instructions
-    Tac *calculate_lval = NULL; // t1 = lval address
-    Tac *calculate_rval = NULL; // t2 = rval value
-    Tac *store_result = NULL;   // Mem(t1) = t2
+    TacList calculate_lval;   // t1 = lval address
+    TacList calculate_rval;   // t2 = rval value
+    Tac *store_result = NULL; // Mem(t1) = t2
 
     // Additional instructions (Used if rval is a logic expression)
     Tac *attribute_true = NULL;  // loadI 1 => t2
     Tac *attribute_false = NULL; // loadI 0 => t2
     Tac *jump_exit = NULL;       // jumpI -> l3
     Tac *nop = NULL;             // nop
+    TacList attribute_code;      // All of the above, in order
 
     // Strings for true and false literal (Used if rval is a logic expression)
-    std::string *true_literal = NULL;
-    std::string *false_literal = NULL;
+    Operand *true_literal = NULL;
+    Operand *false_literal = NULL;
 
     // Labels (Used if rval is a logic expression)
-    std::string *l1 = NULL;
-    std::string *l2 = NULL;
-    std::string *l3 = NULL;
+    Operand *l1 = NULL;
+    Operand *l2 = NULL;
+    Operand *l3 = NULL;
 
     // Get temporary registers for lval and rval
-    std::string *t1 = this->getChild(0)->getTemp();
-    std::string *t2 = NULL;
+    Operand *t1 = this->getChild(0)->getTemp();
+    Operand *t2 = NULL;
 
     // Get code for lval and rval
-    calculate_lval = this->getChild(0)->getCode();
-    calculate_rval = this->getChild(1)->getCode();
+    calculate_lval = this->getChild(0)->takeCode();
+    calculate_rval = this->getChild(1)->takeValueCode();
 
-    // If rval is a logic operation
-    if (logic_binop_code.find(this->getChild(1)->getName()) != logic_binop_code.end())
+    // If rval is a logic operation (Comparisons already wrote their value)
+    if (!this->getChild(1)->isComparison() && logic_binop_code.find(this->getChild(1)->getName()) != logic_binop_code.end())
     {
         // Generate labels for attribution
         l1 = Tac::newLabel(); // Where to go if expession is true
@@ -693,8 +796,8 @@ Tac *Node::generateAttributionTAC()
         l3 = Tac::newLabel(); // Where to go at the end
 
         // Generate names for true and false literals
-        true_literal = Tac::getName(std::to_string(1));
-        false_literal = Tac::getName(std::to_string(0));
+        true_literal = Tac::getImmediate(1);
+        false_literal = Tac::getImmediate(0);
 
         // Create new temporary register for logic expression result
         t2 = Tac::newRegister();
@@ -719,9 +822,10 @@ Tac *Node::generateAttributionTAC()
         this->getChild(1)->clearFalseList();
 
         // Link additional code together
-        attribute_true->addLast(jump_exit);
-        jump_exit->addLast(attribute_false);
-        attribute_false->addLast(nop);
+        attribute_code.append(attribute_true);
+        attribute_code.append(jump_exit);
+        attribute_code.append(attribute_false);
+        attribute_code.append(nop);
     }
     else
     {
@@ -733,23 +837,23 @@ Tac *Node::generateAttributionTAC()
     store_result = new Tac(ILOC_STORE, t2, t1); // store t2 => t1
 
     // Link code common to both cases
-    calculate_rval->addLast(attribute_true);
-    calculate_rval->addLast(calculate_lval);
-    calculate_lval->addLast(store_result);
+    calculate_rval.concatenate(attribute_code);
+    calculate_rval.concatenate(calculate_lval);
+    calculate_rval.append(store_result);
 
     // Return first instruction in the code block
     return calculate_rval;
 }
 
-Tac *Node::generateUnopTAC(std::string op)
+TacList Node::generateUnopTAC(std::string op)
 {
-    Tac *code = NULL;
+    TacList code;
 
     // If code is for a logic NOT
     if (!strcmp(op.c_str(), "!"))
     {
         // Get child code
-        code = this->getChild(0)->getCode();
+        code = this->getChild(0)->takeCode();
 
         // Swap true and false lists
         this->true_list = this->getChild(0)->getFalseList();
@@ -760,20 +864,20 @@ Tac *Node::generateUnopTAC(std::string op)
     if (!strcmp(op.c_str(), "-"))
     {
         // Operand code
-        Tac *operand_code = this->getChild(0)->getCode();
+        TacList operand_code = this->getChild(0)->takeValueCode();
 
         // Names
-        std::string *const_0 = Tac::getName(std::to_string(0));
+        Operand *const_0 = Tac::getImmediate(0);
 
         // Temporary registers
-        std::string *t1 = this->getChild(0)->getTemp();
-        std::string *t2 = Tac::newRegister();
+        Operand *t1 = this->getChild(0)->getTemp();
+        Operand *t2 = Tac::newRegister();
 
         // Generate code
-        code = new Tac(ILOC_RSUBI, t1, const_0, t2); // rsubI t1, 0 => t2
+        code = TacList(new Tac(ILOC_RSUBI, t1, const_0, t2)); // rsubI t1, 0 => t2
 
         // Link code together
-        code->addLast(operand_code);
+        code.concatenate(operand_code);
 
         // Set this node's temp
         this->setTemp(t2);
@@ -786,12 +890,17 @@ Tac *Node::generateUnopTAC(std::string op)
     return code;
 }
 
-Tac *Node::generateBinopTAC(std::string op)
+TacList Node::generateBinopTAC(std::string op)
 {
-    Tac *code = NULL;
+    TacList code;
 
+    // Arithmetic operations with no single ILOC instruction
+    if (op == "%")
+        code = generateModuloTAC();
+    else if (op == "^")
+        code = generatePowerTAC();
     // If code is in the binary arithmetic operation list
-    if (arithmetic_binop_code.find(op) != arithmetic_binop_code.end())
+    else if (arithmetic_binop_code.find(op) != arithmetic_binop_code.end())
     {
         // std::cout << "Making an arithmetic binop TAC sequence" << std::endl;
 
@@ -815,25 +924,25 @@ Tac *Node::generateBinopTAC(std::string op)
     return code;
 }
 
-Tac *Node::generateArithmeticBinopTAC(ILOCop op)
+TacList Node::generateArithmeticBinopTAC(ILOCop op)
 {
     // Instructions
-    Tac *left_operand_code = NULL;     // t1 = calculate left expression
-    Tac *right_operand_code = NULL;    // t2 = calculate right expression
+    TacList left_operand_code;         // t1 = calculate left expression
+    TacList right_operand_code;        // t2 = calculate right expression
     Tac *operation_instruction = NULL; // t3 = t1 op t2
 
     // Generate temporary registers from left and right operand
-    std::string *t1 = this->getChild(0)->getTemp();
-    std::string *t2 = this->getChild(1)->getTemp();
+    Operand *t1 = this->getChild(0)->getTemp();
+    Operand *t2 = this->getChild(1)->getTemp();
 
     // Get new temporary register for result
-    std::string *t3 = Tac::newRegister();
+    Operand *t3 = Tac::newRegister();
 
     //
 
     // Get left and right operation's code
-    left_operand_code = this->getChild(0)->getCode();
-    right_operand_code = this->getChild(1)->getCode();
+    left_operand_code = this->getChild(0)->takeValueCode();
+    right_operand_code = this->getChild(1)->takeValueCode();
 
     // Generate code for arithmetic operation
     operation_instruction = new Tac(op, t1, t2, t3); // op t1, t2 => t3
@@ -841,8 +950,8 @@ Tac *Node::generateArithmeticBinopTAC(ILOCop op)
     //
 
     // Link code together
-    left_operand_code->addLast(right_operand_code);
-    right_operand_code->addLast(operation_instruction);
+    left_operand_code.concatenate(right_operand_code);
+    left_operand_code.append(operation_instruction);
 
     // Set t3 as this node's temp
     this->setTemp(t3);
@@ -854,16 +963,152 @@ Tac *Node::generateArithmeticBinopTAC(ILOCop op)
     return left_operand_code;
 }
 
-Tac *Node::generateAndTAC()
+TacList Node::generateModuloTAC()
+{
+    // Instructions
+    TacList left_operand_code;         // t1 = calculate left expression
+    TacList right_operand_code;        // t2 = calculate right expression
+    Tac *division_instruction = NULL;  // t3 = t1 / t2
+    Tac *multiply_instruction = NULL;  // t4 = t3 * t2
+    Tac *remainder_instruction = NULL; // t5 = t1 - t4
+
+    // Generate temporary registers from left and right operand
+    Operand *t1 = this->getChild(0)->getTemp();
+    Operand *t2 = this->getChild(1)->getTemp();
+
+    // Get new temporary registers for the quotient and the result
+    Operand *t3 = Tac::newRegister();
+    Operand *t4 = Tac::newRegister();
+    Operand *t5 = Tac::newRegister();
+
+    //
+
+    // Get left and right operation's code
+    left_operand_code = this->getChild(0)->takeValueCode();
+    right_operand_code = this->getChild(1)->takeValueCode();
+
+    // Generate code for the division and what is left of it
+    division_instruction = new Tac(ILOC_DIV, t1, t2, t3);  // div  t1, t2 => t3
+    multiply_instruction = new Tac(ILOC_MULT, t3, t2, t4); // mult t3, t2 => t4
+    remainder_instruction = new Tac(ILOC_SUB, t1, t4, t5); // sub  t1, t4 => t5
+
+    //
+
+    // Link code together
+    left_operand_code.concatenate(right_operand_code);
+    left_operand_code.append(division_instruction);
+    left_operand_code.append(multiply_instruction);
+    left_operand_code.append(remainder_instruction);
+
+    // Set t5 as this node's temp
+    this->setTemp(t5);
+
+    // Mark this node as having a value
+    this->setValue();
+
+    // Return first instruction in the generated code block
+    return left_operand_code;
+}
+
+TacList Node::generatePowerTAC()
+{
+    // Instructions
+    TacList left_operand_code;  // t1 = calculate base
+    TacList right_operand_code; // t2 = calculate exponent
+
+    // Generate temporary registers from left and right operand
+    Operand *t1 = this->getChild(0)->getTemp();
+    Operand *t2 = this->getChild(1)->getTemp();
+
+    // Get new temporary registers for the result and the base, squared at each step
+    Operand *t3 = Tac::newRegister();
+    Operand *t4 = Tac::newRegister();
+
+    //
+
+    // Get left and right operation's code
+    left_operand_code = this->getChild(0)->takeValueCode();
+    right_operand_code = this->getChild(1)->takeValueCode();
+
+    left_operand_code.concatenate(right_operand_code);
+    left_operand_code.append(new Tac(ILOC_LOADI, Tac::getImmediate(1), t3)); // loadI 1  => t3
+    left_operand_code.append(new Tac(ILOC_I2I, t1, t4));                    // i2i   t1 => t4
+
+    if (this->getChild(1)->isConstant())
+    {
+        // Multiply by the base squared once for each bit of the exponent (None if negative)
+        for (int exponent = this->getChild(1)->getValue()->getInteger(); exponent > 0; exponent >>= 1)
+        {
+            if (exponent & 1)
+                left_operand_code.append(new Tac(ILOC_MULT, t3, t4, t3)); // mult t3, t4 => t3
+
+            if (exponent > 1)
+                left_operand_code.append(new Tac(ILOC_MULT, t4, t4, t4)); // mult t4, t4 => t4
+        }
+    }
+    else
+    {
+        // Temporary registers for the exponent, halved at each step, and the loop's conditions
+        Operand *t5 = Tac::newRegister();
+        Operand *t6 = Tac::newRegister();
+        Operand *t7 = Tac::newRegister();
+        Operand *t8 = Tac::newRegister();
+        Operand *t9 = Tac::newRegister();
+
+        // Labels
+        Operand *l1 = Tac::newLabel(); // Loop condition
+        Operand *l2 = Tac::newLabel(); // Checks the exponent's lowest bit
+        Operand *l3 = Tac::newLabel(); // Multiplies the result
+        Operand *l4 = Tac::newLabel(); // Squares the base
+        Operand *l5 = Tac::newLabel(); // After the loop
+
+        Tac *condition = new Tac(ILOC_LOADI, Tac::getImmediate(0), t6); // l1: loadI 0 => t6
+        Tac *lowest_bit = new Tac(ILOC_ANDI, t5, Tac::getImmediate(1), t8); // l2: andI t5, 1 => t8
+        Tac *multiply = new Tac(ILOC_MULT, t3, t4, t3);                 // l3: mult t3, t4 => t3
+        Tac *square = new Tac(ILOC_MULT, t4, t4, t4);                   // l4: mult t4, t4 => t4
+        Tac *nop = new Tac(ILOC_NOP);                                   // l5: nop
+
+        left_operand_code.append(new Tac(ILOC_I2I, t2, t5)); // i2i t2 => t5
+        left_operand_code.append(condition);
+        left_operand_code.append(new Tac(ILOC_CMP_GT, t5, t6, t7)); // cmp_GT t5, t6 => t7
+        left_operand_code.append(new Tac(ILOC_CBR, t7, l2, l5));    // cbr t7 => l2, l5
+        left_operand_code.append(lowest_bit);
+        left_operand_code.append(new Tac(ILOC_CMP_NE, t8, t6, t9)); // cmp_NE t8, t6 => t9
+        left_operand_code.append(new Tac(ILOC_CBR, t9, l3, l4));    // cbr t9 => l3, l4
+        left_operand_code.append(multiply);
+        left_operand_code.append(square);
+        left_operand_code.append(new Tac(ILOC_RSHIFTI, t5, Tac::getImmediate(1), t5)); // rshiftI t5, 1 => t5
+        left_operand_code.append(new Tac(ILOC_JUMPI, l1));                            // jumpI l1
+        left_operand_code.append(nop);
+
+        // Label code
+        condition->setLabel(l1);
+        lowest_bit->setLabel(l2);
+        multiply->setLabel(l3);
+        square->setLabel(l4);
+        nop->setLabel(l5);
+    }
+
+    // Set t3 as this node's temp
+    this->setTemp(t3);
+
+    // Mark this node as having a value
+    this->setValue();
+
+    // Return first instruction in the generated code block
+    return left_operand_code;
+}
+
+TacList Node::generateAndTAC()
 {
     // Instructions from the operands
-    Tac *left_operand_code = NULL;
-    Tac *right_operand_code = NULL;
+    TacList left_operand_code;
+    TacList right_operand_code;
 
     //
 
     // New label used for backpatching
-    std::string *l1 = Tac::newLabel();
+    Operand *l1 = Tac::newLabel();
 
     // Patch true list from left operand
     Tac::patch(this->getChild(0)->getTrueList(), l1);
@@ -881,29 +1126,29 @@ Tac *Node::generateAndTAC()
     //
 
     // Get operand's code
-    left_operand_code = this->getChild(0)->getCode();
-    right_operand_code = this->getChild(1)->getCode();
+    left_operand_code = this->getChild(0)->takeCode();
+    right_operand_code = this->getChild(1)->takeCode();
 
     // Link codes together
-    left_operand_code->addLast(right_operand_code);
+    left_operand_code.concatenate(right_operand_code);
 
     // Label right operand code with new label
-    right_operand_code->setLabel(l1);
+    right_operand_code.getFirst()->setLabel(l1);
 
     // Return first instruction in the code block
     return left_operand_code;
 }
 
-Tac *Node::generateOrTAC()
+TacList Node::generateOrTAC()
 {
     // Instructions from the operands
-    Tac *left_operand_code = NULL;
-    Tac *right_operand_code = NULL;
+    TacList left_operand_code;
+    TacList right_operand_code;
 
     //
 
     // New label used for backpatching
-    std::string *l1 = Tac::newLabel();
+    Operand *l1 = Tac::newLabel();
 
     // Patch false list from left operand
     Tac::patch(this->getChild(0)->getFalseList(), l1);
@@ -921,52 +1166,52 @@ Tac *Node::generateOrTAC()
     //
 
     // Get operand's code
-    left_operand_code = this->getChild(0)->getCode();
-    right_operand_code = this->getChild(1)->getCode();
+    left_operand_code = this->getChild(0)->takeCode();
+    right_operand_code = this->getChild(1)->takeCode();
 
     // Link codes together
-    left_operand_code->addLast(right_operand_code);
+    left_operand_code.concatenate(right_operand_code);
 
     // Label right operand code with new label
-    right_operand_code->setLabel(l1);
+    right_operand_code.getFirst()->setLabel(l1);
 
     // Return first instruction in the code block
     return left_operand_code;
 }
 
-Tac *Node::generateComparisonTAC(ILOCop op)
+TacList Node::generateComparisonTAC(ILOCop op)
 {
     // Instructions
-    Tac *left_operand_code = NULL;
-    Tac *right_operand_code = NULL;
+    TacList left_operand_code;
+    TacList right_operand_code;
     Tac *compare_instruction = NULL;
     Tac *branch_instruction = NULL;
 
     // Holes to-be-patched
-    std::string *h1 = Tac::newHole(); // true
-    std::string *h2 = Tac::newHole(); // false
+    Operand *h1 = Tac::newHole(); // true
+    Operand *h2 = Tac::newHole(); // false
 
     // Get operands' temporary registers
-    std::string *t1 = this->getChild(0)->getTemp();
-    std::string *t2 = this->getChild(1)->getTemp();
+    Operand *t1 = this->getChild(0)->getTemp();
+    Operand *t2 = this->getChild(1)->getTemp();
 
     // Generate temporary register for comparison result
-    std::string *t3 = Tac::newRegister();
+    Operand *t3 = Tac::newRegister();
 
     //
 
     // Get code from operands
-    left_operand_code = this->getChild(0)->getCode();
-    right_operand_code = this->getChild(1)->getCode();
+    left_operand_code = this->getChild(0)->takeValueCode();
+    right_operand_code = this->getChild(1)->takeValueCode();
 
     // Generate code for comparing operands and branching
     compare_instruction = new Tac(op, t1, t2, t3);      // op t1, t2 => t3
     branch_instruction = new Tac(ILOC_CBR, t3, h1, h2); // cbr t3 -> H1, H2
 
     // Link instructions together
-    left_operand_code->addLast(right_operand_code);
-    right_operand_code->addLast(compare_instruction);
-    compare_instruction->addLast(branch_instruction);
+    left_operand_code.concatenate(right_operand_code);
+    left_operand_code.append(compare_instruction);
+    left_operand_code.append(branch_instruction);
 
     // Add holes to true and false lists
     this->true_list.push_back(h1);
@@ -982,9 +1227,9 @@ Tac *Node::generateComparisonTAC(ILOCop op)
     return left_operand_code;
 }
 
-Tac *Node::generateLogicBinopTAC(ILOCop op)
+TacList Node::generateLogicBinopTAC(ILOCop op)
 {
-    Tac *code = NULL;
+    TacList code;
 
     switch (op)
     {
@@ -1009,12 +1254,12 @@ Tac *Node::generateLogicBinopTAC(ILOCop op)
     return code;
 }
 
-Tac *Node::generateTernopTAC()
+TacList Node::generateTernopTAC()
 {
     // Common instructions
-    Tac *condition_code = NULL;
-    Tac *then_code = NULL;
-    Tac *else_code = NULL;
+    TacList condition_code;
+    TacList then_code;
+    TacList else_code;
     Tac *jump_exit = NULL;
     Tac *attribute_true = NULL;
     Tac *attribute_false = NULL;
@@ -1025,38 +1270,40 @@ Tac *Node::generateTernopTAC()
     Tac *then_attribute_false = NULL; // loadI 0 => t2
     Tac *then_jump_exit = NULL;       // jumpI -> l3
     Tac *then_nop = NULL;             // nop
+    TacList then_logic_code;          // All of the above, in order
 
     // Additional instructions (Used if else statement is a logic expression)
     Tac *else_attribute_true = NULL;  // loadI 1 => t2
     Tac *else_attribute_false = NULL; // loadI 0 => t2
     Tac *else_jump_exit = NULL;       // jumpI -> l3
     Tac *else_nop = NULL;             // nop
+    TacList else_logic_code;          // All of the above, in order
 
     // Temporary registers
-    std::string *t1 = NULL;
-    std::string *t2 = NULL;
-    std::string *t3 = Tac::newRegister();
+    Operand *t1 = NULL;
+    Operand *t2 = NULL;
+    Operand *t3 = Tac::newRegister();
 
     // Strings for true and false literals (If true or false statment is a logic expression)
-    std::string *then_true_literal = NULL;
-    std::string *then_false_literal = NULL;
-    std::string *else_true_literal = NULL;
-    std::string *else_false_literal = NULL;
+    Operand *then_true_literal = NULL;
+    Operand *then_false_literal = NULL;
+    Operand *else_true_literal = NULL;
+    Operand *else_false_literal = NULL;
 
     // Labels
-    std::string *l1 = Tac::newLabel();
-    std::string *l2 = Tac::newLabel();
-    std::string *l3 = Tac::newLabel();
+    Operand *l1 = Tac::newLabel();
+    Operand *l2 = Tac::newLabel();
+    Operand *l3 = Tac::newLabel();
 
     // Labels if true statement is a logic operation
-    std::string *l4 = NULL;
-    std::string *l5 = NULL;
-    std::string *l6 = NULL;
+    Operand *l4 = NULL;
+    Operand *l5 = NULL;
+    Operand *l6 = NULL;
 
     // Labels if false statement is a logic operation
-    std::string *l7 = NULL;
-    std::string *l8 = NULL;
-    std::string *l9 = NULL;
+    Operand *l7 = NULL;
+    Operand *l8 = NULL;
+    Operand *l9 = NULL;
 
     // Backpatch condition's true and false statements
     Tac::patch(this->getChild(1)->getTrueList(), l1);
@@ -1067,12 +1314,12 @@ Tac *Node::generateTernopTAC()
     this->getChild(1)->clearFalseList();
 
     // Get condition, then-statment and else-statement codes
-    then_code = this->getChild(0)->getCode();
-    condition_code = this->getChild(1)->getCode();
-    else_code = this->getChild(2)->getCode();
+    then_code = this->getChild(0)->takeValueCode();
+    condition_code = this->getChild(1)->takeCode();
+    else_code = this->getChild(2)->takeValueCode();
 
     // If then statement is a logic operation
-    if (logic_binop_code.find(this->getChild(0)->getName()) != logic_binop_code.end())
+    if (!this->getChild(0)->isComparison() && logic_binop_code.find(this->getChild(0)->getName()) != logic_binop_code.end())
     {
         // Generate new labels
         l4 = Tac::newLabel();
@@ -1080,8 +1327,8 @@ Tac *Node::generateTernopTAC()
         l6 = Tac::newLabel();
 
         // Generate names for true and false literals
-        then_true_literal = Tac::getName(std::to_string(1));
-        then_false_literal = Tac::getName(std::to_string(0));
+        then_true_literal = Tac::getImmediate(1);
+        then_false_literal = Tac::getImmediate(0);
 
         // Create temporary register for result
         t1 = Tac::newRegister();
@@ -1106,9 +1353,10 @@ Tac *Node::generateTernopTAC()
         this->getChild(0)->clearFalseList();
 
         // Link additional code together
-        then_attribute_true->addLast(then_jump_exit);
-        then_jump_exit->addLast(then_attribute_false);
-        then_attribute_false->addLast(then_nop);
+        then_logic_code.append(then_attribute_true);
+        then_logic_code.append(then_jump_exit);
+        then_logic_code.append(then_attribute_false);
+        then_logic_code.append(then_nop);
     }
     // If not
     else
@@ -1118,7 +1366,7 @@ Tac *Node::generateTernopTAC()
     }
 
     // If else statement is a logic operation
-    if (logic_binop_code.find(this->getChild(2)->getName()) != logic_binop_code.end())
+    if (!this->getChild(2)->isComparison() && logic_binop_code.find(this->getChild(2)->getName()) != logic_binop_code.end())
     {
         // Generate new labels
         l7 = Tac::newLabel();
@@ -1126,8 +1374,8 @@ Tac *Node::generateTernopTAC()
         l9 = Tac::newLabel();
 
         // Generate names for true and false literals
-        else_true_literal = Tac::getName(std::to_string(1));
-        else_false_literal = Tac::getName(std::to_string(0));
+        else_true_literal = Tac::getImmediate(1);
+        else_false_literal = Tac::getImmediate(0);
 
         // Create temporary register for result
         t2 = Tac::newRegister();
@@ -1152,9 +1400,10 @@ Tac *Node::generateTernopTAC()
         this->getChild(2)->clearFalseList();
 
         // Link additional code together
-        else_attribute_true->addLast(else_jump_exit);
-        else_jump_exit->addLast(else_attribute_false);
-        else_attribute_false->addLast(else_nop);
+        else_logic_code.append(else_attribute_true);
+        else_logic_code.append(else_jump_exit);
+        else_logic_code.append(else_attribute_false);
+        else_logic_code.append(else_nop);
     }
     // If not
     else
@@ -1170,22 +1419,22 @@ Tac *Node::generateTernopTAC()
     nop = new Tac(ILOC_NOP);                     // L3: nop
 
     // Link code together
-    condition_code->addLast(then_code);
+    condition_code.concatenate(then_code);
 
-    then_code->addLast(then_attribute_true); // Convert logic expression to 1 or 0
-    then_code->addLast(attribute_true);
-    then_code->addLast(jump_exit);
+    condition_code.concatenate(then_logic_code); // Convert logic expression to 1 or 0
+    condition_code.append(attribute_true);
+    condition_code.append(jump_exit);
 
-    jump_exit->addLast(else_code);
+    condition_code.concatenate(else_code);
 
-    else_code->addLast(else_attribute_true); // Convert logic expression to 1 or 0
-    else_code->addLast(attribute_false);
-    else_code->addLast(nop);
+    condition_code.concatenate(else_logic_code); // Convert logic expression to 1 or 0
+    condition_code.append(attribute_false);
+    condition_code.append(nop);
 
     // Label code
-    then_code->setLabel(l1);
-    else_code->setLabel(l2);
-    jump_exit->setLabel(l3);
+    then_code.getFirst()->setLabel(l1);
+    else_code.getFirst()->setLabel(l2);
+    nop->setLabel(l3);
 
     // Set this node's temp
     this->setTemp(t3);
@@ -1197,16 +1446,16 @@ Tac *Node::generateTernopTAC()
     return condition_code;
 }
 
-Tac *Node::generateIfTAC()
+TacList Node::generateIfTAC()
 {
     // Instructions
-    Tac *condition_code = NULL;
-    Tac *then_code = NULL;
+    TacList condition_code;
+    TacList then_code;
     Tac *nop = NULL;
 
     // Labels
-    std::string *l1 = Tac::newLabel(); // Where to go if true
-    std::string *l2 = Tac::newLabel(); // Where to go if false and when done
+    Operand *l1 = Tac::newLabel(); // Where to go if true
+    Operand *l2 = Tac::newLabel(); // Where to go if false and when done
 
     // Backpatch condition's true and false list
     Tac::patch(this->getChild(0)->getTrueList(), l1);
@@ -1217,37 +1466,37 @@ Tac *Node::generateIfTAC()
     this->getChild(0)->clearFalseList();
 
     // Get condition and then-statement codes
-    condition_code = this->getChild(0)->getCode();
-    then_code = this->getChild(1)->getCode();
+    condition_code = this->getChild(0)->takeCode();
+    then_code = this->getChild(1)->takeCode();
 
     // Create the nop code
     nop = new Tac(ILOC_NOP);
 
     // Link instructions together
-    condition_code->addLast(then_code);
-    condition_code->addLast(nop);
+    condition_code.concatenate(then_code);
+    condition_code.append(nop);
 
     // Label instructions
-    then_code->setLabel(l1);
+    Node::labelInstruction(condition_code, then_code.getFirst(), l1);
     nop->setLabel(l2);
 
     // Return first instruction in the code block
     return condition_code;
 }
 
-Tac *Node::generateIfElseTAC()
+TacList Node::generateIfElseTAC()
 {
     // Instructions
-    Tac *condition_code = NULL;
-    Tac *then_code = NULL;
-    Tac *else_code = NULL;
+    TacList condition_code;
+    TacList then_code;
+    TacList else_code;
     Tac *jump_exit = NULL;
     Tac *nop = NULL;
 
     // Labels
-    std::string *l1 = Tac::newLabel(); // Where to go if true
-    std::string *l2 = Tac::newLabel(); // Where to go if false
-    std::string *l3 = Tac::newLabel(); // Where to go when done
+    Operand *l1 = Tac::newLabel(); // Where to go if true
+    Operand *l2 = Tac::newLabel(); // Where to go if false
+    Operand *l3 = Tac::newLabel(); // Where to go when done
 
     // Backpatch condition's true and false list
     Tac::patch(this->getChild(0)->getTrueList(), l1);
@@ -1260,43 +1509,43 @@ Tac *Node::generateIfElseTAC()
     //
 
     // Get condition, then-statement and else-statement codes
-    condition_code = this->getChild(0)->getCode();
-    then_code = this->getChild(1)->getCode();
-    else_code = this->getChild(2)->getCode();
+    condition_code = this->getChild(0)->takeCode();
+    then_code = this->getChild(1)->takeCode();
+    else_code = this->getChild(2)->takeCode();
 
     // Create the jump and nop codes
     nop = new Tac(ILOC_NOP);             // nop
     jump_exit = new Tac(ILOC_JUMPI, l3); // jumpI -> l3
 
     // Link instructions together
-    condition_code->addLast(then_code);
-    condition_code->addLast(jump_exit);
-    jump_exit->addLast(else_code);
-    else_code->addLast(nop);
+    condition_code.concatenate(then_code);
+    condition_code.append(jump_exit);
+    condition_code.concatenate(else_code);
+    condition_code.append(nop);
 
     // Label instructions
-    then_code->setLabel(l1);
-    else_code->setLabel(l2);
+    Node::labelInstruction(condition_code, then_code.getFirst(), l1);
+    Node::labelInstruction(condition_code, else_code.getFirst(), l2);
     nop->setLabel(l3);
 
     // Return first instruction in the generated code block
     return condition_code;
 }
 
-Tac *Node::generateForTAC()
+TacList Node::generateForTAC()
 {
     // Instructions
-    Tac *initial_attribution_code = NULL;
-    Tac *condition_code = NULL;
-    Tac *do_code = NULL;
-    Tac *loop_attribution_code = NULL;
+    TacList initial_attribution_code;
+    TacList condition_code;
+    TacList do_code;
+    TacList loop_attribution_code;
     Tac *jump_back = NULL;
     Tac *nop = NULL;
 
     // Labels
-    std::string *l1 = Tac::newLabel(); // Where to go if true
-    std::string *l2 = Tac::newLabel(); // Where to go if false
-    std::string *l3 = Tac::newLabel(); // Where to go after a loop
+    Operand *l1 = Tac::newLabel(); // Where to go if true
+    Operand *l2 = Tac::newLabel(); // Where to go if false
+    Operand *l3 = Tac::newLabel(); // Where to go after a loop
 
     // Backpatch condition's true and false statements
     Tac::patch(this->getChild(1)->getTrueList(), l1);
@@ -1309,45 +1558,50 @@ Tac *Node::generateForTAC()
     //
 
     // Get initial attribution, condition, loop attribution and do-statement codes
-    initial_attribution_code = this->getChild(0)->getCode();
-    condition_code = this->getChild(1)->getCode();
-    loop_attribution_code = this->getChild(2)->getCode();
-    do_code = this->getChild(3)->getCode();
+    initial_attribution_code = this->getChild(0)->takeCode();
+    condition_code = this->getChild(1)->takeCode();
+    loop_attribution_code = this->getChild(2)->takeCode();
+    do_code = this->getChild(3)->takeCode();
 
     // Create jump and nop codes
     jump_back = new Tac(ILOC_JUMPI, l3); // jumpI l3
     nop = new Tac(ILOC_NOP);             // nop
 
     // Link code together
-    initial_attribution_code->addLast(condition_code);
-    condition_code->addLast(do_code);
+    initial_attribution_code.concatenate(condition_code);
+    initial_attribution_code.concatenate(do_code);
 
-    do_code->addLast(loop_attribution_code);
-    do_code->addLast(jump_back);
+    initial_attribution_code.concatenate(loop_attribution_code);
+    initial_attribution_code.append(jump_back);
 
-    jump_back->addLast(nop);
+    initial_attribution_code.append(nop);
 
-    // Label code
-    do_code->setLabel(l1);
+    // Label code (A condition that is always true has no code, the loop goes back to its body)
+    if (condition_code.isEmpty())
+        Node::labelInstruction(initial_attribution_code, do_code.getFirst(), l3);
+    else
+    {
+        Node::labelInstruction(initial_attribution_code, do_code.getFirst(), l1);
+        Node::labelInstruction(initial_attribution_code, condition_code.getFirst(), l3);
+    }
     nop->setLabel(l2);
-    condition_code->setLabel(l3);
 
     // Return first instruction in the generated code block
     return initial_attribution_code;
 }
 
-Tac *Node::generateWhileTAC()
+TacList Node::generateWhileTAC()
 {
     // Instructions
-    Tac *condition_code = NULL;
-    Tac *do_code = NULL;
+    TacList condition_code;
+    TacList do_code;
     Tac *jump_back = NULL;
     Tac *nop = NULL;
 
     // Labels
-    std::string *l1 = Tac::newLabel(); // Where to go if true
-    std::string *l2 = Tac::newLabel(); // Where to go if false
-    std::string *l3 = Tac::newLabel(); // Where to go after a loop
+    Operand *l1 = Tac::newLabel(); // Where to go if true
+    Operand *l2 = Tac::newLabel(); // Where to go if false
+    Operand *l3 = Tac::newLabel(); // Where to go after a loop
 
     // Backpatch condition's true and false lists
     Tac::patch(this->getChild(0)->getTrueList(), l1);
@@ -1360,78 +1614,86 @@ Tac *Node::generateWhileTAC()
     //
 
     // Get condition and do-statement codes
-    condition_code = this->getChild(0)->getCode();
-    do_code = this->getChild(1)->getCode();
+    condition_code = this->getChild(0)->takeCode();
+    do_code = this->getChild(1)->takeCode();
 
     // Create jump back and nop codes
     jump_back = new Tac(ILOC_JUMPI, l3); // jumpI -> l3
     nop = new Tac(ILOC_NOP);             // nop
 
     // Link code together
-    condition_code->addLast(do_code);
-    condition_code->addLast(jump_back);
-    jump_back->addLast(nop);
+    condition_code.concatenate(do_code);
+    condition_code.append(jump_back);
+    condition_code.append(nop);
 
     // Label code
-    do_code->setLabel(l1);
+    Node::labelInstruction(condition_code, do_code.getFirst(), l1);
+    Node::labelInstruction(condition_code, condition_code.getFirst(), l3);
     nop->setLabel(l2);
-    condition_code->setLabel(l3);
 
     // Return first instruction in the generated code block
     return condition_code;
 }
 
-Tac *Node::generateShiftTAC(ILOCop op)
+TacList Node::generateShiftTAC(ILOCop op)
 {
     // Instructions
-    Tac *calculate_variable_address = NULL;
-    Tac *calculate_shift_amount = NULL;
+    TacList calculate_variable_address;
+    TacList calculate_shift_amount;
     Tac *load_actual_value = NULL;
     Tac *shift_instruction = NULL;
     Tac *store_new_value = NULL;
 
     // Get temporary registers
-    std::string *t1 = this->getChild(0)->getTemp();
-    std::string *t2 = this->getChild(1)->getTemp();
+    Operand *t1 = this->getChild(0)->getTemp();
+    Operand *t2 = this->getChild(1)->getTemp();
 
     // New temporary register to store the result
-    std::string *t3 = Tac::newRegister();
+    Operand *t3 = Tac::newRegister();
 
     //  Get variable and shift amount calculation code
-    calculate_variable_address = this->getChild(0)->getCode();
-    calculate_shift_amount = this->getChild(1)->getCode();
+    calculate_variable_address = this->getChild(0)->takeCode();
+    calculate_shift_amount = this->getChild(1)->takeCode();
 
     // Generate code for shift operation
     load_actual_value = new Tac(ILOC_LOAD, t1, t3); // load   t1     => t3
     shift_instruction = new Tac(op, t3, t2, t3);    // shift  t3, t2 => t3
-    store_new_value = new Tac(ILOC_STORE, t3, t1);  // store  t3     => t1
 
     // Link code together
-    calculate_variable_address->addLast(calculate_shift_amount);
-    calculate_shift_amount->addLast(load_actual_value);
-    load_actual_value->addLast(shift_instruction);
-    shift_instruction->addLast(store_new_value);
+    calculate_variable_address.concatenate(calculate_shift_amount);
+    calculate_variable_address.append(load_actual_value);
+    calculate_variable_address.append(shift_instruction);
+
+    // A variable's address is calculated again, right before the store, like any other attribution
+    // (Vector addresses are kept in t1 instead, so the index is only evaluated once)
+    if (this->getChild(0)->getKind() == ST_OPERAND)
+    {
+        calculate_variable_address.concatenate(this->getChild(0)->generateLvalVariableTAC());
+        t1 = this->getChild(0)->getTemp();
+    }
+
+    store_new_value = new Tac(ILOC_STORE, t3, t1); // store  t3     => t1
+    calculate_variable_address.append(store_new_value);
 
     // Return first instruction in the generated code block
     return calculate_variable_address;
 }
 
-Tac *Node::generateFunctionDeclarationTAC()
+TacList Node::generateFunctionDeclarationTAC()
 {
     // Instructions
     Tac *update_rfp_call = NULL; // rfp <- rsp
     Tac *update_rsp_vars = NULL; // rsp <- rsp + (local_vars(N))
-    Tac *function_body = NULL;   // ... function code ...
+    TacList function_body;       // ... function code ...
+    TacList code;                // All of the function's code, in order
 
     // Load as many passed arguments as necessary
     Tac *load_param_i = NULL; // ti <- Mem(rfp + param_address)
     Tac *save_param_i = NULL; // Mem(rfp + var_addr) <- ti
+    TacList load_params;      // Code for loading every parameter
 
     // Temporary registers
-    std::string *ti = Tac::newRegister(); // For loading parameters into their respective local vars
-
-    // Labels
-    std::string *l1 = Tac::newLabel(); // Label given to function starting point
+    Operand *ti = NULL; // For loading parameters into their respective local vars (One each, so they can be kept)
 
     // Get current active symbol table
     SymbolTable *current_st = Manager::getActiveSymbolTable();
@@ -1439,6 +1701,10 @@ Tac *Node::generateFunctionDeclarationTAC()
     // Get function symbol
     Symbol *function = Manager::getSymbol(this->lexval);
 
+    // Labels
+    Operand *l1 = function->getLabel();     // Label given to function starting point (When it was declared)
+    Operand *l2 = function->getBodyLabel(); // Label given to the body, if it calls itself in tail position
+
     //
 
     // Calculate amount of space occupied by function parameters
@@ -1451,17 +1717,17 @@ Tac *Node::generateFunctionDeclarationTAC()
     int local_vars_occupied_size = current_st->getAddress();
 
     // Names
-    std::string *rfp = Tac::getName("rfp");
-    std::string *rsp = Tac::getName("rsp");
-    std::string *local_offset = Tac::getName(std::to_string(local_vars_occupied_size));
-    std::string *param_load_address = NULL;
-    std::string *param_store_address = NULL;
+    Operand *rfp = Operand::getBase(BASE_RFP);
+    Operand *rsp = Operand::getBase(BASE_RSP);
+    Operand *local_offset = Tac::getImmediate(local_vars_occupied_size);
+    Operand *param_load_address = NULL;
+    Operand *param_store_address = NULL;
 
     //
 
     // Get code for the function start (If exists)
     if (this->getChild(0) != NULL)
-        function_body = this->getChild(0)->getCode();
+        function_body = this->getChild(0)->takeCode();
 
     // Generate code
     update_rfp_call = new Tac(ILOC_I2I, rsp, rfp);                // i2i  rsp               => rfp
@@ -1473,25 +1739,36 @@ Tac *Node::generateFunctionDeclarationTAC()
     for (uint i = 0; i < function->getParams().size(); ++i, param_load_offset += getSize(TYPE_INT), param_store_offset += getSize(TYPE_INT))
     {
         // Get param address name
-        param_load_address = Tac::getName(std::to_string(param_load_offset));
-        param_store_address = Tac::getName(std::to_string(param_store_offset));
+        param_load_address = Tac::getImmediate(param_load_offset);
+        param_store_address = Tac::getImmediate(param_store_offset);
 
         // Generate code for loading parameter i
+        ti = Tac::newRegister();
         load_param_i = new Tac(ILOC_LOADAI, rfp, param_load_address, ti);   // loadAI rfp, param_load_offset=> ti
         save_param_i = new Tac(ILOC_STOREAI, ti, rfp, param_store_address); // storeAI ti => rfp, param_store_offset
 
         // Link code together
-        load_param_i->addLast(save_param_i);
-        update_rsp_vars->addLast(load_param_i);
+        load_params.append(load_param_i);
+        load_params.append(save_param_i);
     }
 
     // Link code together
-    update_rfp_call->addLast(update_rsp_vars);
-    update_rsp_vars->addLast(function_body);
+    code.append(update_rfp_call);
+    code.append(update_rsp_vars);
+    code.concatenate(load_params);
+
+    // Tail calls to itself start over from here, with the parameters reassigned
+    if (l2 != NULL)
+    {
+        Tac *nop = new Tac(ILOC_NOP); // l2: nop
+        nop->setLabel(l2);
+        code.append(nop);
+    }
 
-    // Label code and function symbol
+    code.concatenate(function_body);
+
+    // Label code
     update_rfp_call->setLabel(l1);
-    function->giveLabel(l1);
 
     // If this is the 'main' function
     if (!strcmp(this->getValue()->getName(), "main"))
@@ -1515,21 +1792,22 @@ Tac *Node::generateFunctionDeclarationTAC()
     Tac *update_rsp = NULL;         // rsp <- t2
     Tac *update_rfp = NULL;         // rfp <- t3
     Tac *jump_return = NULL;        // jump t1
+    TacList return_code;            // All of the above, in order
 
     // Temporary registers
-    std::string *t1 = Tac::newRegister(); // Return value
-    std::string *t2 = Tac::newRegister(); // Return address
-    std::string *t3 = Tac::newRegister(); // Old rsp
-    std::string *t4 = Tac::newRegister(); // Old rfp
+    Operand *t1 = Tac::newRegister(); // Return value
+    Operand *t2 = Tac::newRegister(); // Return address
+    Operand *t3 = Tac::newRegister(); // Old rsp
+    Operand *t4 = Tac::newRegister(); // Old rfp
 
     // Calculate size occupied by function parameters in frame
     int return_offset = 3 * getSize(TYPE_INT) + function->getParams().size() * getSize(TYPE_INT);
 
     // Names
-    std::string *offset_return = Tac::getName(std::to_string(return_offset));
-    std::string *const_0 = Tac::getName(std::to_string(0));
-    std::string *const_4 = Tac::getName(std::to_string(4));
-    std::string *const_8 = Tac::getName(std::to_string(8));
+    Operand *offset_return = Tac::getImmediate(return_offset);
+    Operand *const_0 = Tac::getImmediate(0);
+    Operand *const_4 = Tac::getImmediate(4);
+    Operand *const_8 = Tac::getImmediate(8);
 
     // Generate code for the return statement
     load_result = new Tac(ILOC_LOADI, const_0, t1);              // loadI   0      => t1
@@ -1542,24 +1820,23 @@ Tac *Node::generateFunctionDeclarationTAC()
     jump_return = new Tac(ILOC_JUMP, t2);                        // jump           => t2
 
     // Link code together
-    load_result->addLast(save_return);
-    save_return->addLast(get_return_address);
-    get_return_address->addLast(get_old_rsp);
-    get_old_rsp->addLast(get_old_rfp);
-    get_old_rfp->addLast(update_rsp);
-    update_rsp->addLast(update_rfp);
-    update_rfp->addLast(jump_return);
-
-    load_result->setReturn();
+    return_code.append(load_result);
+    return_code.append(save_return);
+    return_code.append(get_return_address);
+    return_code.append(get_old_rsp);
+    return_code.append(get_old_rfp);
+    return_code.append(update_rsp);
+    return_code.append(update_rfp);
+    return_code.append(jump_return);
 
     // Add 'fake' return at the end of function
-    update_rsp_vars->addLast(load_result);
+    code.concatenate(return_code);
 
-    // Return first instruction in the generated code block
-    return update_rfp_call;
+    // Return the generated code block
+    return code;
 }
 
-Tac *Node::generateFunctionCallTAC()
+TacList Node::generateFunctionCallTAC()
 {
     // Instructions
     Tac *calc_return_address = NULL; // t1 <- rpc + (3 + param_count + 2)
@@ -1568,39 +1845,42 @@ Tac *Node::generateFunctionCallTAC()
     Tac *save_current_rfp = NULL;    // Mem (rsp + 8) <- rfp
     Tac *jump_function = NULL;       // jumpI => func_label
     Tac *get_return_val = NULL;      // t1 <- Mem(rsp + offset_return)
+    TacList code;                    // All of the above, in order
 
     // Load as many parameters as necessary
-    Tac *code_param_i = NULL; // t2 <- ... calculate param expression ...
+    TacList code_param_i;     // t2 <- ... calculate param expression ...
     Tac *save_param_i = NULL; // Mem(rsp + param_offset) <- t2
+    TacList calc_params;      // Code for calculating every parameter
+    TacList pass_params;      // Code for passing every parameter
 
     // Get function symbol
     Symbol *called_func = Manager::getSymbol(this->getValue());
     Node *aux = NULL; // Auxiliary pointer for traversing arguments
 
     // Get function label
-    std::string *l1 = called_func->getLabel();
+    Operand *l1 = called_func->getLabel();
 
     // Temporary registers
-    std::string *t1 = Tac::newRegister(); // Return value
-    std::string *t2 = NULL;               // Parameter copying
+    Operand *t1 = Tac::newRegister(); // Return value
+    Operand *t2 = NULL;               // Parameter copying
 
     // Calculate size occupied by return data + params in function frame
     int offset_return_val = 3 * getSize(TYPE_INT) + called_func->getParams().size() * getSize(TYPE_INT);
 
     // Calculate return address offset
-    int offset_return_addr = 5; // Considering 0 parameters, 5 instructions are still needed
+    int offset_return_addr = 5 + called_func->getParams().size(); // One more instruction for each parameter
 
     // Parameter offset
     int param_offset = 3 * getSize(TYPE_INT); // Starts 3 values after rsp
 
     // Names
-    std::string *rfp = Tac::getName("rfp");
-    std::string *rsp = Tac::getName("rsp");
-    std::string *rpc = Tac::getName("rpc");
-    std::string *const_0 = Tac::getName(std::to_string(0));
-    std::string *const_4 = Tac::getName(std::to_string(4));
-    std::string *const_8 = Tac::getName(std::to_string(8));
-    std::string *offset_param = NULL;
+    Operand *rfp = Operand::getBase(BASE_RFP);
+    Operand *rsp = Operand::getBase(BASE_RSP);
+    Operand *rpc = Operand::getBase(BASE_RPC);
+    Operand *const_0 = Tac::getImmediate(0);
+    Operand *const_4 = Tac::getImmediate(4);
+    Operand *const_8 = Tac::getImmediate(8);
+    Operand *offset_param = NULL;
 
     //
 
@@ -1616,24 +1896,21 @@ Tac *Node::generateFunctionCallTAC()
         t2 = aux->getTemp();
 
         // Get code for argument
-        code_param_i = aux->getCode();
+        code_param_i = aux->takeValueCode();
 
         // Get name for offset
-        offset_param = Tac::getName(std::to_string(param_offset));
+        offset_param = Tac::getImmediate(param_offset);
 
         // Generate code for 'stacking' value of parameter in the called function's frame
         save_param_i = new Tac(ILOC_STOREAI, t2, rsp, offset_param); // storeAI t2 => rsp, param_offset
 
         // Link to the instructions
-        save_current_rfp->addLast(code_param_i);
-        save_current_rfp->addLast(save_param_i);
-
-        // Increment the return address offset by the size of the new code
-        offset_return_addr += code_param_i->getCodeSize();
+        calc_params.concatenate(code_param_i);
+        pass_params.prepend(save_param_i); // Last argument first, the ones passed in registers are stacked right before the call
     }
 
-    std::string *offset_retval = Tac::getName(std::to_string(offset_return_val));
-    std::string *offset_retaddr = Tac::getName(std::to_string(offset_return_addr));
+    Operand *offset_retval = Tac::getImmediate(offset_return_val);
+    Operand *offset_retaddr = Tac::getImmediate(offset_return_addr);
 
     // Calculate the return address
     calc_return_address = new Tac(ILOC_ADDI, rpc, offset_retaddr, t1); // addI    rpc, offset_return_addr => t1
@@ -1643,12 +1920,15 @@ Tac *Node::generateFunctionCallTAC()
     jump_function = new Tac(ILOC_JUMPI, l1);                       // jumpI                           => l1
     get_return_val = new Tac(ILOC_LOADAI, rsp, offset_retval, t1); // loadAI  rsp, offset_return_val  => t1
 
-    // Link code together
-    calc_return_address->addLast(save_return_address);
-    save_return_address->addLast(save_current_rsp);
-    save_current_rsp->addLast(save_current_rfp);
-    save_current_rfp->addLast(jump_function);
-    jump_function->addLast(get_return_val);
+    // Link code together (Every argument is calculated before the frame is written, they may call functions too)
+    code.concatenate(calc_params);
+    code.append(calc_return_address);
+    code.append(save_return_address);
+    code.append(save_current_rsp);
+    code.append(save_current_rfp);
+    code.concatenate(pass_params);
+    code.append(jump_function);
+    code.append(get_return_val);
 
     // Set this node's temp
     this->setTemp(t1);
@@ -1656,14 +1936,96 @@ Tac *Node::generateFunctionCallTAC()
     // Set this node as having a value ( The one returned by the function)
     this->setValue();
 
-    // Return first instruction in the generated code block
-    return calc_return_address;
+    // Return the generated code block
+    return code;
+}
+
+TacList Node::generateTailCallTAC()
+{
+    // Instructions
+    TacList code;              // ... calculate the arguments ...
+    TacList pass_params;       // Code for passing every argument, once all of them were calculated
+    Tac *save_param_i = NULL;  // Mem(rfp + param_offset) <- t2
+    Tac *free_frame = NULL;    // rsp <- rfp
+    Tac *jump_function = NULL; // jumpI => func_label (Or the body of this function)
+
+    // Get function symbols
+    Node *call = this->getChild(0);
+    Symbol *current_func = Manager::getCurrentFunction();
+    Symbol *called_func = Manager::getSymbol(call->getValue());
+    Node *aux = NULL; // Auxiliary pointer for traversing arguments
+
+    // Temporary registers
+    Operand *t1 = NULL; // Address of a parameter, when calling itself
+    Operand *t2 = NULL; // Parameter copying
+
+    // Where the caller placed the arguments, and where this function copied them to (Its parameter variables)
+    int param_offset = 3 * getSize(TYPE_INT);
+    int param_store_offset = 3 * getSize(TYPE_INT) + current_func->getParams().size() * getSize(TYPE_INT) + getSize(TYPE_INT);
+
+    // Names
+    Operand *rfp = Operand::getBase(BASE_RFP);
+    Operand *rsp = Operand::getBase(BASE_RSP);
+
+    //
+
+    // Get code for the call, the arguments are calculated just the same
+    code = call->takeCode();
+
+    // Without saving the return address, rsp and rfp, stacking the arguments nor reading the value returned
+    for (uint i = 0; i < called_func->getParams().size() + 6; ++i)
+        code.remove(code.getLast());
+
+    // Pass each argument after all of them are calculated, as they may read the parameters being replaced
+    aux = call->getChild(0);
+    for (uint i = 0; i < called_func->getParams().size(); ++i, param_offset += getSize(TYPE_INT), param_store_offset += getSize(TYPE_INT), aux = aux->getNextElement())
+    {
+        t2 = aux->getTemp();
+
+        if (called_func == current_func)
+        {
+            // Assign the parameter variable
+            t1 = Tac::newRegister();
+            pass_params.append(new Tac(ILOC_ADDI, rfp, Tac::getImmediate(param_store_offset), t1)); // addI rfp, param_store_offset => t1
+            save_param_i = new Tac(ILOC_STORE, t2, t1);                                             // store t2 => t1
+        }
+        else
+        {
+            // Replace the argument this function was called with
+            save_param_i = new Tac(ILOC_STOREAI, t2, rfp, Tac::getImmediate(param_offset)); // storeAI t2 => rfp, param_offset
+        }
+
+        pass_params.append(save_param_i);
+    }
+
+    if (called_func == current_func)
+    {
+        // Start the body over
+        if (current_func->getBodyLabel() == NULL)
+            current_func->giveBodyLabel(Tac::newLabel());
+
+        jump_function = new Tac(ILOC_JUMPI, current_func->getBodyLabel()); // jumpI => body_label
+    }
+    else
+    {
+        // The called function's frame takes the place of this one, it returns straight to this function's caller
+        free_frame = new Tac(ILOC_I2I, rfp, rsp);                     // i2i   rfp => rsp
+        jump_function = new Tac(ILOC_JUMPI, called_func->getLabel()); // jumpI     => func_label
+        pass_params.append(free_frame);
+    }
+
+    // Link code together
+    code.concatenate(pass_params);
+    code.append(jump_function);
+
+    // Return the generated code block
+    return code;
 }
 
-Tac *Node::generateReturnTAC()
+TacList Node::generateReturnTAC()
 {
     // Instructions
-    Tac *load_result = NULL;        // t0 <- return_expression
+    TacList load_result;            // t0 <- return_expression
     Tac *save_return = NULL;        // Mem(rfp + offset_return) <- t0
     Tac *get_return_address = NULL; // t1 <- Mem(rfp + 0)
     Tac *get_old_rsp = NULL;        // t2 <- Mem(rfp + 4)
@@ -1675,25 +2037,30 @@ Tac *Node::generateReturnTAC()
     // Get current function symbol
     Symbol *current_func = Manager::getCurrentFunction();
 
+    // A call to a function that returns its value where this one's caller reads it needs no frame of its own
+    if (this->getChild(0)->getKind() == ST_FUNCTION_CALL &&
+        Manager::getSymbol(this->getChild(0)->getValue())->getParams().size() == current_func->getParams().size())
+        return this->generateTailCallTAC();
+
     // Temporary registers
-    std::string *t1 = this->getChild(0)->getTemp(); // Return value
-    std::string *t2 = Tac::newRegister();           // Return address
-    std::string *t3 = Tac::newRegister();           // Old rsp
-    std::string *t4 = Tac::newRegister();           // Old rfp
+    Operand *t1 = this->getChild(0)->getTemp(); // Return value
+    Operand *t2 = Tac::newRegister();           // Return address
+    Operand *t3 = Tac::newRegister();           // Old rsp
+    Operand *t4 = Tac::newRegister();           // Old rfp
 
     // Calculate size occupied by function parameters in frame
     int return_offset = 3 * getSize(TYPE_INT) + current_func->getParams().size() * getSize(TYPE_INT);
 
     // Names
-    std::string *rfp = Tac::getName("rfp");
-    std::string *rsp = Tac::getName("rsp");
-    std::string *offset_return = Tac::getName(std::to_string(return_offset));
-    std::string *const_0 = Tac::getName(std::to_string(0));
-    std::string *const_4 = Tac::getName(std::to_string(4));
-    std::string *const_8 = Tac::getName(std::to_string(8));
+    Operand *rfp = Operand::getBase(BASE_RFP);
+    Operand *rsp = Operand::getBase(BASE_RSP);
+    Operand *offset_return = Tac::getImmediate(return_offset);
+    Operand *const_0 = Tac::getImmediate(0);
+    Operand *const_4 = Tac::getImmediate(4);
+    Operand *const_8 = Tac::getImmediate(8);
 
     // Get code from child expression
-    load_result = this->getChild(0)->getCode(); // t1 <- ... expression ...
+    load_result = this->getChild(0)->takeValueCode(); // t1 <- ... expression ...
 
     // Generate code for the return statement
     save_return = new Tac(ILOC_STOREAI, t1, rfp, offset_return); // storeAI t1     => rfp, offset_return
@@ -1705,15 +2072,13 @@ Tac *Node::generateReturnTAC()
     jump_return = new Tac(ILOC_JUMP, t2);                        // jump           => t2
 
     // Link code together
-    load_result->addLast(save_return);
-    save_return->addLast(get_return_address);
-    get_return_address->addLast(get_old_rsp);
-    get_old_rsp->addLast(get_old_rfp);
-    get_old_rfp->addLast(update_rsp);
-    update_rsp->addLast(update_rfp);
-    update_rfp->addLast(jump_return);
-
-    load_result->setReturn();
+    load_result.append(save_return);
+    load_result.append(get_return_address);
+    load_result.append(get_old_rsp);
+    load_result.append(get_old_rfp);
+    load_result.append(update_rsp);
+    load_result.append(update_rfp);
+    load_result.append(jump_return);
 
     // Return first instruction in the generated code block
     return load_result;
@@ -1739,33 +2104,36 @@ void Node::generateProgramStartTAC(int rsp_val, int rbss_val)
     // Return from main
     Tac *halt = NULL; // halt
 
+    TacList code;          // All of the above, in order
+    TacList load_literals; // Code for storing every literal in the data segment
+
     // Get main function symbol
     Symbol *main = Manager::getMain();
 
-    std::string *t1 = Tac::newRegister(); // Temp reg for return address
-    std::string *t2 = Tac::newRegister(); // Temp reg for loading literals
+    Operand *t1 = Tac::newRegister(); // Temp reg for return address
+    Operand *t2 = Tac::newRegister(); // Temp reg for loading literals
 
     // Get names for rbss and rsp initial values
-    std::string *rsp_start = Tac::getName(std::to_string(rsp_val));
-    std::string *rbss_start = Tac::getName(std::to_string(rbss_val));
+    Operand *rsp_start = Tac::getImmediate(rsp_val);
+    Operand *rbss_start = Tac::getImmediate(rbss_val);
 
     // Get names for registers
-    std::string *rfp = Tac::getName("rfp");
-    std::string *rsp = Tac::getName("rsp");
-    std::string *rbss = Tac::getName("rbss");
-    std::string *rpc = Tac::getName("rpc");
-    std::string *const_0 = Tac::getName(std::to_string(0));
-    std::string *const_4 = Tac::getName(std::to_string(4));
-    std::string *const_5 = Tac::getName(std::to_string(5));
-    std::string *const_8 = Tac::getName(std::to_string(8));
+    Operand *rfp = Operand::getBase(BASE_RFP);
+    Operand *rsp = Operand::getBase(BASE_RSP);
+    Operand *rbss = Operand::getBase(BASE_RBSS);
+    Operand *rpc = Operand::getBase(BASE_RPC);
+    Operand *const_0 = Tac::getImmediate(0);
+    Operand *const_4 = Tac::getImmediate(4);
+    Operand *const_5 = Tac::getImmediate(5);
+    Operand *const_8 = Tac::getImmediate(8);
 
     // Literal value address offset in the data segment
     int literal_address = -1;
-    std::string *lit_offset = NULL;
-    std::string *lit_value = NULL;
+    Operand *lit_offset = NULL;
+    Operand *lit_value = NULL;
 
     // Get main code label
-    std::string *label_main = main->getLabel();
+    Operand *label_main = main->getLabel();
 
     // Generate code
     start_rfp = new Tac(ILOC_LOADI, rsp_start, rsp);    // loadI rsp_start => rsp
@@ -1793,38 +2161,40 @@ void Node::generateProgramStartTAC(int rsp_val, int rbss_val)
         {
             // Get literal address and value
             literal_address = i->second->getAddress();
-            lit_value = Tac::getName(i->second->getName());
+            lit_value = Tac::getImmediate(i->second->getValue()->getInteger());
 
             // Generate a name for the literal address
-            lit_offset = Tac::getName(std::to_string(literal_address));
+            lit_offset = Tac::getImmediate(literal_address);
 
             // Generate code for storing this value in the data segment
             load_literal_i = new Tac(ILOC_LOADI, lit_value, t2);           // loadI   lit_val => t2
             store_literal_i = new Tac(ILOC_STOREAI, t2, rbss, lit_offset); // storeAI t2      => rbss , lit_offset
 
             // Link code together
-            start_rbss->addLast(load_literal_i);
-            load_literal_i->addLast(store_literal_i);
+            load_literals.append(load_literal_i);
+            load_literals.append(store_literal_i);
         }
     }
 
     // Link code together
-    start_rfp->addLast(start_rsp);
-    start_rsp->addLast(start_rbss);
-    start_rbss->addLast(calc_return_address);
+    code.append(start_rfp);
+    code.append(start_rsp);
+    code.append(start_rbss);
+    code.concatenate(load_literals);
 
-    calc_return_address->addLast(save_return_address);
-    save_return_address->addLast(save_current_rsp);
-    save_current_rsp->addLast(save_current_rfp);
-    save_current_rfp->addLast(jump_main);
+    code.append(calc_return_address);
+    code.append(save_return_address);
+    code.append(save_current_rsp);
+    code.append(save_current_rfp);
+    code.append(jump_main);
 
-    jump_main->addLast(halt);
+    code.append(halt);
 
     // Add this node's code after the driver code
-    halt->addLast(this->code);
+    code.concatenate(this->code);
 
     // Update this node's code to start at the driver code
-    this->code = start_rfp;
+    this->code = code;
 
     return;
 }
@@ -0,0 +1,121 @@
+#include "Operand.h"
+
+// Special registers, in the same order as the Base enum
+Operand Operand::bases[] = {
+    Operand(OPERAND_BASE, BASE_RFP),
+    Operand(OPERAND_BASE, BASE_RSP),
+    Operand(OPERAND_BASE, BASE_RBSS),
+    Operand(OPERAND_BASE, BASE_RPC),
+    Operand(OPERAND_BASE, BASE_CC)};
+
+Operand *Operand::getBase(Base base)
+{
+    return &Operand::bases[base];
+}
+
+//
+
+Operand::Operand(OperandKind kind_, int value_, int number_)
+{
+    this->kind = kind_;
+    this->value = value_;
+    this->number = number_;
+}
+
+Operand::~Operand()
+{
+    // nil
+}
+
+OperandKind Operand::getKind()
+{
+    return this->kind;
+}
+
+int Operand::getValue()
+{
+    return this->value;
+}
+
+bool Operand::isRegister()
+{
+    return this->kind == OPERAND_REGISTER;
+}
+
+bool Operand::isImmediate()
+{
+    return this->kind == OPERAND_IMMEDIATE;
+}
+
+bool Operand::isLabel()
+{
+    return this->kind == OPERAND_LABEL;
+}
+
+bool Operand::isBase(Base base)
+{
+    return this->kind == OPERAND_BASE && this->value == base;
+}
+
+void Operand::patch(Operand *label)
+{
+    this->kind = label->kind;
+    this->value = label->value;
+}
+
+std::string Operand::toString()
+{
+    std::string name;
+    Writer out(name);
+
+    this->write(out);
+
+    return name;
+}
+
+void Operand::write(Writer &out)
+{
+    switch (this->kind)
+    {
+    case OPERAND_REGISTER:
+        out << 'r' << this->number;
+        break;
+    case OPERAND_IMMEDIATE:
+        out << this->value;
+        break;
+    case OPERAND_LABEL:
+        out << 'L' << this->value;
+        break;
+    case OPERAND_HOLE:
+        out << 'H' << this->value;
+        break;
+    case OPERAND_BASE:
+    {
+        switch (this->value)
+        {
+        case BASE_RFP:
+            out << "rfp";
+            break;
+        case BASE_RSP:
+            out << "rsp";
+            break;
+        case BASE_RBSS:
+            out << "rbss";
+            break;
+        case BASE_RPC:
+            out << "rpc";
+            break;
+        case BASE_CC:
+            out << "cc";
+            break;
+        default: // Error
+            out << '?';
+            break;
+        }
+    }
+    break;
+    default: // Error
+        out << '?';
+        break;
+    }
+}
@@ -0,0 +1,88 @@
+#include "Optimizer.h"
+#include "Tac.h"
+
+bool Optimizer::output_stats = false;
+
+void Optimizer::setOutputStats(bool output_stats_)
+{
+    Optimizer::output_stats = output_stats_;
+}
+
+TacList Optimizer::optimizeFunction(Symbol *function, TacList code)
+{
+    // Calls to small functions are replaced with their code
+    Inliner inliner(function, code);
+
+    // Redundant computations in each block
+    ValueNumbering value_numbering(code);
+
+    // Uses of copies read the original value, leaving the copies dead
+    CopyPropagation copy_propagation(code, function->getArena()->getRegisterCount());
+
+    // Multiplications and divisions by constants become shifts, where they can
+    StrengthReduction strength_reduction(code);
+
+    // Computations that give the same result on every iteration of a loop run once before it
+    LoopInvariant loop_invariant(code, function->getArena()->getRegisterCount());
+
+    // Code that never runs, and results never used
+    int locals_start = 4 * getSize(TYPE_INT) + function->getParams().size() * getSize(TYPE_INT);
+    DeadCode dead_code(code, function->getArena()->getRegisterCount(), locals_start);
+
+    Optimizer::updateReturnAddresses(code);
+
+    // Functions declared after this one may inline it
+    Inliner::addFunction(function);
+
+    if (Optimizer::output_stats)
+    {
+        std::vector<std::string> log = inliner.getLog();
+
+        for (auto i = log.begin(); i != log.end(); ++i)
+            std::cerr << "inliner " << function->getName() << ": " << *i << std::endl;
+
+        std::cerr << "optimizer " << function->getName() << ": inliner inlined " << inliner.getInlinedCount()
+                  << ", lvn removed " << value_numbering.getRemovedCount()
+                  << ", copy propagation rewrote " << copy_propagation.getRewrittenCount()
+                  << ", strength reduction reduced " << strength_reduction.getReducedCount()
+                  << ", licm hoisted " << loop_invariant.getHoistedCount()
+                  << ", dce removed " << dead_code.getRemovedCount() << " (" << dead_code.getStats() << ")" << std::endl;
+    }
+
+    return code;
+}
+
+void Optimizer::updateReturnAddresses(TacList &code)
+{
+    std::unordered_set<int> labels; // Labels in the function, other than its own
+    Tac *end = code.getLast()->getNext();
+
+    for (Tac *i = code.getFirst()->getNext(); i != end; i = i->getNext())
+        if (i->getLabel() != NULL)
+            labels.insert(i->getLabel()->getValue());
+
+    for (Tac *i = code.getFirst(); i != end; i = i->getNext())
+    {
+        if (i->getOpcode() != ILOC_ADDI || !i->getArgument(0)->isBase(BASE_RPC))
+            continue;
+
+        int pending = 1; // Calls not reached yet, the arguments may call functions too
+        int offset = 0;
+        Tac *call = i;
+
+        while (pending > 0 && call->getNext() != end)
+        {
+            call = call->getNext();
+            offset++;
+
+            if (call->getOpcode() == ILOC_ADDI && call->getArgument(0)->isBase(BASE_RPC))
+                pending++;
+            else if (call->getOpcode() == ILOC_JUMPI && !labels.count(call->getArgument(0)->getValue()))
+                pending--;
+        }
+
+        // Return right after the call
+        if (pending == 0 && offset + 1 != i->getArgument(1)->getValue())
+            i->rewrite(ILOC_ADDI, i->getArgument(0), Tac::getImmediate(offset + 1), i->getArgument(2));
+    }
+}
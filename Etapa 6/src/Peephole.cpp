@@ -0,0 +1,274 @@
+#include "Peephole.h"
+
+// Names of the rules, for the statistics
+static const char *rule_names[PEEPHOLE_RULE_COUNT] = {
+    "redundant moves",
+    "forwarded loads",
+    "accumulator moves",
+    "zero idioms",
+    "leas",
+    "useless arithmetic",
+    "jumps to next",
+    "unreachable",
+    "nops",
+    "labels"};
+
+// Conditional jumps, and the ones taken in the opposite case
+static const std::unordered_map<std::string, std::string> inverse_jumps = {
+    {"je", "jne"},
+    {"jne", "je"},
+    {"jl", "jge"},
+    {"jge", "jl"},
+    {"jle", "jg"},
+    {"jg", "jle"}};
+
+Peephole::Peephole()
+{
+    this->hits.assign(PEEPHOLE_RULE_COUNT, 0);
+}
+
+Peephole::~Peephole()
+{
+    // nil
+}
+
+int Peephole::getHits(PeepholeRule rule)
+{
+    return this->hits[rule];
+}
+
+std::string Peephole::getStats()
+{
+    std::stringstream stats;
+
+    for (int rule = 0; rule < PEEPHOLE_RULE_COUNT; ++rule)
+        stats << (rule == 0 ? "" : ", ") << rule_names[rule] << " " << this->hits[rule];
+
+    return stats.str();
+}
+
+bool Peephole::hit(PeepholeRule rule)
+{
+    this->hits[rule]++;
+
+    return true;
+}
+
+Peephole::Position Peephole::getNextOperation(std::list<Instruction> &code, Position position)
+{
+    for (Position i = std::next(position); i != code.end(); ++i)
+    {
+        if (i->isOperation())
+            return i;
+
+        if (i->isLabel())
+            break;
+    }
+
+    return code.end();
+}
+
+bool Peephole::isFollowedBy(std::list<Instruction> &code, Position position, std::string label)
+{
+    for (Position i = std::next(position); i != code.end() && !i->isOperation(); ++i)
+        if (i->isLabel() && i->getText() == label)
+            return true;
+
+    return false;
+}
+
+bool Peephole::areFlagsLive(std::list<Instruction> &code, Position position)
+{
+    for (Position i = std::next(position); i != code.end(); ++i)
+    {
+        if (i->isComment())
+            continue;
+
+        // Read here, or maybe wherever the code goes next
+        if (i->isLabel() || i->readsFlags() || i->isOperation("jmp"))
+            return true;
+
+        // Overwritten (Calls and returns do not keep them either)
+        if (i->writesFlags() || i->isOperation("call") || i->isOperation("ret"))
+            return false;
+    }
+
+    return false;
+}
+
+bool Peephole::rewrite(std::list<Instruction> &code, Position &position)
+{
+    Position i = position;
+    Position j = this->getNextOperation(code, i);
+    Position k = j != code.end() ? this->getNextOperation(code, j) : code.end();
+    std::string opcode = i->getText();
+
+    // nop
+    if (opcode == "nop")
+    {
+        position = code.erase(i);
+        return this->hit(PEEPHOLE_NOP);
+    }
+
+    if (opcode == "movq" || opcode == "movl")
+    {
+        // movq a, a (A movl would still clear the upper half of the register)
+        if (opcode == "movq" && i->getOperand(0) == i->getOperand(1))
+        {
+            position = code.erase(i);
+            return this->hit(PEEPHOLE_REDUNDANT_MOVE);
+        }
+
+        if (j != code.end() && j->isOperation(opcode) && j->getOperand(0) == i->getOperand(1))
+        {
+            // mov a, b; mov b, a (Same caveat for movl into a register)
+            if (j->getOperand(1) == i->getOperand(0) && (opcode == "movq" || i->isMemory(0)))
+            {
+                code.erase(j);
+                return this->hit(PEEPHOLE_REDUNDANT_MOVE);
+            }
+
+            // mov a, mem; mov mem, b
+            if (i->isRegister(0) && i->isMemory(1))
+            {
+                j->setOperand(0, i->getOperand(0));
+                return this->hit(PEEPHOLE_FORWARDED_LOAD);
+            }
+        }
+
+        // mov $0, r
+        if (i->isImmediate(0) && i->getOperand(0) == "$0" && i->isRegister(1) && !this->areFlagsLive(code, i))
+        {
+            std::string low = Instruction::getLowRegister(i->getOperand(1));
+
+            *i = Instruction("xorl", {low, low});
+            return this->hit(PEEPHOLE_ZERO_IDIOM);
+        }
+    }
+
+    if (opcode == "movq" && i->isRegister(1) && j != code.end() && j->getOperandCount() == 2 && j->getOperand(1) == i->getOperand(1))
+    {
+        std::string a = i->getOperand(0);
+        std::string b = j->getOperand(0);
+        std::string c = i->getOperand(1);
+
+        // movq a, %rax; op b, %rax; movq %rax, c
+        if (c == "%rax" && (j->isOperation("imulq") || j->isOperation("addq") || j->isOperation("subq")) &&
+            k != code.end() && k->isOperation("movq") && k->getOperand(0) == "%rax" && k->isRegister(1) && k->getOperand(1) != b)
+        {
+            i->setOperand(1, k->getOperand(1));
+            j->setOperand(1, k->getOperand(1));
+            code.erase(k);
+            return this->hit(PEEPHOLE_ACCUMULATOR);
+        }
+
+        // movq a, c; addq b, c (Or subq $b, c)
+        if (i->isRegister(0) && a != c && b != c && !this->areFlagsLive(code, j) &&
+            ((j->isOperation("addq") && (j->isRegister(0) || j->isImmediate(0))) || (j->isOperation("subq") && j->isImmediate(0))))
+        {
+            std::stringstream address;
+
+            if (j->isRegister(0))
+                address << "(" << a << "," << b << ")";
+            else
+                address << (j->isOperation("subq") ? -std::stoll(b.substr(1)) : std::stoll(b.substr(1))) << "(" << a << ")";
+
+            *i = Instruction("leaq", {address.str(), c});
+            code.erase(j);
+            return this->hit(PEEPHOLE_LEA);
+        }
+    }
+
+    // addq $0, r | subq $0, r | imulq $1, r
+    if (i->getOperandCount() == 2 && i->isImmediate(0) &&
+        (((opcode == "addq" || opcode == "subq") && i->getOperand(0) == "$0") || (opcode == "imulq" && i->getOperand(0) == "$1")) &&
+        !this->areFlagsLive(code, i))
+    {
+        position = code.erase(i);
+        return this->hit(PEEPHOLE_USELESS_ARITHMETIC);
+    }
+
+    // jmp L; L:
+    if (opcode == "jmp" && this->isFollowedBy(code, i, i->getOperand(0)))
+    {
+        position = code.erase(i);
+        return this->hit(PEEPHOLE_JUMP_TO_NEXT);
+    }
+
+    // jcc L1; jmp L2; L1:
+    if (inverse_jumps.count(opcode) && j != code.end() && j->isOperation("jmp") && this->isFollowedBy(code, j, i->getOperand(0)))
+    {
+        *i = Instruction(inverse_jumps.at(opcode), {j->getOperand(0)});
+        code.erase(j);
+        return this->hit(PEEPHOLE_JUMP_TO_NEXT);
+    }
+
+    // jmp L | ret, followed by code nothing jumps to
+    if ((opcode == "jmp" || opcode == "ret") && j != code.end())
+    {
+        code.erase(j);
+        return this->hit(PEEPHOLE_UNREACHABLE);
+    }
+
+    return false;
+}
+
+bool Peephole::foldLabels(std::list<Instruction> &code)
+{
+    std::unordered_set<std::string> targets;              // Labels jumped to
+    std::unordered_map<std::string, std::string> renames; // Labels removed, and the one jumps go to instead
+    Position last_label = code.end();                     // Label right before the current position
+    bool changed = false;
+
+    for (Position i = code.begin(); i != code.end(); ++i)
+        if (i->isJump())
+            targets.insert(i->getOperand(0));
+
+    for (Position i = code.begin(); i != code.end();)
+    {
+        if (i->isLabel() && (!targets.count(i->getText()) || last_label != code.end()))
+        {
+            // Jumps to it go to the label before it, if any
+            if (last_label != code.end())
+                renames[i->getText()] = last_label->getText();
+
+            i = code.erase(i);
+            changed = this->hit(PEEPHOLE_LABEL);
+            continue;
+        }
+
+        // Labels are only adjacent if there are just comments between them
+        if (i->isLabel())
+            last_label = i;
+        else if (i->isOperation())
+            last_label = code.end();
+
+        ++i;
+    }
+
+    // Retarget the jumps to the labels removed
+    for (Position i = code.begin(); !renames.empty() && i != code.end(); ++i)
+        if (i->isJump() && renames.count(i->getOperand(0)))
+            i->setOperand(0, renames[i->getOperand(0)]);
+
+    return changed;
+}
+
+void Peephole::optimize(std::list<Instruction> &code)
+{
+    bool changed = true;
+
+    while (changed)
+    {
+        changed = this->foldLabels(code);
+
+        for (Position i = code.begin(); i != code.end();)
+        {
+            // Look at the same position again after a rewrite, something else may apply
+            if (i->isOperation() && this->rewrite(code, i))
+                changed = true;
+            else
+                ++i;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#include "StrengthReduction.h"
+#include "Tac.h"
+
+StrengthReduction::StrengthReduction(TacList &code_)
+{
+    this->code = &code_;
+    this->reduced = 0;
+
+    Tac *end = code_.getLast()->getNext();
+
+    for (Tac *i = code_.getFirst(); i != end; i = i->getNext())
+    {
+        if (i->getOpcode() == ILOC_MULTI && this->reduceMultiplication(i))
+            this->reduced++;
+        else if (i->getOpcode() == ILOC_DIVI && this->reduceDivision(i))
+            this->reduced++;
+    }
+}
+
+StrengthReduction::~StrengthReduction()
+{
+    // nil
+}
+
+int StrengthReduction::getReducedCount()
+{
+    return this->reduced;
+}
+
+int StrengthReduction::getPowerOfTwo(int value)
+{
+    int power = -1;
+
+    if (value > 1 && (value & (value - 1)) == 0)
+        for (power = 0; value > 1; value >>= 1)
+            power++;
+
+    return power;
+}
+
+bool StrengthReduction::reduceMultiplication(Tac *instruction)
+{
+    Operand *source = instruction->getArgument(0);
+    Operand *target = instruction->getArgument(2);
+    int value = instruction->getArgument(1)->getValue();
+    int power = StrengthReduction::getPowerOfTwo(value);
+
+    if (value == 0)
+        instruction->rewrite(ILOC_LOADI, Tac::getImmediate(0), target);
+    else if (value == 1)
+        instruction->rewrite(ILOC_I2I, source, target);
+    else if (value == -1)
+        instruction->rewrite(ILOC_RSUBI, source, Tac::getImmediate(0), target);
+    else if (power > 0)
+        instruction->rewrite(ILOC_LSHIFTI, source, Tac::getImmediate(power), target);
+    else
+        return false;
+
+    return true;
+}
+
+bool StrengthReduction::reduceDivision(Tac *instruction)
+{
+    Operand *source = instruction->getArgument(0);
+    Operand *target = instruction->getArgument(2);
+    int value = instruction->getArgument(1)->getValue();
+    int power = StrengthReduction::getPowerOfTwo(value);
+
+    if (value == 1)
+        instruction->rewrite(ILOC_I2I, source, target);
+    else if (value == -1)
+        instruction->rewrite(ILOC_RSUBI, source, Tac::getImmediate(0), target);
+    else if (power > 0)
+    {
+        Operand *t1 = Tac::newRegister();
+        Operand *t2 = Tac::newRegister();
+        Operand *t3 = Tac::newRegister();
+
+        Tac *sign = new Tac(ILOC_RSHIFTI, source, Tac::getImmediate(31), t1);       // rshiftI r1, 31 => t1
+        Tac *bias = new Tac(ILOC_ANDI, t1, Tac::getImmediate((1 << power) - 1), t2); // andI t1, 2^k-1 => t2
+        Tac *biased = new Tac(ILOC_ADD, source, t2, t3);                            // add r1, t2 => t3
+
+        this->code->insertBefore(instruction, sign);
+        this->code->insertBefore(instruction, bias);
+        this->code->insertBefore(instruction, biased);
+
+        // Jumps to the division go to the start of its replacement
+        sign->setLabel(instruction->getLabel());
+        instruction->setLabel(NULL);
+
+        instruction->rewrite(ILOC_RSHIFTI, t3, Tac::getImmediate(power), target); // rshiftI t3, k => r3
+    }
+    else
+        return false;
+
+    return true;
+}
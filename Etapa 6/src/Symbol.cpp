@@ -13,6 +13,9 @@ Symbol::Symbol(Token *data_, Nature nature_, Type type_, int count_, bool global
     this->size = count_ * getSize(type_);
     this->address = -1;
     this->global = global_;
+    this->label = NULL;
+    this->body_label = NULL;
+    this->arena = NULL;
 }
 
 Symbol::Symbol(Symbol &symbol)
@@ -26,6 +29,10 @@ Symbol::Symbol(Symbol &symbol)
     this->declare_line = symbol.declare_line;
     this->size = symbol.size;
     this->address = symbol.address;
+    this->label = symbol.label;
+    this->body_label = symbol.body_label;
+    this->arena = symbol.arena;
+    this->code = symbol.code;
 }
 
 Symbol::~Symbol()
@@ -148,11 +155,26 @@ bool Symbol::updateSize(int count)
     return status;
 }
 
-void Symbol::giveLabel(std::string *label)
+void Symbol::giveLabel(Operand *label)
 {
     this->label = label;
 }
 
+void Symbol::giveBodyLabel(Operand *body_label)
+{
+    this->body_label = body_label;
+}
+
+void Symbol::giveArena(TacArena *arena)
+{
+    this->arena = arena;
+}
+
+void Symbol::giveCode(TacList code)
+{
+    this->code = code;
+}
+
 // GETTERS
 
 Category Symbol::getCategory()
@@ -200,11 +222,26 @@ bool Symbol::isGlobal()
     return this->global;
 }
 
-std::string *Symbol::getLabel()
+Operand *Symbol::getLabel()
 {
     return this->label;
 }
 
+Operand *Symbol::getBodyLabel()
+{
+    return this->body_label;
+}
+
+TacArena *Symbol::getArena()
+{
+    return this->arena;
+}
+
+TacList Symbol::getCode()
+{
+    return this->code;
+}
+
 Token *Symbol::getValue()
 {
     return this->data;
@@ -4,85 +4,69 @@
 uint Tac::register_count = 0;
 uint Tac::label_count = 0;
 uint Tac::hole_count = 0;
-std::list<std::string *> Tac::used_names;
 
-std::string *Tac::newRegister()
+Operand *Tac::newRegister()
 {
-    // Create new name
-    std::string *new_register = new std::string("r" + std::to_string(Tac::register_count));
+    // Create new register in the current function's arena (Numbered globally, so no two functions share names)
+    Operand *new_register = TacArena::getActive()->newRegister(Tac::register_count);
 
     // Update counter
     Tac::register_count++;
 
-    // Add to list
-    Tac::used_names.push_back(new_register);
-
     return new_register;
 }
 
-std::string *Tac::newLabel()
+Operand *Tac::newLabel()
 {
-    std::string *new_label = new std::string("L" + std::to_string(Tac::label_count));
+    // Labels can be referenced from other functions, keep them in the global arena
+    Operand *new_label = TacArena::getGlobal()->newOperand(OPERAND_LABEL, Tac::label_count);
 
     // Update counter
     Tac::label_count++;
 
-    // Add to list
-    Tac::used_names.push_back(new_label);
-
     return new_label;
 }
 
-std::string *Tac::newHole()
+Operand *Tac::newHole()
 {
-    std::string *new_hole = new std::string("H" + std::to_string(Tac::hole_count));
+    // Create new hole in the current function's arena (Holes are patched before leaving it)
+    Operand *new_hole = TacArena::getActive()->newOperand(OPERAND_HOLE, Tac::hole_count);
 
     // Update counter
     Tac::hole_count++;
 
-    // Add to list
-    Tac::used_names.push_back(new_hole);
-
     return new_hole;
 }
 
-std::string *Tac::getRegister(int global)
+Operand *Tac::getRegister(int global)
 {
-    std::string *reg = new std::string(global ? "rbss" : "rfp");
-
-    // Add to list
-    Tac::used_names.push_back(reg);
-
-    return reg;
+    return Operand::getBase(global ? BASE_RBSS : BASE_RFP);
 }
 
-std::string *Tac::getName(std::string literal)
+Operand *Tac::getImmediate(int value)
 {
-    std::string *new_literal = new std::string(literal);
-
-    // Add to list
-    used_names.push_back(new_literal);
-
-    return new_literal;
+    return TacArena::getActive()->getImmediate(value);
 }
 
-void Tac::patch(std::list<std::string *> holes, std::string *label)
+void Tac::patch(std::list<Operand *> holes, Operand *label)
 {
     for (auto i = holes.begin(); i != holes.end(); ++i)
-        **i = *label;
-
-    // TODO Here we can free the hole strings as they get patched, as each hole is unique
+        (*i)->patch(label);
 }
 
-void Tac::freeNames()
+//
+
+void *Tac::operator new(size_t size)
 {
-    for (auto i = Tac::used_names.begin(); i != Tac::used_names.end(); ++i)
-        delete *i;
+    return TacArena::getActive()->allocate();
 }
 
-//
+void Tac::operator delete(void *instruction)
+{
+    // nil
+}
 
-Tac::Tac(ILOCop opcode_, std::string *arg1_, std::string *arg2_, std::string *arg3_)
+Tac::Tac(ILOCop opcode_, Operand *arg1_, Operand *arg2_, Operand *arg3_)
 {
     this->opcode = opcode_;
     this->arg1 = arg1_;
@@ -92,13 +76,11 @@ Tac::Tac(ILOCop opcode_, std::string *arg1_, std::string *arg2_, std::string *ar
 
     this->next = NULL;
     this->prev = NULL;
-
-    this->starts_return = false;
 }
 
 Tac::Tac(Tac &tac)
 {
-    Tac *chain;
+    Tac *copy = this; // Last instruction copied so far
 
     this->opcode = tac.opcode;
     this->arg1 = tac.arg1;
@@ -107,60 +89,39 @@ Tac::Tac(Tac &tac)
     this->label = tac.label;
     this->next = NULL;
     this->prev = NULL;
-    this->starts_return = tac.starts_return;
 
-    // If there are more commands
-    if (tac.next != NULL)
+    // Copy the rest of the chain one instruction at a time
+    for (Tac *i = tac.next; i != NULL; i = i->next)
     {
-        // Copy them as well
-        chain = new Tac(*tac.next);
+        copy->next = new Tac(i->opcode, i->arg1, i->arg2, i->arg3);
+        copy->next->prev = copy;
+        copy = copy->next;
 
-        // Update chain
-        this->next = chain;
-        this->next->prev = this;
+        copy->label = i->label;
     }
 }
 
 Tac::~Tac()
 {
-    // Delete next instruction, if there is one
-    if (this->next != NULL)
-        delete this->next;
+    // nil (Instructions are freed along with their arena)
 }
 
-std::string Tac::getCodeString()
+void Tac::writeCode(Writer &out)
 {
-    std::stringstream code;
-
-    // Add current code
-    code << this->toString() << std::endl;
-
-    // If there is more code
-    if (this->next != NULL)
-        // Conacetenate it as well
-        code << this->next->getCodeString();
-
-    // Return code
-    return code.str();
+    // Output every instruction in the chain as it goes, instead of
+    // building the (ever growing) string for the rest of the chain
+    for (Tac *i = this; i != NULL; i = i->next)
+    {
+        i->write(out);
+        out << '\n';
+    }
 }
 
-std::string *Tac::getLabel()
+Operand *Tac::getLabel()
 {
     return this->label;
 }
 
-int Tac::getCodeSize()
-{
-    int instruction_count = 1; // Total instruction count (Starts at 1 to count this instruction as well)
-
-    // Iterate every instruction while counting
-    for (Tac *i = this->next; i != NULL; i = i->next, instruction_count++)
-        ;
-
-    // return total
-    return instruction_count;
-}
-
 ILOCop Tac::getOpcode()
 {
     return this->opcode;
@@ -176,9 +137,9 @@ Tac *Tac::getPrev()
     return this->prev;
 }
 
-std::string *Tac::getArgument(int index)
+Operand *Tac::getArgument(int index)
 {
-    std::string *arg = NULL;
+    Operand *arg = NULL;
 
     switch (index)
     {
@@ -198,79 +159,113 @@ std::string *Tac::getArgument(int index)
     return arg;
 }
 
-bool Tac::startsReturn()
+bool Tac::isTailCall()
 {
-    return this->starts_return;
+    return this->opcode == ILOC_JUMPI && this->prev != NULL && this->prev->opcode == ILOC_I2I &&
+           this->prev->arg1->isBase(BASE_RFP) && this->prev->arg2->isBase(BASE_RSP);
 }
 
-std::list<std::string *> Tac::getVariables()
+std::list<Operand *> Tac::getVariables()
 {
-    std::list<std::string *> vars;
+    std::list<Operand *> vars;
 
-    if (this->arg1 != NULL && this->arg1->at(0) == 'r' && this->arg1->at(1) != 's' && this->arg1->at(1) != 'f' && this->arg1->at(1) != 'b')
+    if (this->arg1 != NULL && this->arg1->isRegister())
         vars.push_back(this->arg1);
 
-    if (this->arg2 != NULL && this->arg2->at(0) == 'r' && this->arg2->at(1) != 's' && this->arg2->at(1) != 'f' && this->arg2->at(1) != 'b')
+    if (this->arg2 != NULL && this->arg2->isRegister())
         vars.push_back(this->arg2);
 
-    if (this->arg3 != NULL && this->arg3->at(0) == 'r' && this->arg3->at(1) != 's' && this->arg3->at(1) != 'f' && this->arg3->at(1) != 'b')
+    if (this->arg3 != NULL && this->arg3->isRegister())
         vars.push_back(this->arg3);
 
     return vars;
 }
 
-void Tac::setLabel(std::string *label)
+Operand *Tac::getDefinition()
 {
-    this->label = label;
-}
+    Operand *definition = NULL;
 
-void Tac::addLiveIn(std::string *temp)
-{
-    this->live_in.push_back(temp);
-}
-
-void Tac::addLiveOut(std::string *temp)
-{
-    // Add as live out
-    this->live_out.push_back(temp);
-
-    // If next instruction is not for another function
-    if (this->next != NULL && !ASM::startsNewFunction(this->next))
+    switch (this->opcode)
     {
-        // Add as live in and live out to next
-        this->next->addLiveIn(temp);
-        this->next->addLiveOut(temp);
+    // No register written
+    case ILOC_NOP:
+    case ILOC_HALT:
+    case ILOC_JUMP:
+    case ILOC_JUMPI:
+    case ILOC_STORE:
+    case ILOC_STOREAI:
+    case ILOC_STOREAO:
+    case ILOC_CBR:
+        break;
+    // 2 operands, x => y
+    case ILOC_LOAD:
+    case ILOC_LOADI:
+    case ILOC_I2I:
+        definition = this->arg2;
+        break;
+    // 3 operands, x, y => z
+    default:
+        definition = this->arg3;
+        break;
     }
-}
 
-void Tac::removeLiveIn(std::string *temp)
-{
-    auto index = std::find(this->live_in.begin(), this->live_in.end(), temp);
+    // Special registers are not temporaries
+    if (definition != NULL && !definition->isRegister())
+        definition = NULL;
 
-    if (index != this->live_in.end())
-        this->live_in.erase(index);
+    return definition;
 }
 
-void Tac::removeLiveOut(std::string *temp)
+std::list<Operand *> Tac::getUses()
 {
-    // Remove from live-out list
-    auto index = std::find(this->live_out.begin(), this->live_out.end(), temp);
-
-    if (index != this->live_out.end())
-        this->live_out.erase(index);
+    std::list<Operand *> uses;
+    Operand *args[3] = {NULL, NULL, NULL};
 
-    // If next instruction does not start a new function
-    if (this->next != NULL && !ASM::startsNewFunction(this->next))
+    switch (this->opcode)
     {
-        // Remove from next instruction's live in and live out
-        this->next->removeLiveIn(temp);
-        this->next->removeLiveOut(temp);
+    // No register read
+    case ILOC_NOP:
+    case ILOC_HALT:
+    case ILOC_JUMPI:
+        break;
+    // 2 operands, x => y
+    case ILOC_LOAD:
+    case ILOC_LOADI:
+    case ILOC_I2I:
+        args[0] = this->arg1;
+        break;
+    // Every operand is read
+    case ILOC_JUMP:
+    case ILOC_STORE:
+    case ILOC_STOREAI:
+    case ILOC_STOREAO:
+    case ILOC_CBR:
+        args[0] = this->arg1;
+        args[1] = this->arg2;
+        args[2] = this->arg3;
+        break;
+    // Kept as it was if the condition does not hold
+    case ILOC_CMOV:
+        args[1] = this->arg2;
+        args[2] = this->arg3;
+        break;
+    // 3 operands, x, y => z
+    default:
+        args[0] = this->arg1;
+        args[1] = this->arg2;
+        break;
     }
+
+    for (int i = 0; i < 3; ++i)
+        if (args[i] != NULL && args[i]->isRegister())
+            uses.push_back(args[i]);
+
+    return uses;
 }
 
-std::vector<std::string *> Tac::getLive()
+void Tac::setLabel(Operand *label)
 {
-    return this->live_in;
+    this->label = label;
 }
 
 void Tac::addBefore(Tac *instruction)
@@ -307,38 +302,69 @@ void Tac::addAfter(Tac *instruction)
     }
 }
 
-void Tac::addLast(Tac *instruction)
+void Tac::splitBefore()
 {
-    Tac *aux = this;
+    // Unlink from the previous instruction, if there is one
+    if (this->prev != NULL)
+        this->prev->next = NULL;
 
-    if (instruction != NULL)
-    {
-        // Iterate commands until last
-        while (aux->next != NULL)
-            aux = aux->next;
+    this->prev = NULL;
+}
 
-        // At the end, insert command
-        aux->addAfter(instruction);
-    }
+void Tac::unlink()
+{
+    if (this->prev != NULL)
+        this->prev->next = this->next;
+
+    if (this->next != NULL)
+        this->next->prev = this->prev;
+
+    this->prev = NULL;
+    this->next = NULL;
 }
 
-void Tac::setReturn()
+void Tac::replace(Operand *old_operand, Operand *new_operand)
 {
-    this->starts_return = true;
+    if (this->arg1 == old_operand)
+        this->arg1 = new_operand;
+
+    if (this->arg2 == old_operand)
+        this->arg2 = new_operand;
+
+    if (this->arg3 == old_operand)
+        this->arg3 = new_operand;
+}
+
+void Tac::rewrite(ILOCop opcode_, Operand *arg1_, Operand *arg2_, Operand *arg3_)
+{
+    this->opcode = opcode_;
+    this->arg1 = arg1_;
+    this->arg2 = arg2_;
+    this->arg3 = arg3_;
 }
 
 std::string Tac::toString()
 {
-    std::stringstream code;
+    std::string code;
+    Writer out(code);
+
+    this->write(out);
 
+    // Return generated code string
+    return code;
+}
+
+void Tac::write(Writer &out)
+{
     // Add label if there is one
     if (this->label != NULL)
     {
-        code << *this->label << ": " << std::endl;
+        this->label->write(out);
+        out << ": \n";
     }
 
     // Add instruction name and a space
-    code << "\t" << opname.at(this->opcode) << " ";
+    out << '\t' << opname.at(this->opcode) << ' ';
 
     // Based on instruction code
     switch (this->opcode)
@@ -350,27 +376,35 @@ std::string Tac::toString()
     // 1 operand
     case ILOC_JUMP:
     case ILOC_JUMPI:
-        code << " => " << *this->arg1;
+        out << " => ";
+        this->arg1->write(out);
         break;
     // 2 operands
     case ILOC_LOAD:
     case ILOC_LOADI:
     case ILOC_STORE:
     case ILOC_I2I:
-        code << *this->arg1 << " => " << *this->arg2;
+        this->arg1->write(out);
+        out << " => ";
+        this->arg2->write(out);
         break;
     // 3 operands, format x => y, z
     case ILOC_STOREAI:
     case ILOC_STOREAO:
     case ILOC_CBR:
-        code << *this->arg1 << " => " << *this->arg2 << ", " << *this->arg3;
+        this->arg1->write(out);
+        out << " => ";
+        this->arg2->write(out);
+        out << ", ";
+        this->arg3->write(out);
         break;
     // 3 operands, format x, y => z
     default:
-        code << *this->arg1 << ", " << *this->arg2 << " => " << *this->arg3;
+        this->arg1->write(out);
+        out << ", ";
+        this->arg2->write(out);
+        out << " => ";
+        this->arg3->write(out);
         break;
     }
-
-    // Return generated code string
-    return code.str();
 }
@@ -0,0 +1,130 @@
+#include "TacArena.h"
+#include "Tac.h"
+
+std::list<TacArena *> TacArena::arenas;
+TacArena *TacArena::global = NULL;
+TacArena *TacArena::active = NULL;
+
+TacArena *TacArena::getGlobal()
+{
+    // Create the global arena on first use
+    if (TacArena::global == NULL)
+        TacArena::global = new TacArena();
+
+    return TacArena::global;
+}
+
+TacArena *TacArena::getActive()
+{
+    // Code is placed in the global arena unless a function is being generated
+    if (TacArena::active == NULL)
+        TacArena::active = TacArena::getGlobal();
+
+    return TacArena::active;
+}
+
+void TacArena::setActive(TacArena *arena)
+{
+    TacArena::active = arena;
+}
+
+void TacArena::releaseAll()
+{
+    for (auto i = TacArena::arenas.begin(); i != TacArena::arenas.end(); ++i)
+        delete *i;
+
+    TacArena::arenas.clear();
+
+    TacArena::global = NULL;
+    TacArena::active = NULL;
+}
+
+//
+
+TacArena::TacArena()
+{
+    this->used = 0;
+    this->register_count = 0;
+
+    // Keep track of the arena so that it is freed at the end
+    TacArena::arenas.push_back(this);
+}
+
+TacArena::~TacArena()
+{
+    this->release();
+}
+
+void *TacArena::allocate()
+{
+    // Start a new block if there is no room left in the last one
+    if (this->blocks.empty() || this->used == TAC_ARENA_BLOCK_SIZE)
+    {
+        this->blocks.push_back(static_cast<Tac *>(::operator new(TAC_ARENA_BLOCK_SIZE * sizeof(Tac))));
+        this->used = 0;
+    }
+
+    // Place instruction after the last one
+    return this->blocks.back() + this->used++;
+}
+
+Operand *TacArena::newOperand(OperandKind kind, int value)
+{
+    this->operands.push_back(Operand(kind, value));
+
+    return &this->operands.back();
+}
+
+Operand *TacArena::newRegister(int number)
+{
+    // Registers are numbered densely within the arena
+    this->operands.push_back(Operand(OPERAND_REGISTER, this->register_count, number));
+    this->register_count++;
+
+    return &this->operands.back();
+}
+
+Operand *TacArena::getImmediate(int value)
+{
+    auto i = this->immediates.find(value);
+
+    // Create the immediate on its first use
+    if (i == this->immediates.end())
+    {
+        this->operands.push_back(Operand(OPERAND_IMMEDIATE, value));
+        i = this->immediates.insert(std::make_pair(value, &this->operands.back())).first;
+    }
+
+    return i->second;
+}
+
+int TacArena::getRegisterCount()
+{
+    return this->register_count;
+}
+
+void TacArena::release()
+{
+    int count = 0; // Instructions placed in the block
+
+    for (auto i = this->blocks.begin(); i != this->blocks.end(); ++i)
+    {
+        // Every block but the last is full
+        count = (*i == this->blocks.back()) ? this->used : TAC_ARENA_BLOCK_SIZE;
+
+        // Destroy the block's instructions
+        for (int j = 0; j < count; ++j)
+            (*i)[j].~Tac();
+
+        // Free the block
+        ::operator delete(*i);
+    }
+
+    this->blocks.clear();
+    this->used = 0;
+    this->register_count = 0;
+
+    // Free the operands, with the memory used to hold them
+    std::deque<Operand>().swap(this->operands);
+    std::unordered_map<int, Operand *>().swap(this->immediates);
+}
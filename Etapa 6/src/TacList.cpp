@@ -0,0 +1,109 @@
+#include "TacList.h"
+#include "Tac.h"
+#include "Writer.h"
+
+TacList::TacList()
+{
+    this->first = NULL;
+    this->last = NULL;
+    this->size = 0;
+}
+
+TacList::TacList(Tac *instruction)
+{
+    this->first = instruction;
+    this->last = instruction;
+    this->size = instruction != NULL ? 1 : 0;
+}
+
+Tac *TacList::getFirst()
+{
+    return this->first;
+}
+
+Tac *TacList::getLast()
+{
+    return this->last;
+}
+
+int TacList::getSize()
+{
+    return this->size;
+}
+
+bool TacList::isEmpty()
+{
+    return this->first == NULL;
+}
+
+void TacList::writeCode(Writer &out)
+{
+    // Export the code if there is any
+    if (this->first != NULL)
+        this->first->writeCode(out);
+}
+
+void TacList::append(Tac *instruction)
+{
+    this->concatenate(TacList(instruction));
+}
+
+void TacList::prepend(Tac *instruction)
+{
+    if (instruction != NULL)
+    {
+        // Link before the current first instruction, if there is one
+        if (this->first != NULL)
+            this->first->addBefore(instruction);
+        else
+            this->last = instruction;
+
+        // Update sequence start
+        this->first = instruction;
+        this->size++;
+    }
+}
+
+void TacList::insertBefore(Tac *position, Tac *instruction)
+{
+    if (position == this->first)
+        this->prepend(instruction);
+    else if (instruction != NULL)
+    {
+        position->addBefore(instruction);
+        this->size++;
+    }
+}
+
+void TacList::concatenate(TacList list)
+{
+    if (!list.isEmpty())
+    {
+        // Link after the current last instruction, if there is one
+        if (this->last != NULL)
+            this->last->addAfter(list.first);
+        else
+            this->first = list.first;
+
+        // Update sequence end
+        this->last = list.last;
+        this->size += list.size;
+    }
+}
+
+void TacList::remove(Tac *instruction)
+{
+    // Update the sequence's ends, if it is one of them
+    if (this->first == this->last)
+    {
+        this->first = NULL;
+        this->last = NULL;
+    }
+    else if (instruction == this->first)
+        this->first = instruction->getNext();
+    else if (instruction == this->last)
+        this->last = instruction->getPrev();
+
+    instruction->unlink();
+    this->size--;
+}
@@ -97,3 +97,46 @@ int Token::getField()
 {
     return this->field;
 }
+
+int Token::getInteger()
+{
+    int integer = 0;
+
+    switch (this->field)
+    {
+    case 1: // Int
+        integer = this->value.integer;
+        break;
+    case 2: // Float
+        integer = (int)this->value.floating;
+        break;
+    case 3: // Char
+        integer = this->value.character;
+        break;
+    case 4: // Bool
+        integer = this->value.boolean ? 1 : 0;
+        break;
+    default: // Strings have no integer value
+        integer = 0;
+        break;
+    }
+
+    return integer;
+}
+
+float Token::getFloating()
+{
+    float floating = 0;
+
+    switch (this->field)
+    {
+    case 2: // Float
+        floating = this->value.floating;
+        break;
+    default: // Anything else has the same value as an integer
+        floating = this->getInteger();
+        break;
+    }
+
+    return floating;
+}
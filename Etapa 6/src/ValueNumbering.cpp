@@ -0,0 +1,238 @@
+#include "ValueNumbering.h"
+#include "Tac.h"
+#include "ASM.h"
+
+ValueNumbering::ValueNumbering(TacList &code_)
+{
+    this->code = &code_;
+    this->removed = 0;
+    this->next_number = 0;
+
+    // Values are only known within their block
+    CFG cfg(code_);
+
+    for (int block = 0; block < cfg.getBlockCount(); ++block)
+    {
+        this->forget();
+        this->numberBlock(cfg.getBlock(block));
+    }
+}
+
+ValueNumbering::~ValueNumbering()
+{
+    // nil
+}
+
+int ValueNumbering::getRemovedCount()
+{
+    return this->removed;
+}
+
+int ValueNumbering::getNumber(Operand *operand)
+{
+    auto number = this->numbers.find(operand);
+
+    // Not written in the block yet, holds some value of its own
+    if (number == this->numbers.end())
+    {
+        this->setNumber(operand, this->next_number++);
+        return this->next_number - 1;
+    }
+
+    return number->second;
+}
+
+void ValueNumbering::setNumber(Operand *operand, int number)
+{
+    // A new value for a special register may change every address based on it
+    if (operand->getKind() == OPERAND_BASE && this->numbers.count(operand))
+        this->killMemory(-1);
+
+    this->numbers[operand] = number;
+
+    // Keep the oldest register holding the value, as long as it does
+    if (operand->isRegister() && this->getHolder(number) == NULL)
+        this->holders[number] = operand;
+}
+
+Operand *ValueNumbering::getHolder(int number)
+{
+    auto holder = this->holders.find(number);
+
+    if (holder == this->holders.end() || this->numbers[holder->second] != number)
+        return NULL;
+
+    return holder->second;
+}
+
+void ValueNumbering::killMemory(int address)
+{
+    auto location = this->locations.find(address);
+
+    for (auto i = this->memory.begin(); i != this->memory.end();)
+    {
+        auto other = this->locations.find(i->first);
+        bool alias = false;
+
+        if (address < 0 || i->first == address || other == this->locations.end())
+            alias = true; // Everything, the same address, or an address that may be anywhere
+        else if (location == this->locations.end())
+            alias = !other->second->isBase(BASE_RFP); // Vector positions may be any global, not a local
+
+        if (alias)
+            i = this->memory.erase(i);
+        else
+            ++i;
+    }
+}
+
+void ValueNumbering::forget()
+{
+    this->numbers.clear();
+    this->expressions.clear();
+    this->holders.clear();
+    this->memory.clear();
+    this->locations.clear();
+}
+
+void ValueNumbering::numberBlock(BasicBlock *block)
+{
+    Tac *end = block->getLast()->getNext();
+    Tac *next = NULL;
+    int count = 0;
+
+    for (Tac *i = block->getFirst(); i != end; i = next)
+    {
+        // Start over once in a while, so that values are not kept for too long
+        if (++count % VALUE_NUMBERING_WINDOW == 0)
+            this->forget();
+
+        Operand *arg1 = i->getArgument(0);
+        Operand *arg2 = i->getArgument(1);
+        Operand *arg3 = i->getArgument(2);
+
+        next = i->getNext();
+
+        switch (i->getOpcode())
+        {
+        case ILOC_ADD: // Expressions (Operands in any order for the commutative ones)
+        case ILOC_MULT:
+        case ILOC_AND:
+        case ILOC_OR:
+        case ILOC_XOR:
+        case ILOC_SUB:
+        case ILOC_DIV:
+        case ILOC_ADDI:
+        case ILOC_SUBI:
+        case ILOC_RSUBI:
+        case ILOC_MULTI:
+        case ILOC_DIVI:
+        case ILOC_RDIVI:
+        case ILOC_LSHIFT:
+        case ILOC_LSHIFTI:
+        case ILOC_RSHIFT:
+        case ILOC_RSHIFTI:
+        case ILOC_ANDI:
+        case ILOC_ORI:
+        case ILOC_XORI:
+        {
+            int number_1 = this->getNumber(arg1);
+            int number_2 = this->getNumber(arg2);
+            ILOCop opcode = i->getOpcode();
+
+            // The same pair in any order
+            if ((opcode == ILOC_ADD || opcode == ILOC_MULT || opcode == ILOC_AND || opcode == ILOC_OR || opcode == ILOC_XOR) &&
+                number_1 > number_2)
+                std::swap(number_1, number_2);
+
+            auto key = std::make_tuple(opcode, number_1, number_2);
+            auto expression = this->expressions.find(key);
+            Operand *holder = expression != this->expressions.end() ? this->getHolder(expression->second) : NULL;
+
+            // Variable addresses belong to the load or store after them
+            bool glued = next != end && ASM::isGlued(next);
+
+            if (holder != NULL && holder != arg3 && !glued)
+            {
+                // Already computed, copy it
+                i->rewrite(ILOC_I2I, holder, arg3);
+                this->setNumber(arg3, expression->second);
+                this->removed++;
+            }
+            else
+            {
+                int number = expression != this->expressions.end() ? expression->second : this->next_number++;
+
+                this->expressions[key] = number;
+
+                // Never actually in a register, the ASM code uses the address right away
+                if (glued)
+                    this->numbers[arg3] = number;
+                else
+                    this->setNumber(arg3, number);
+
+                // Keep track of variable addresses, to know which loads a store changes
+                if (opcode == ILOC_ADDI && (arg1->isBase(BASE_RFP) || arg1->isBase(BASE_RBSS)))
+                    this->locations[number] = arg1;
+            }
+        }
+        break;
+        case ILOC_LOAD: // load r1 => r2
+        {
+            int address = this->getNumber(arg1);
+            auto loaded = this->memory.find(address);
+            Operand *holder = loaded != this->memory.end() ? this->getHolder(loaded->second) : NULL;
+            Tac *prev = i->getPrev();
+
+            // The address calculated only for this load (Which overwrites it) goes away with it
+            bool glued = ASM::isGlued(i);
+            bool removable = glued && arg1 == arg2 && prev->getLabel() == NULL;
+
+            if (holder != NULL && (removable || !glued))
+            {
+                // Already loaded (Or stored), copy it
+                i->rewrite(ILOC_I2I, holder, arg2);
+                this->removed++;
+
+                if (removable)
+                {
+                    this->code->remove(prev);
+                    this->removed++;
+                }
+
+                this->setNumber(arg2, loaded->second);
+            }
+            else
+            {
+                int number = this->next_number++;
+
+                this->memory[address] = number;
+                this->setNumber(arg2, number);
+            }
+        }
+        break;
+        case ILOC_STORE: // store r1 => r2
+        {
+            int address = this->getNumber(arg2);
+
+            // What the address held is gone, it holds the stored value now
+            this->killMemory(address);
+            this->memory[address] = this->getNumber(arg1);
+        }
+        break;
+        case ILOC_LOADI: // Copies, of a register or a constant
+        case ILOC_I2I:
+            this->setNumber(arg2, this->getNumber(arg1));
+            break;
+        case ILOC_STOREAI: // Memory written somewhere else (The calling sequence) or by a call
+        case ILOC_STOREAO:
+        case ILOC_JUMPI:
+            this->killMemory(-1);
+            break;
+        default: // Comparisons and other loads are new values
+            if (i->getDefinition() != NULL)
+                this->setNumber(i->getDefinition(), this->next_number++);
+            break;
+        }
+    }
+}
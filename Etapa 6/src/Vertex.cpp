@@ -1,10 +1,11 @@
 #include "Vertex.h"
 
-Vertex::Vertex(std::string *name, unsigned int vertex_id, unsigned int color_id)
+Vertex::Vertex(Operand *reg, unsigned int vertex_id, unsigned int color_id, double spill_cost)
 {
-    this->name = name;
+    this->reg = reg;
     this->id = vertex_id;
     this->color = color_id;
+    this->cost = spill_cost;
 }
 
 Vertex::~Vertex()
@@ -12,14 +13,14 @@ Vertex::~Vertex()
     // nil
 }
 
-std::vector<unsigned int> Vertex::getAdjacent()
+std::vector<unsigned int> &Vertex::getAdjacent()
 {
     return this->adjacency_list;
 }
 
-std::string *Vertex::getName()
+Operand *Vertex::getRegister()
 {
-    return this->name;
+    return this->reg;
 }
 
 void Vertex::setAdjacent(unsigned int vertex_id)
@@ -37,23 +38,22 @@ void Vertex::setColor(unsigned int color_id)
     this->color = color_id;
 }
 
-unsigned int Vertex::getColor()
+void Vertex::setCost(double spill_cost)
 {
-    return this->color;
+    this->cost = spill_cost;
 }
 
-unsigned int Vertex::getId()
+double Vertex::getCost()
 {
-    return this->id;
+    return this->cost;
 }
 
-bool Vertex::isAdjacentTo(unsigned int vertex_id)
+unsigned int Vertex::getColor()
 {
-    bool is_adjancent = false;
-
-    for (unsigned int i = 0; !is_adjancent && i < this->adjacency_list.size(); ++i)
-        if (this->adjacency_list[i] == vertex_id)
-            is_adjancent = true;
+    return this->color;
+}
 
-    return is_adjancent;
+unsigned int Vertex::getId()
+{
+    return this->id;
 }
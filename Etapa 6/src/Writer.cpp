@@ -0,0 +1,141 @@
+#include "Writer.h"
+
+Writer::Writer(int fd_, size_t capacity_)
+{
+    this->fd = fd_;
+    this->target = NULL;
+    this->capacity = capacity_ > 0 ? capacity_ : 1;
+    this->buffer = new char[this->capacity];
+    this->used = 0;
+    this->total = 0;
+}
+
+Writer::Writer(std::string &target_)
+{
+    this->fd = -1;
+    this->target = &target_;
+    this->buffer = NULL;
+    this->capacity = 0;
+    this->used = 0;
+    this->total = 0;
+}
+
+Writer::~Writer()
+{
+    this->flush();
+
+    delete[] this->buffer;
+}
+
+size_t Writer::getTotal()
+{
+    return this->total;
+}
+
+void Writer::write(const char *data, size_t length)
+{
+    this->total += length;
+
+    // Strings grow on their own
+    if (this->target != NULL)
+    {
+        this->target->append(data, length);
+        return;
+    }
+
+    // Make room, if needed
+    if (this->used + length > this->capacity)
+        this->flush();
+
+    // Bigger than the whole buffer, write it right away
+    if (length > this->capacity)
+    {
+        this->writeFile(data, length);
+        return;
+    }
+
+    memcpy(this->buffer + this->used, data, length);
+    this->used += length;
+}
+
+void Writer::flush()
+{
+    if (this->target == NULL)
+        this->writeFile(this->buffer, this->used);
+
+    this->used = 0;
+}
+
+void Writer::writeFile(const char *data, size_t length)
+{
+    size_t written = 0;
+
+    while (written < length)
+    {
+        ssize_t result = ::write(this->fd, data + written, length - written);
+
+        // Interrupted, try again
+        if (result < 0 && errno == EINTR)
+            continue;
+
+        // Nowhere to write it (Such as a closed pipe), drop the output
+        if (result <= 0)
+            break;
+
+        written += result;
+    }
+}
+
+Writer &Writer::operator<<(const std::string &text)
+{
+    this->write(text.data(), text.size());
+
+    return *this;
+}
+
+Writer &Writer::operator<<(const char *text)
+{
+    this->write(text, strlen(text));
+
+    return *this;
+}
+
+Writer &Writer::operator<<(char character)
+{
+    // Most output is short pieces, skip the general case
+    if (this->target == NULL && this->used < this->capacity)
+    {
+        this->buffer[this->used++] = character;
+        this->total++;
+    }
+    else
+        this->write(&character, 1);
+
+    return *this;
+}
+
+Writer &Writer::operator<<(long long number)
+{
+    char digits[24];
+    int start = sizeof(digits);
+    unsigned long long value = number < 0 ? 0ULL - (unsigned long long)number : number;
+
+    // Digits from the last one
+    do
+    {
+        digits[--start] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+
+    if (number < 0)
+        digits[--start] = '-';
+
+    this->write(digits + start, sizeof(digits) - start);
+
+    return *this;
+}
+
+Writer &Writer::operator<<(int number)
+{
+    return *this << (long long)number;
+}
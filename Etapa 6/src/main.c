@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <string.h>
 
 // Parser functions
 extern int yyparse(void);
@@ -9,10 +10,58 @@ void *arvore = NULL;
 void exporta(void *arvore);
 void libera(void *arvore);
 void export_code(void *arvore);
+void export_cfg(void *arvore);
 void generate_ASM(void *arvore);
+void enable_regalloc_stats();
+void enable_linear_scan();
+void enable_peephole_stats();
+void disable_tac_comments();
+void force_frame_pointer();
+void enable_optimizer_stats();
+void set_inline_threshold(int threshold);
+void set_cmov_threshold(int threshold);
 
 int main(int argc, char **argv)
 {
+    // Whether the ILOC code should be output instead of the x86_64 assembly
+    int output_iloc = 0;
+
+    // Whether each function's control flow graph should be output instead
+    int output_cfg = 0;
+
+    // Read command line options
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!strcmp(argv[i], "--iloc"))
+            output_iloc = 1;
+        else if (!strcmp(argv[i], "--cfg"))
+            output_cfg = 1;
+        else if (!strcmp(argv[i], "--regalloc-stats"))
+            // Report each function's register allocation to stderr
+            enable_regalloc_stats();
+        else if (!strcmp(argv[i], "--linear-scan"))
+            // Allocate registers by linear scan, faster for very large functions
+            enable_linear_scan();
+        else if (!strcmp(argv[i], "--peephole-stats"))
+            // Report the rewrites of the peephole optimizer in each function to stderr
+            enable_peephole_stats();
+        else if (!strcmp(argv[i], "--no-tac-comments"))
+            // Leave out the TAC each group of instructions came from, for smaller output
+            disable_tac_comments();
+        else if (!strcmp(argv[i], "--force-frame-pointer"))
+            // Set up %rbp in every function, leaf functions included, for profilers and debuggers
+            force_frame_pointer();
+        else if (!strcmp(argv[i], "--opt-stats"))
+            // Report what each TAC optimization did in each function to stderr
+            enable_optimizer_stats();
+        else if (!strcmp(argv[i], "--inline-threshold") && i + 1 < argc)
+            // Inline the calls to functions of up to this many instructions (0 disables inlining)
+            set_inline_threshold(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--cmov-threshold") && i + 1 < argc)
+            // Select the value of conditionals whose two sides take up to this many instructions in all, instead of branching (0 disables it)
+            set_cmov_threshold(atoi(argv[++i]));
+    }
+
     // Parse input file
     int ret = yyparse();
 
@@ -22,11 +71,15 @@ int main(int argc, char **argv)
         // Export the AST
         // exporta(arvore);
 
-        // Export the ILOC code
-        // export_code(arvore);
-
-        // Convert from intermediate ILOC code to x86_64 assembly
-        generate_ASM(arvore);
+        if (output_cfg)
+            // Export the control flow graphs
+            export_cfg(arvore);
+        else if (output_iloc)
+            // Export the ILOC code
+            export_code(arvore);
+        else
+            // Convert from intermediate ILOC code to x86_64 assembly
+            generate_ASM(arvore);
 
         // Free the AST memory
         libera(arvore);
@@ -17,6 +17,10 @@
     // Data structures manager
     Manager mngr;
 
+    // Command lists are right recursive, so the parser stack grows with the
+    // amount of commands in a block. Allow it to grow for very large inputs
+    #define YYMAXDEPTH 10000000
+
 %}
 
 // Union for token lexical value
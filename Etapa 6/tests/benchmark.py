@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""
+Compile-time scaling benchmark for the compiler.
+
+Generates programs with a growing amount of statements and measures how long
+the compiler takes to produce their ILOC code, and its peak memory usage. With
+linear-time code assembly the time per statement should stay (roughly) constant
+as the size doubles.
+
+It then generates functions with a growing amount of temporaries that are live at
+the same time and reports the size of their register interference graph and the
+time spent building and coloring it (See --regalloc-stats), and the same for the
+live intervals of the linear scan allocator (See --linear-scan).
+
+Finally it measures the output throughput: how many MB of x86_64 assembly the
+compiler writes per second, with and without the TAC comments before each
+instruction (See --no-tac-comments).
+
+Usage: python3 tests/benchmark.py [--compiler ./etapa6] [--sizes 12500,25000,...]
+                                  [--temps 1250,2500,5000,...] [--output 50000,...]
+"""
+import argparse
+import os
+import re
+import subprocess
+import tempfile
+import time
+
+
+def straight_line(n):
+    """A single function with n attributions in one block"""
+    lines = ['int main()', '{', '    int x <= 0;']
+    lines += ['    x = x + %d;' % (i % 100) for i in range(n)]
+    lines += ['    return x;', '}']
+    return '\n'.join(lines) + '\n'
+
+
+def nested_blocks(n):
+    """n attributions, nested ten if-statements deep in groups"""
+    lines = ['int main()', '{', '    int x <= 0;']
+    depth = 10
+    for i in range(0, n, depth):
+        lines += ['    if (x < %d) {' % (i % 1000)] * 1
+        lines += ['    x = x * 2 - (x + %d);' % j for j in range(depth - 1)]
+        lines += ['    };']
+    lines += ['    return x;', '}']
+    return '\n'.join(lines) + '\n'
+
+
+def deep_expressions(n):
+    """About n temporaries, in right-deep sums that keep fifty of them live at once"""
+    depth = 50
+    expression = 'x'
+    for _ in range(depth):
+        expression = 'x + (%s)' % expression
+    lines = ['int main()', '{', '    int x <= 1;']
+    lines += ['    x = %s;' % expression] * max(1, n // (2 * depth + 2))
+    lines += ['    return x;', '}']
+    return '\n'.join(lines) + '\n'
+
+
+def measure_regalloc(compiler, flags, source):
+    """Returns the register allocation statistics the compiler reports for main"""
+    result = subprocess.run([compiler, '--regalloc-stats'] + flags, input=source.encode(),
+                            stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+    if result.returncode != 0:
+        raise RuntimeError('compiler failed with status %d' % result.returncode)
+    match = re.search(r'regalloc main: temps (\d+), (?:interferences|intervals) (\d+), '
+                      r'build ([\d.]+) ms, color ([\d.]+) ms', result.stderr.decode())
+    return int(match.group(1)), int(match.group(2)), float(match.group(3)), float(match.group(4))
+
+
+def measure_output(compiler, flags, source):
+    """Returns elapsed seconds and size (MB) of the assembly written by a compilation"""
+    with tempfile.TemporaryFile() as output:
+        start = time.perf_counter()
+        result = subprocess.run([compiler] + flags, input=source.encode(),
+                                stdout=output, stderr=subprocess.DEVNULL)
+        elapsed = time.perf_counter() - start
+        if result.returncode != 0:
+            raise RuntimeError('compiler failed with status %d' % result.returncode)
+        return elapsed, output.tell() / (1024.0 * 1024.0)
+
+
+def measure(compiler, flags, source):
+    """Returns elapsed seconds and peak resident memory (MB) of a compilation"""
+    start = time.perf_counter()
+    process = subprocess.Popen([compiler] + flags, stdin=subprocess.PIPE,
+                               stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    process.stdin.write(source.encode())
+    process.stdin.close()
+    _, status, usage = os.wait4(process.pid, 0)
+    elapsed = time.perf_counter() - start
+    if status != 0:
+        raise RuntimeError('compiler failed with status %d' % status)
+    return elapsed, usage.ru_maxrss / 1024.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compiler scaling benchmark')
+    parser.add_argument('--compiler', default='./etapa6')
+    parser.add_argument('--flags', default='--iloc')
+    parser.add_argument('--sizes', default='12500,25000,50000,100000,200000')
+    parser.add_argument('--temps', default='1250,2500,5000,10000')
+    parser.add_argument('--output', default='25000,50000,100000')
+    args = parser.parse_args()
+
+    sizes = [int(x) for x in args.sizes.split(',')]
+    flags = args.flags.split()
+
+    for name, generator in (('straight-line', straight_line), ('nested', nested_blocks)):
+        print('%s:' % name)
+        print('%10s %10s %14s %10s' % ('statements', 'seconds', 'us/statement', 'peak MB'))
+        for n in sizes:
+            elapsed, peak = measure(args.compiler, flags, generator(n))
+            print('%10d %10.3f %14.2f %10.1f' % (n, elapsed, elapsed / n * 1e6, peak))
+        print()
+
+    for name, allocator, size in (('graph coloring', [], 'interferences'),
+                                  ('linear scan', ['--linear-scan'], 'intervals')):
+        print('register allocation (%s):' % name)
+        print('%10s %14s %10s %10s' % ('temps', size, 'build ms', 'color ms'))
+        for n in [int(x) for x in args.temps.split(',')]:
+            temps, edges, build, color = measure_regalloc(args.compiler, allocator, deep_expressions(n))
+            print('%10d %14d %10.2f %10.2f' % (temps, edges, build, color))
+        print()
+
+    for name, output_flags in (('with TAC comments', []), ('without TAC comments', ['--no-tac-comments'])):
+        print('assembly output (%s):' % name)
+        print('%10s %10s %10s %10s' % ('statements', 'seconds', 'MB', 'MB/s'))
+        for n in [int(x) for x in args.output.split(',')]:
+            elapsed, size = measure_output(args.compiler, output_flags, straight_line(n))
+            print('%10d %10.3f %10.1f %10.1f' % (n, elapsed, size, size / elapsed))
+        print()
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,11 @@
+// A function whose body starts at a label, right after the prologue (Returns 5)
+int x;
+
+int main()
+{
+    while (x < 5) do
+    {
+        x = x + 1;
+    };
+    return x;
+}
@@ -0,0 +1,39 @@
+// Arguments passed in registers and in the stack, values kept across calls and calls in arguments (Returns 30)
+int g;
+
+int weigh(int a, int b, int c, int d, int e, int f, int h, int k)
+{
+    return a + 2 * b + 3 * c + 4 * d + 5 * e + 6 * f + 7 * h + 8 * k;
+}
+
+int pick(int a, int b)
+{
+    if (a > b)
+    {
+        return a - b;
+    };
+    return b - a;
+}
+
+int count(int n)
+{
+    int r;
+    if (n == 0)
+    {
+        return 0;
+    };
+    r = count(n - 1);
+    return r + n;
+}
+
+int main()
+{
+    int x, y, s;
+    x = 3;
+    y = 4;
+    g = 1;
+    s = x * y + weigh(1, 2, 3, 4, 5, 6, 7, 8) + x;
+    s = s + pick(weigh(x, y, 0, 0, 0, 0, 0, 1), pick(y, x * 5)) + y;
+    s = s + count(10);
+    return s;
+}
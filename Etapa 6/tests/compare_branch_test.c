@@ -0,0 +1,32 @@
+// Comparisons as branch conditions and as values (Returns 73)
+int g;
+int less(int a, int b)
+{
+    return a < b;
+}
+int count(int n, int k)
+{
+    int i <= 0;
+    int c <= 0;
+    while (i < n) do
+    {
+        if (k != 3)
+        {
+            c = c + (i >= 2) + 2 * (i == k);
+        };
+        i = i + 1;
+    };
+    return c;
+}
+int main()
+{
+    int a <= 3;
+    int b <= 5;
+    int c <= 0;
+    int d <= 0;
+    c = a < b;
+    d = (a > b) + (a <= b) * 4 + less(b, a) + less(a, b) * 8;
+    g = a == 3 ? b != 5 : a >= 3;
+    c = c + d + g + count(10, 4) + (less(a, b) == (b > a)) * 50;
+    return c;
+}
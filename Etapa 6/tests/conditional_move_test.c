@@ -0,0 +1,36 @@
+// Conditionals whose value is selected without branching (Returns 198)
+int g;
+int smaller(int a, int b)
+{
+    return a < b ? a : b;
+}
+int clamp(int x, int low, int high)
+{
+    int y <= 0;
+    y = x < low ? low : x;
+    y = y > high ? high : y;
+    return y;
+}
+int main()
+{
+    int i <= 0;
+    int a <= 0;
+    int s <= 0;
+    int b <= 0;
+    int c <= 0;
+    g = 4;
+    while (i < 12) do
+    {
+        a = i * 7 - 30;
+        s = s + (a < 0 ? 0 - a : a);
+        c = i >= 3 && i < 9;
+        s = s + c;
+        c = i == 2 || i > 10;
+        s = s + 2 * c;
+        b = i > 5 ? (g + i) : (i * 3 - 1);
+        s = s + b - clamp(a, 0 - 5, 20);
+        s = s + (i != 0 ? 60 / i : 1);
+        i = i + 1;
+    };
+    return smaller(s, 300) - smaller(s, 100) + smaller(s, 0 - 2);
+}
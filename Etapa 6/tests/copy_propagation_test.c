@@ -0,0 +1,30 @@
+// Copies of variables and constants that copy propagation reads through, across branches and loops (Returns 52)
+int main()
+{
+    int a <= 4;
+    int b;
+    int c;
+    int i <= 0;
+
+    // b and c are only copies of a, so the loop reads a
+    b = a;
+    c = b;
+
+    if (a > 2)
+    {
+        b = c * 3;
+    }
+    else
+    {
+        b = c;
+    };
+
+    // b is 12 on either path that runs, and a is still 4
+    while (i < a) do
+    {
+        c = c + b;
+        i = i + 1;
+    };
+
+    return c;
+}
@@ -0,0 +1,32 @@
+// Unreachable code and stores to variables never read that dead code elimination removes (Returns 23)
+int main()
+{
+    int a <= 3;
+    int b <= 5;
+    int c <= 9;
+    int d;
+
+    // Overwritten before being read, both stores go away
+    c = 4;
+    c = a + b;
+
+    // Never read at all
+    d = c * 100;
+    d = d - a;
+
+    if (a > b)
+    {
+        c = c + 1;
+    }
+    else
+    {
+        c = c + b * 2;
+    };
+
+    c = c + a + b - a;
+    return c;
+
+    // Never runs
+    c = 0;
+    return c;
+}
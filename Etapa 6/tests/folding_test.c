@@ -0,0 +1,38 @@
+// Constant expressions, identities and constant conditions (Returns 145)
+int main()
+{
+    int x <= 3;
+    int y <= 0;
+    int a <= 0;
+    int b <= 0;
+
+    // Folded
+    y = 2 * 3 + x;
+    y = y + x * 1 + 2 ^ 4;
+
+    // Simplified
+    y = y + (x + 0) - (0 + x) + (x - 0) * 1;
+    y = y + x * 0 + 0 * x + 7 / 2 - 7 % 3;
+
+    // Pruned
+    if (true) {
+        y = y + 100;
+    };
+    while (false) do {
+        y = 9999;
+    };
+
+    y = y - -(4) + +x;
+
+    // Logic operations with a constant still yield 0 or 1
+    a = x && true;
+    b = false || x;
+    y = y + a + b;
+    a = true && x;
+    b = x || false;
+    y = y + a + b;
+    a = 5 || x;
+    y = y + a;
+
+    return y;
+}
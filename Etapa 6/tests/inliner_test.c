@@ -0,0 +1,50 @@
+// Small functions whose calls are replaced with their code, early returns and calls in arguments included (Returns 98)
+int g;
+
+int square(int x)
+{
+    int y;
+    y = x * x;
+    return y;
+}
+
+int max(int a, int b)
+{
+    int r;
+    if (a > b)
+    {
+        r = a;
+        return r;
+    };
+    r = b;
+    return r;
+}
+
+int next()
+{
+    g = g + 1;
+    return g;
+}
+
+int clamp(int x)
+{
+    int r;
+    r = max(x, 0) - max(x - 9, 0);
+    return r;
+}
+
+int main()
+{
+    int s, i;
+    s = 0;
+    g = 3;
+
+    for (i = 0 : i < 5 : i = i + 1)
+    {
+        s = s + square(i) + max(i, 2) + next();
+    };
+
+    s = s + max(square(3), next()) + clamp(12) + clamp(0 - 4) + clamp(7);
+
+    return s;
+}
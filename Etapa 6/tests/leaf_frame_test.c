@@ -0,0 +1,35 @@
+// Functions that call none keep their variables in the red zone, without a frame, unless they do not fit in it (Returns 124)
+int g;
+
+int triangle(int n)
+{
+    int s, i;
+    s = 0;
+    for (i = 1 : i <= n : i = i + 1)
+    {
+        s = s + i;
+    };
+    return s;
+}
+
+int wide()
+{
+    int a0, a1, a2, a3, a4, a5, a6, a7, a8, a9;
+    int b0, b1, b2, b3, b4, b5, b6, b7, b8, b9;
+    int c0, c1, c2, c3, c4, c5, c6, c7, c8, c9;
+    a0 = g; a1 = a0 + 1; a2 = a1 + 1; a3 = a2 + 1; a4 = a3 + 1;
+    a5 = a4 + 1; a6 = a5 + 1; a7 = a6 + 1; a8 = a7 + 1; a9 = a8 + 1;
+    b0 = a9 - 9; b1 = b0; b2 = b1; b3 = b2; b4 = b3;
+    b5 = b4; b6 = b5; b7 = b6; b8 = b7; b9 = b8;
+    c0 = b9; c1 = c0; c2 = c1; c3 = c2; c4 = c3;
+    c5 = c4; c6 = c5; c7 = c6; c8 = c7; c9 = c8 + a9;
+    return c9;
+}
+
+int main()
+{
+    int s;
+    g = 5;
+    s = triangle(14) + wide();
+    return s;
+}
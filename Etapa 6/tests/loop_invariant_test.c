@@ -0,0 +1,43 @@
+// Vector starts, loads of variables and arithmetic on them that nested loops hoist (Returns 67)
+int g;
+int v[10];
+int main()
+{
+    int i <= 0;
+    int k <= 2;
+    int s <= 0;
+    int j;
+    g = 5;
+
+    // t is written in the loop, k is not, and v's start never changes
+    while (i < 10) do
+    {
+        int t <= 7;
+        s = s + t * k;
+        t = t + i;
+        s = s + t;
+        v[i] = g * 3 + k;
+        g = g + 1;
+        i = i + 1;
+    };
+
+    // k * 5 leaves the inner loop, and g leaves both
+    for (i = 0 : i < 10 : i = i + 1)
+    {
+        for (j = 0 : j < 3 : j = j + 1)
+        {
+            s = s + v[i] + k * 5 + g;
+            v[j] = v[j] + 1;
+        };
+        k << 1;
+    };
+
+    i = 0;
+    while (i < 4) do
+    {
+        s = s + k ^ i;
+        i = i + 1;
+    };
+
+    return s;
+}
@@ -0,0 +1,22 @@
+// Products, quotients and branches the peephole optimizer rewrites (Returns 66)
+int main()
+{
+    int a <= 7;
+    int b <= 3;
+    int c <= 0;
+
+    // Computed in place of %rax
+    c = a * b + (a - b) * (a + b) + a / b;
+
+    // Conditional jumps over a jmp, and jumps to the next instruction
+    if (c > 60)
+    {
+        c = c + b;
+    }
+    else
+    {
+        c = 0;
+    };
+
+    return c;
+}
@@ -0,0 +1,22 @@
+// Multiplications, divisions and modulos by constants that become shifts or multiplications by a reciprocal (Returns 214)
+int main()
+{
+    int i <= 0;
+    int r <= 0;
+    int x;
+
+    // x goes from -37 to 35, so both signs are rounded towards zero
+    while (i < 10) do
+    {
+        x = i * 8 - 37;
+        r = r + x / 4 + x / 7 + x % 5;
+        i = i + 1;
+    };
+
+    // Negative, so shifting it would need to round
+    r = r * (0 - 1);
+    r = r + i ^ 2;
+    r << 1;
+
+    return r;
+}
@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+"""
+Stack usage stress test for the compiler.
+
+Compiles a single function with a very large amount of statements while the
+stack is limited to a fixed size. Every traversal over command lists and
+instruction chains must be iterative for this to pass, since the recursion
+depth would otherwise grow with the size of the program.
+
+Usage: python3 tests/stress.py [--compiler ./etapa6] [--statements 1000000] [--stack-kb 8192]
+"""
+import argparse
+import resource
+import subprocess
+import sys
+import time
+
+
+def long_function(n):
+    """A single function with n attributions in one block"""
+    lines = ['int main()', '{', '    int x <= 0;']
+    lines += ['    x = x + %d;' % (i % 100) for i in range(n)]
+    lines += ['    return x;', '}']
+    return '\n'.join(lines) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compiler stack usage stress test')
+    parser.add_argument('--compiler', default='./etapa6')
+    parser.add_argument('--flags', default='--iloc')
+    parser.add_argument('--statements', type=int, default=1000000)
+    parser.add_argument('--stack-kb', type=int, default=8192)
+    args = parser.parse_args()
+
+    limit = args.stack_kb * 1024
+
+    def limit_stack():
+        resource.setrlimit(resource.RLIMIT_STACK, (limit, limit))
+
+    source = long_function(args.statements)
+
+    start = time.perf_counter()
+    result = subprocess.run([args.compiler] + args.flags.split(), input=source.encode(),
+                            stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                            preexec_fn=limit_stack)
+    elapsed = time.perf_counter() - start
+
+    if result.returncode != 0 or not result.stdout:
+        print('FAILED: %d statements with a %d KB stack (exit code %d)'
+              % (args.statements, args.stack_kb, result.returncode))
+        sys.stderr.write(result.stderr.decode())
+        return 1
+
+    print('OK: %d statements with a %d KB stack in %.2f seconds'
+          % (args.statements, args.stack_kb, elapsed))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,35 @@
+// Calls in tail position, to the function itself and to others, which become jumps (Returns 131)
+int sum(int n, int acc)
+{
+    if (n == 0)
+    {
+        return acc;
+    };
+    return sum(n - 1, acc + n);
+}
+
+int gcd(int a, int b)
+{
+    if (b == 0)
+    {
+        return a;
+    };
+    return gcd(b, a - (a / b) * b);
+}
+
+int twice(int x, int y)
+{
+    return x * 2 + y;
+}
+
+int next(int x, int y)
+{
+    return twice(x + 1, y);
+}
+
+int main()
+{
+    int s;
+    s = sum(10, 0) + gcd(84, 36) + next(31, 0) + sum(0, 0);
+    return s;
+}
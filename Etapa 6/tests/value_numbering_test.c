@@ -0,0 +1,21 @@
+// Repeated expressions and loads value numbering removes (Returns 74)
+int main()
+{
+    int a <= 6;
+    int b <= 4;
+    int c <= 0;
+    int d <= 0;
+
+    // The same product, with its operands in any order
+    c = a * b + b * a;
+
+    // Values stored are taken from their register instead of loaded back
+    c = c - a;
+    d = c + a * b;
+
+    // Until the variable is written again
+    a = 2;
+    d = d + a * b;
+
+    return d;
+}